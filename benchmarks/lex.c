@@ -0,0 +1,135 @@
+// Needed for clock_gettime.
+#define _POSIX_C_SOURCE 199309L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "cece/cece.h"
+
+// Number of times the source is lexed, the fastest run is reported.
+constexpr size_t ccRunCount = 10;
+
+// Number of copies of the sample in the generated source.
+constexpr size_t ccSampleCount = 1 << 16;
+
+// Code mixing every kind of token, repeated to generate a source when no file is given.
+static const char sample[] =
+	"static unsigned long ccSum(const int* const values, const size_t count)\n"
+	"{\n"
+	"\tunsigned long sum = 0x0ul;\n"
+	"\tfor(size_t index = 0; index < count && values[index] != 'x'; ++index)\n"
+	"\t{\n"
+	"\t\tsum += (values[index] << 2) >>= 1 | 0b101 ^ 0777;\n"
+	"\t\tpValue->field -= sum % 10 ? \"string \\\"literal\\\"\" : 42;\n"
+	"\t}\n"
+	"\treturn sum;\n"
+	"}\n";
+
+/*
+ * Get the monotonic time, which unlike the calendar time is not adjusted while the benchmark runs.
+ *
+ * Returns:
+ * The time in seconds, from an arbitrary origin.
+ */
+static double ccNow(void)
+{
+	struct timespec time = {};
+	clock_gettime(CLOCK_MONOTONIC, &time);
+
+	return (double)time.tv_sec + (double)time.tv_nsec / 1e9;
+}
+
+int main(int argumentCount, char** arguments)
+{
+	int status = EXIT_FAILURE;
+
+	// Lex with ccLexParallel when given a thread count.
+	size_t threadCount = 1;
+	if(argumentCount > 1 && strncmp(arguments[1], "-j", 2) == 0)
+	{
+		char* end;
+		threadCount = strtoul(arguments[1] + 2, &end, 10);
+		if(*end != '\0' || threadCount == 0)
+		{
+			fputs("Invalid thread count.\n", stderr);
+			return EXIT_FAILURE;
+		}
+
+		--argumentCount;
+		++arguments;
+	}
+
+	if(argumentCount > 2)
+	{
+		fputs("Usage: cece_benchmark_lex [-j<threads>] [file]\n", stderr);
+		return EXIT_FAILURE;
+	}
+
+	CcString source = {};
+	if(argumentCount == 2)
+	{
+		if(ccReadFile(arguments[1], &source) != CC_SUCCESS)
+		{
+			fprintf(stderr, "Failed to read %s.\n", arguments[1]);
+			return EXIT_FAILURE;
+		}
+	}
+	else
+	{
+		constexpr size_t sampleLength = sizeof(sample) - 1;
+
+		source.length = sampleLength * ccSampleCount;
+		source.string = ccMalloc(source.length + 1);
+		if(!source.string)
+		{
+			fputs("Failed to allocate memory.\n", stderr);
+			return EXIT_FAILURE;
+		}
+
+		for(size_t sampleIndex = 0; sampleIndex < ccSampleCount; ++sampleIndex)
+		{
+			memcpy(source.string + sampleIndex * sampleLength, sample, sampleLength);
+		}
+		source.string[source.length] = '\0';
+	}
+
+	double bestTime = 0.0;
+	size_t tokenCount = 0;
+	CcSymbolStatistics symbols = {};
+	for(size_t runIndex = 0; runIndex < ccRunCount; ++runIndex)
+	{
+		CcTokenList tokenList;
+
+		const double start = ccNow();
+		const CcResult result = ccLexParallel((CcConstString){source.string, source.length}, CC_C23, threadCount, &tokenList);
+		const double time = ccNow() - start;
+
+		if(result != CC_SUCCESS)
+		{
+			fputs("Failed to lex the source.\n", stderr);
+			goto end;
+		}
+
+		if(runIndex == 0 || time < bestTime)
+		{
+			bestTime = time;
+		}
+		tokenCount = tokenList.count;
+		symbols = ccGetSymbolStatistics(&tokenList.symbols);
+
+		ccFreeTokenList(&tokenList);
+	}
+
+	printf("%zu bytes, %zu tokens, %zu threads, best of %zu runs: %.3f ms\n", source.length, tokenCount, threadCount, ccRunCount, bestTime * 1e3);
+	printf("%.1f MiB/s, %.1f Mtokens/s\n", (double)source.length / bestTime / (1 << 20), (double)tokenCount / bestTime / 1e6);
+	printf("%zu symbols, load factor %.2f, average probe length %.2f, maximum probe length %zu\n", symbols.symbolCount, symbols.loadFactor, symbols.averageProbeLength, symbols.maximumProbeLength);
+
+	status = EXIT_SUCCESS;
+
+	end:
+	ccFree(source.string, source.length + 1);
+
+	return status;
+}
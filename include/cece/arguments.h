@@ -22,20 +22,41 @@ typedef enum CcVersion: long
  * The compiling options.
  *
  * Fields:
- * - input: The path to the file to compile.
- * - output: The path to write the result to.
+ * - inputs: The paths to the files to compile.
+ * - outputs: The paths to write the results to, one per input.
+ * - inputCount: The number of inputs.
+ * - jobCount: The maximum number of files to compile concurrently, or of threads lexing a single file.
+ * - nestingLimit: The highest number of nested parentheses in an expression, 0 for the default.
+ * - diagnosticLimit: The highest number of diagnostics with each code written for a file, the others being counted in a single line, 0 to write them all.
+ * - cacheDirectory: The directory of the compilation cache, nullptr to disable the cache.
+ * - timeReportPath: The path to write the time report to as JSON, nullptr to not write it.
  * - version: The version of the C standard to use.
  * - debug: Switch to compile in debug or release mode.
+ * - timeReport: Switch to measure the time spent in each compilation phase.
+ * - memoryReport: Switch to measure the memory allocated by each compilation phase.
  */
 typedef struct CcOptions
 {
-	char* input;
-	char* output;
+	char** inputs;
+	char** outputs;
+	size_t inputCount;
+
+	size_t jobCount;
+
+	size_t nestingLimit;
+
+	size_t diagnosticLimit;
+
+	char* cacheDirectory;
+
+	char* timeReportPath;
 
 	CcVersion version;
 
 	bool debug: 1;
 	bool usage: 1;
+	bool timeReport: 1;
+	bool memoryReport: 1;
 } CcOptions;
 
 /*
@@ -53,4 +74,12 @@ typedef struct CcOptions
  */
 CcResult ccParseArguments(size_t argumentCount, const char* const* arguments, CcOptions* pOptions);
 
+/*
+ * Free the paths of compiling options.
+ *
+ * Parameters:
+ * - pOptions: A pointer to the options.
+ */
+void ccFreeOptions(CcOptions* pOptions);
+
 #endif
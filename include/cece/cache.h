@@ -0,0 +1,60 @@
+#ifndef CECE_CACHE_H
+#define CECE_CACHE_H
+
+#include <stdint.h>
+
+#include "cece/arguments.h"
+#include "cece/lex.h"
+
+/*
+ * The key of a compilation in the cache.
+ * Two independent 64-bit hashes of the source, the options affecting the result and the compiler version.
+ */
+typedef struct CcCacheKey
+{
+	uint64_t hashes[2];
+} CcCacheKey;
+
+/*
+ * Compute the cache key of a compilation.
+ *
+ * Parameters:
+ * - source: The source code.
+ * - pOptions: A pointer to the compiling options.
+ *
+ * Returns:
+ * The cache key.
+ */
+CcCacheKey ccCacheKey(CcConstString source, const CcOptions* pOptions);
+
+/*
+ * Restore the result of a cached compilation.
+ * Cache entries are named after their key: "<key>.s" holds the output of the compilation, "<key>.ok" marks a successful compilation without output.
+ *
+ * Parameters:
+ * - directory: The cache directory.
+ * - pKey: A pointer to the key of the compilation.
+ * - output: The path to copy the cached output to.
+ *
+ * Returns:
+ * - true if the compilation was found in the cache and its output, if any, was restored.
+ * - false otherwise.
+ */
+bool ccCacheRestore(const char* directory, const CcCacheKey* pKey, const char* output);
+
+/*
+ * Store the result of a successful compilation in the cache.
+ * The cache directory is created if needed. Entries are written to a temporary file first so that concurrent compilations never see partial entries.
+ *
+ * Parameters:
+ * - directory: The cache directory.
+ * - pKey: A pointer to the key of the compilation.
+ * - output: The path of the output of the compilation, nullptr if it produced none.
+ *
+ * Returns:
+ * - true if the entry was stored.
+ * - false otherwise.
+ */
+bool ccCacheStore(const char* directory, const CcCacheKey* pKey, const char* output);
+
+#endif
@@ -4,11 +4,54 @@
 #include <stdio.h>
 
 #include "cece/arguments.h"
+#include "cece/cache.h"
+#include "cece/character.h"
+#include "cece/diagnostic.h"
+#include "cece/file.h"
 #include "cece/lex.h"
 #include "cece/memory.h"
+#include "cece/report.h"
 #include "cece/result.h"
+#include "cece/scan.h"
+#include "cece/server.h"
+#include "cece/symbol.h"
 #include "cece/tree.h"
 
+// Version of the compiler, part of the compilation cache keys.
+#define CC_VERSION "0.1.0"
+
+/*
+ * Storage a thread keeps from one compilation to the next, emptied after each one instead of freed, so that compiling again allocates only once it outgrows it.
+ * A workspace initialized with {} is valid and empty.
+ *
+ * Fields:
+ * - lexer: The lexer of sources compiled from a file, with its tokens, constants, bracket partners and symbol table.
+ * - tree: The tree parsed from the source.
+ * - diagnosticArena: The arena the diagnostic sinks of the thread record into.
+ */
+typedef struct CcWorkspace
+{
+	CcLexer lexer;
+	CcTree tree;
+	CcArena diagnosticArena;
+} CcWorkspace;
+
+/*
+ * Set the workspace compilations of the calling thread use.
+ *
+ * Parameters:
+ * - pWorkspace: A pointer to the workspace, or nullptr for each compilation to allocate and free its own storage.
+ */
+void ccSetWorkspace(CcWorkspace* pWorkspace);
+
+/*
+ * Free the storage of a workspace, which must not be set on any thread.
+ *
+ * Parameters:
+ * - pWorkspace: A pointer to the workspace.
+ */
+void ccFreeWorkspace(CcWorkspace* pWorkspace);
+
 /*
  * Print usage.
  *
@@ -18,31 +61,36 @@
 void ccPrintUsage(FILE* file);
 
 /*
- * Read all the contents of a file in text mode.
+ * Compile a source file.
+ * Diagnostics are written to the diagnostic stream of the calling thread.
+ * The storage of the workspace of the calling thread is reused if one is set.
  *
  * Parameters:
- * - path: Path of the file.
- * - pString: A pointer to a string where to store the contents of the file.
+ * - input: The path to the file to compile.
+ * - output: The path to write the result to.
+ * - pOptions: A pointer to the options to use for compilation.
  *
  * Returns:
  * - CC_SUCCESS on success.
  * - CC_ERROR_FILE_NOT_FOUND if the file could not be opened.
- * - CC_ERROR_OUT_OF_MEMORY if the file is too large.
+ * - CC_ERROR_OUT_OF_MEMORY if the code is too large.
  * - CC_ERROR_UNKNOWN otherwise.
  */
-CcResult ccReadFile(const char* path, CcString* pString);
+CcResult ccCompileFile(const char* input, const char* output, const CcOptions* pOptions);
 
 /*
- * Compile a source file.
+ * Compile all the input files of the options.
+ * Up to pOptions->jobCount files are compiled concurrently, each on its own worker thread with its own buffers.
+ * The diagnostics of each file are written to the diagnostic stream of the calling thread in input order, whatever the order the files are compiled in.
+ * With pOptions->timeReport, the time spent in each phase by all files is then written to the diagnostic stream, and to pOptions->timeReportPath as JSON if set.
+ * Likewise, with pOptions->memoryReport, the memory allocated by each phase is written to the diagnostic stream.
  *
  * Parameters:
  * - pOptions: A pointer to the options to use for compilation.
  *
  * Returns:
- * - CC_SUCCESS on success.
- * - CC_ERROR_FILE_NOT_FOUND if the file could not be opened.
- * - CC_ERROR_OUT_OF_MEMORY if the code is too large.
- * - CC_ERROR_UNKNOWN otherwise.
+ * - CC_SUCCESS if all files compiled successfully.
+ * - The result of the first file, in input order, that failed to compile otherwise.
  */
 CcResult ccCompile(const CcOptions* pOptions);
 
@@ -0,0 +1,65 @@
+#ifndef CECE_CHARACTER_H
+#define CECE_CHARACTER_H
+
+#include <limits.h>
+
+/*
+ * A class of characters, used as a flag in ccCharacterClasses.
+ * Classes are those of the C locale whatever the locale of the process, so that source code is lexed the same way everywhere.
+ */
+typedef enum CcCharacterClass
+{
+	CC_CHARACTER_SPACE = 1 << 0,
+	CC_CHARACTER_PRINTABLE = 1 << 1,
+	CC_CHARACTER_LETTER = 1 << 2,
+	CC_CHARACTER_IDENTIFIER_START = 1 << 3,
+	CC_CHARACTER_IDENTIFIER = 1 << 4,
+	CC_CHARACTER_BINARY_DIGIT = 1 << 5,
+	CC_CHARACTER_OCTAL_DIGIT = 1 << 6,
+	CC_CHARACTER_DECIMAL_DIGIT = 1 << 7,
+	CC_CHARACTER_HEXADECIMAL_DIGIT = 1 << 8
+} CcCharacterClass;
+
+// Classes shared by groups of characters, a digit in some base being a digit in all larger bases.
+#define CC_CHARACTER_HEXADECIMAL (CC_CHARACTER_HEXADECIMAL_DIGIT | CC_CHARACTER_ALPHABETIC)
+#define CC_CHARACTER_ALPHABETIC (CC_CHARACTER_LETTER | CC_CHARACTER_IDENTIFIER_START | CC_CHARACTER_IDENTIFIER | CC_CHARACTER_PRINTABLE)
+#define CC_CHARACTER_DECIMAL (CC_CHARACTER_DECIMAL_DIGIT | CC_CHARACTER_HEXADECIMAL_DIGIT | CC_CHARACTER_IDENTIFIER | CC_CHARACTER_PRINTABLE)
+#define CC_CHARACTER_OCTAL (CC_CHARACTER_OCTAL_DIGIT | CC_CHARACTER_DECIMAL)
+#define CC_CHARACTER_BINARY (CC_CHARACTER_BINARY_DIGIT | CC_CHARACTER_OCTAL)
+
+// The classes of each character, as a combination of CcCharacterClass flags.
+static constexpr unsigned short ccCharacterClasses[UCHAR_MAX + 1] = {
+	[' '] = CC_CHARACTER_SPACE | CC_CHARACTER_PRINTABLE,
+	['\t'] = CC_CHARACTER_SPACE, ['\n'] = CC_CHARACTER_SPACE, ['\v'] = CC_CHARACTER_SPACE, ['\f'] = CC_CHARACTER_SPACE, ['\r'] = CC_CHARACTER_SPACE,
+	['0'] = CC_CHARACTER_BINARY, ['1'] = CC_CHARACTER_BINARY,
+	['2'] = CC_CHARACTER_OCTAL, ['3'] = CC_CHARACTER_OCTAL, ['4'] = CC_CHARACTER_OCTAL, ['5'] = CC_CHARACTER_OCTAL, ['6'] = CC_CHARACTER_OCTAL, ['7'] = CC_CHARACTER_OCTAL,
+	['8'] = CC_CHARACTER_DECIMAL, ['9'] = CC_CHARACTER_DECIMAL,
+	['a'] = CC_CHARACTER_HEXADECIMAL, ['b'] = CC_CHARACTER_HEXADECIMAL, ['c'] = CC_CHARACTER_HEXADECIMAL, ['d'] = CC_CHARACTER_HEXADECIMAL, ['e'] = CC_CHARACTER_HEXADECIMAL, ['f'] = CC_CHARACTER_HEXADECIMAL,
+	['A'] = CC_CHARACTER_HEXADECIMAL, ['B'] = CC_CHARACTER_HEXADECIMAL, ['C'] = CC_CHARACTER_HEXADECIMAL, ['D'] = CC_CHARACTER_HEXADECIMAL, ['E'] = CC_CHARACTER_HEXADECIMAL, ['F'] = CC_CHARACTER_HEXADECIMAL,
+	['g'] = CC_CHARACTER_ALPHABETIC, ['h'] = CC_CHARACTER_ALPHABETIC, ['i'] = CC_CHARACTER_ALPHABETIC, ['j'] = CC_CHARACTER_ALPHABETIC, ['k'] = CC_CHARACTER_ALPHABETIC, ['l'] = CC_CHARACTER_ALPHABETIC, ['m'] = CC_CHARACTER_ALPHABETIC,
+	['n'] = CC_CHARACTER_ALPHABETIC, ['o'] = CC_CHARACTER_ALPHABETIC, ['p'] = CC_CHARACTER_ALPHABETIC, ['q'] = CC_CHARACTER_ALPHABETIC, ['r'] = CC_CHARACTER_ALPHABETIC, ['s'] = CC_CHARACTER_ALPHABETIC, ['t'] = CC_CHARACTER_ALPHABETIC,
+	['u'] = CC_CHARACTER_ALPHABETIC, ['v'] = CC_CHARACTER_ALPHABETIC, ['w'] = CC_CHARACTER_ALPHABETIC, ['x'] = CC_CHARACTER_ALPHABETIC, ['y'] = CC_CHARACTER_ALPHABETIC, ['z'] = CC_CHARACTER_ALPHABETIC,
+	['G'] = CC_CHARACTER_ALPHABETIC, ['H'] = CC_CHARACTER_ALPHABETIC, ['I'] = CC_CHARACTER_ALPHABETIC, ['J'] = CC_CHARACTER_ALPHABETIC, ['K'] = CC_CHARACTER_ALPHABETIC, ['L'] = CC_CHARACTER_ALPHABETIC, ['M'] = CC_CHARACTER_ALPHABETIC,
+	['N'] = CC_CHARACTER_ALPHABETIC, ['O'] = CC_CHARACTER_ALPHABETIC, ['P'] = CC_CHARACTER_ALPHABETIC, ['Q'] = CC_CHARACTER_ALPHABETIC, ['R'] = CC_CHARACTER_ALPHABETIC, ['S'] = CC_CHARACTER_ALPHABETIC, ['T'] = CC_CHARACTER_ALPHABETIC,
+	['U'] = CC_CHARACTER_ALPHABETIC, ['V'] = CC_CHARACTER_ALPHABETIC, ['W'] = CC_CHARACTER_ALPHABETIC, ['X'] = CC_CHARACTER_ALPHABETIC, ['Y'] = CC_CHARACTER_ALPHABETIC, ['Z'] = CC_CHARACTER_ALPHABETIC,
+	['_'] = CC_CHARACTER_IDENTIFIER_START | CC_CHARACTER_IDENTIFIER | CC_CHARACTER_PRINTABLE,
+	['!'] = CC_CHARACTER_PRINTABLE, ['"'] = CC_CHARACTER_PRINTABLE, ['#'] = CC_CHARACTER_PRINTABLE, ['$'] = CC_CHARACTER_PRINTABLE, ['%'] = CC_CHARACTER_PRINTABLE, ['&'] = CC_CHARACTER_PRINTABLE, ['\''] = CC_CHARACTER_PRINTABLE, ['('] = CC_CHARACTER_PRINTABLE,
+	[')'] = CC_CHARACTER_PRINTABLE, ['*'] = CC_CHARACTER_PRINTABLE, ['+'] = CC_CHARACTER_PRINTABLE, [','] = CC_CHARACTER_PRINTABLE, ['-'] = CC_CHARACTER_PRINTABLE, ['.'] = CC_CHARACTER_PRINTABLE, ['/'] = CC_CHARACTER_PRINTABLE, [':'] = CC_CHARACTER_PRINTABLE,
+	[';'] = CC_CHARACTER_PRINTABLE, ['<'] = CC_CHARACTER_PRINTABLE, ['='] = CC_CHARACTER_PRINTABLE, ['>'] = CC_CHARACTER_PRINTABLE, ['?'] = CC_CHARACTER_PRINTABLE, ['@'] = CC_CHARACTER_PRINTABLE, ['['] = CC_CHARACTER_PRINTABLE, ['\\'] = CC_CHARACTER_PRINTABLE,
+	[']'] = CC_CHARACTER_PRINTABLE, ['^'] = CC_CHARACTER_PRINTABLE, ['`'] = CC_CHARACTER_PRINTABLE, ['{'] = CC_CHARACTER_PRINTABLE, ['|'] = CC_CHARACTER_PRINTABLE, ['}'] = CC_CHARACTER_PRINTABLE, ['~'] = CC_CHARACTER_PRINTABLE
+};
+
+#undef CC_CHARACTER_BINARY
+#undef CC_CHARACTER_OCTAL
+#undef CC_CHARACTER_DECIMAL
+#undef CC_CHARACTER_ALPHABETIC
+#undef CC_CHARACTER_HEXADECIMAL
+
+// The value of each digit, in any base, 0 for other characters.
+static constexpr unsigned char ccDigitValues[UCHAR_MAX + 1] = {
+	['0'] = 0, ['1'] = 1, ['2'] = 2, ['3'] = 3, ['4'] = 4, ['5'] = 5, ['6'] = 6, ['7'] = 7, ['8'] = 8, ['9'] = 9,
+	['a'] = 10, ['b'] = 11, ['c'] = 12, ['d'] = 13, ['e'] = 14, ['f'] = 15,
+	['A'] = 10, ['B'] = 11, ['C'] = 12, ['D'] = 13, ['E'] = 14, ['F'] = 15
+};
+
+#endif
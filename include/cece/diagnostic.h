@@ -0,0 +1,331 @@
+#ifndef CECE_DIAGNOSTIC_H
+#define CECE_DIAGNOSTIC_H
+
+#include <stddef.h>
+#include <stdio.h>
+
+#include "cece/memory.h"
+#include "cece/result.h"
+
+/*
+ * The lines of a source code, to locate positions in it.
+ *
+ * Fields:
+ * - source: The source code.
+ * - length: The length of the source code.
+ * - lineStarts: The offset of the first character of each line.
+ * - lineCount: The number of lines.
+ */
+typedef struct CcSourceMap
+{
+	const char* source;
+	size_t length;
+
+	size_t* lineStarts;
+	size_t lineCount;
+} CcSourceMap;
+
+/*
+ * Build the map of the lines of a source code.
+ *
+ * Parameters:
+ * - source: The source code.
+ * - length: The length of the source code.
+ * - pMap: A pointer to the map.
+ *
+ * Returns:
+ * - CC_SUCCESS if the map is built, it is to be freed with ccFreeSourceMap.
+ * - CC_ERROR_OUT_OF_MEMORY if memory allocation fails.
+ */
+CcResult ccBuildSourceMap(const char* source, size_t length, CcSourceMap* pMap);
+
+/*
+ * Find the line and column of a position in a source code.
+ * Lines and columns start at 1, columns count bytes.
+ *
+ * Parameters:
+ * - pMap: A pointer to the map of the source code.
+ * - position: A pointer into the source code, its end included.
+ * - pLine: A pointer to store the line.
+ * - pColumn: A pointer to store the column.
+ *
+ * Returns:
+ * - true if the position is in the source code.
+ * - false otherwise.
+ */
+bool ccLocate(const CcSourceMap* pMap, const char* position, size_t* pLine, size_t* pColumn);
+
+/*
+ * Free the map of the lines of a source code.
+ *
+ * Parameters:
+ * - pMap: A pointer to the map.
+ */
+void ccFreeSourceMap(CcSourceMap* pMap);
+
+/*
+ * The source code diagnostics refer to.
+ *
+ * Fields:
+ * - name: The name of the source code, nullptr if it has none.
+ * - string: The source code, nullptr if there is none.
+ * - length: The length of the source code.
+ */
+typedef struct CcDiagnosticSource
+{
+	const char* name;
+	const char* string;
+	size_t length;
+} CcDiagnosticSource;
+
+/*
+ * The severities of diagnostics.
+ */
+typedef enum CcSeverity
+{
+	CC_SEVERITY_ERROR,
+	CC_SEVERITY_WARNING
+} CcSeverity;
+
+/*
+ * The diagnostics reported by code, with their severity and message.
+ */
+#define CC_DIAGNOSTIC(F) \
+	F(UNEXPECTED_TOKEN, ERROR, "Unexpected token.") \
+	F(INVALID_STRING_CHARACTER, ERROR, "Invalid character in string literal.") \
+	F(UNFINISHED_STRING, ERROR, "Unfinished string literal.") \
+	F(INVALID_CHARACTER_CONSTANT, ERROR, "Invalid character constant.") \
+	F(INVALID_INTEGER_SUFFIX, ERROR, "Invalid integer literal suffix.") \
+	F(INTEGER_TOO_LARGE, ERROR, "Integer literal too large.") \
+	F(UNMATCHED_BRACKET, ERROR, "Unmatched bracket.") \
+	F(NESTING_TOO_DEEP, ERROR, "Parentheses nested too deeply.")
+
+#define CC_DIAGNOSTIC_ENUM(name, severity, message) \
+	CC_DIAGNOSTIC_##name,
+
+/*
+ * A diagnostic code.
+ */
+typedef enum CcDiagnosticCode
+{
+	CC_DIAGNOSTIC(CC_DIAGNOSTIC_ENUM)
+	CC_DIAGNOSTIC_COUNT
+} CcDiagnosticCode;
+
+/*
+ * Get the severity of a diagnostic.
+ *
+ * Parameters:
+ * - code: A diagnostic code.
+ *
+ * Returns:
+ * The severity of the diagnostic.
+ */
+CcSeverity ccDiagnosticSeverity(CcDiagnosticCode code);
+
+/*
+ * Get the message of a diagnostic.
+ *
+ * Parameters:
+ * - code: A diagnostic code.
+ *
+ * Returns:
+ * The message of the diagnostic.
+ */
+const char* ccDiagnosticMessage(CcDiagnosticCode code);
+
+/*
+ * A diagnostic recorded by a sink.
+ *
+ * Fields:
+ * - code: The code of the diagnostic.
+ * - offset: The offset in the source code of the sink it was reported at, SIZE_MAX if it was reported outside of it.
+ * - repeatCount: The number of times it was reported, repeats on the same line being merged.
+ */
+typedef struct CcDiagnosticRecord
+{
+	CcDiagnosticCode code;
+	size_t offset;
+	size_t repeatCount;
+} CcDiagnosticRecord;
+
+typedef struct CcDiagnosticPage CcDiagnosticPage;
+
+/*
+ * A sink recording diagnostics to write them all at once.
+ * Records are kept in pages allocated from an arena.
+ * Positions are stored as offsets in the source, so that records stay valid once the memory they pointed to is reused.
+ * A record repeating the code of the previous one is merged into it when both are on the same line of the source, records outside of it are never merged.
+ * A sink initialized with {} is valid and empty, and records without merging repeats.
+ *
+ * Fields:
+ * - source: The source code offsets refer to.
+ * - arena: The arena holding the pages.
+ * - pFirstPage: The first page of records.
+ * - pLastPage: The last page of records.
+ * - recordCount: The number of records, merged repeats counting once.
+ */
+typedef struct CcDiagnosticSink
+{
+	CcDiagnosticSource source;
+
+	CcArena arena;
+	CcDiagnosticPage* pFirstPage;
+	CcDiagnosticPage* pLastPage;
+	size_t recordCount;
+} CcDiagnosticSink;
+
+/*
+ * Set the stream diagnostics of the calling thread are written to.
+ * Each thread starts writing its diagnostics to stderr.
+ *
+ * Parameters:
+ * - file: The stream to write diagnostics to, or nullptr for stderr.
+ */
+void ccSetDiagnosticFile(FILE* file);
+
+/*
+ * Get the stream diagnostics of the calling thread are written to.
+ *
+ * Returns:
+ * The diagnostic stream.
+ */
+FILE* ccGetDiagnosticFile(void);
+
+/*
+ * Write a diagnostic line to the diagnostic stream of the calling thread.
+ *
+ * Parameters:
+ * - format: A printf format string, without the trailing newline.
+ * - ...: The format arguments.
+ */
+void ccDiagnose(const char* format, ...);
+
+/*
+ * Set the source code the diagnostics of the calling thread refer to.
+ * Its lines are only mapped when the first diagnostic locating a position in it is written.
+ *
+ * Parameters:
+ * - source: The source code, {} if diagnostics refer to none.
+ */
+void ccSetDiagnosticSource(CcDiagnosticSource source);
+
+/*
+ * Get the source code the diagnostics of the calling thread refer to.
+ *
+ * Returns:
+ * The source code, {} if diagnostics refer to none.
+ */
+CcDiagnosticSource ccGetDiagnosticSource(void);
+
+/*
+ * Write a diagnostic line about a position in the source code to the diagnostic stream of the calling thread.
+ * The line starts with the name, line and column of the position if it is in the source code diagnostics refer to.
+ *
+ * Parameters:
+ * - position: A pointer into the source code.
+ * - format: A printf format string, without the trailing newline.
+ * - ...: The format arguments.
+ */
+void ccDiagnoseAt(const char* position, const char* format, ...);
+
+/*
+ * Set the highest number of diagnostics with a code written by each sink of the calling thread, the others being counted in a single line.
+ * Each thread starts without limits.
+ *
+ * Parameters:
+ * - code: A diagnostic code.
+ * - limit: The highest number of diagnostics written, 0 to write them all.
+ */
+void ccSetDiagnosticLimit(CcDiagnosticCode code, size_t limit);
+
+/*
+ * Set the sink recording the diagnostics reported by the calling thread.
+ * Diagnostics written with ccDiagnose or ccDiagnoseAt are not recorded, the records of the sink are written before them to keep them in order.
+ *
+ * Parameters:
+ * - pSink: A pointer to the sink, or nullptr to write diagnostics as they are reported.
+ */
+void ccSetDiagnosticSink(CcDiagnosticSink* pSink);
+
+/*
+ * Get the sink recording the diagnostics reported by the calling thread.
+ *
+ * Returns:
+ * A pointer to the sink, or nullptr if diagnostics are written as they are reported.
+ */
+CcDiagnosticSink* ccGetDiagnosticSink(void);
+
+/*
+ * Start recording the diagnostics of a phase.
+ * The sink is emptied, and records the diagnostics of the calling thread unless it already has a sink, in which case that one keeps recording them.
+ *
+ * Parameters:
+ * - pSink: A pointer to the sink.
+ */
+void ccBeginDiagnostics(CcDiagnosticSink* pSink);
+
+/*
+ * Set the arena the calling thread lends to the sink that becomes its active one, so that the blocks of the arena are kept from one sink to the next.
+ * The sink takes the arena in ccBeginDiagnostics, and ccFreeDiagnosticSink empties it and gives it back.
+ *
+ * Parameters:
+ * - pArena: A pointer to an arena initialized with {}, or nullptr for each sink to allocate its own.
+ */
+void ccSetDiagnosticArena(CcArena* pArena);
+
+/*
+ * Stop recording the diagnostics of a phase started with ccBeginDiagnostics.
+ * If the sink records the diagnostics of the calling thread, it stops and its records are written.
+ *
+ * Parameters:
+ * - pSink: A pointer to the sink.
+ */
+void ccEndDiagnostics(CcDiagnosticSink* pSink);
+
+/*
+ * Report a diagnostic.
+ * It is recorded by the sink of the calling thread if it has one, written otherwise.
+ *
+ * Parameters:
+ * - code: The code of the diagnostic.
+ * - position: A pointer into the source code, or nullptr.
+ */
+void ccReportDiagnostic(CcDiagnosticCode code, const char* position);
+
+/*
+ * Record the records of a sink into another, in order, as if they were reported again.
+ *
+ * Parameters:
+ * - pSink: A pointer to the sink to record into.
+ * - pOther: A pointer to the sink to record from.
+ */
+void ccMergeDiagnosticSink(CcDiagnosticSink* pSink, const CcDiagnosticSink* pOther);
+
+/*
+ * Write the records of a sink to the diagnostic stream of the calling thread in a single write, then empty it.
+ * Records are located in the source code diagnostics of the calling thread refer to.
+ *
+ * Parameters:
+ * - pSink: A pointer to the sink.
+ */
+void ccFlushDiagnosticSink(CcDiagnosticSink* pSink);
+
+/*
+ * Empty a sink without writing its records.
+ *
+ * Parameters:
+ * - pSink: A pointer to the sink.
+ */
+void ccFreeDiagnosticSink(CcDiagnosticSink* pSink);
+
+/*
+ * Get the number of diagnostics written by the calling thread.
+ * Merged repeats count as many times as they were reported, diagnostics left out by limits count too.
+ *
+ * Returns:
+ * The number of diagnostics written by the calling thread since it started.
+ */
+size_t ccGetDiagnosticCount(void);
+
+#endif
@@ -0,0 +1,84 @@
+#ifndef CECE_FILE_H
+#define CECE_FILE_H
+
+#include <stddef.h>
+#include <stdio.h>
+
+#include "cece/lex.h"
+#include "cece/result.h"
+
+/*
+ * A loaded source file.
+ *
+ * Fields:
+ * - string: The contents of the file. Cece always makes it null-terminated.
+ * - buffer: The buffer holding the contents if the file was read, nullptr otherwise.
+ * - mapping: The start of the memory mapping if the file was mapped, nullptr otherwise.
+ * - mappingSize: The size of the memory mapping.
+ */
+typedef struct CcSourceFile
+{
+	CcConstString string;
+
+	char* buffer;
+
+	void* mapping;
+	size_t mappingSize;
+} CcSourceFile;
+
+/*
+ * Read all the contents of a stream.
+ *
+ * Parameters:
+ * - file: The stream to read.
+ * - pString: A pointer to a string where to store the contents of the stream, to be freed with ccFree(pString->string, pString->length + 1).
+ *
+ * Returns:
+ * - CC_SUCCESS on success.
+ * - CC_ERROR_OUT_OF_MEMORY if the stream is too large.
+ * - CC_ERROR_UNKNOWN otherwise.
+ */
+CcResult ccReadStream(FILE* file, CcString* pString);
+
+/*
+ * Read all the contents of a file in text mode.
+ *
+ * Parameters:
+ * - path: Path of the file.
+ * - pString: A pointer to a string where to store the contents of the file, to be freed with ccFree(pString->string, pString->length + 1).
+ *
+ * Returns:
+ * - CC_SUCCESS on success.
+ * - CC_ERROR_FILE_NOT_FOUND if the file could not be opened.
+ * - CC_ERROR_OUT_OF_MEMORY if the file is too large.
+ * - CC_ERROR_UNKNOWN otherwise.
+ */
+CcResult ccReadFile(const char* path, CcString* pString);
+
+/*
+ * Load a source file.
+ *
+ * Regular files are mapped read-only when the platform supports it, with a zero-filled page providing the null terminator when the file ends on a page boundary.
+ * Pipes, devices and standard input (path "-") are read into a buffer instead.
+ *
+ * Parameters:
+ * - path: Path of the file, or "-" for standard input.
+ * - pFile: A pointer to the loaded file.
+ *
+ * Returns:
+ * - CC_SUCCESS on success.
+ * - CC_ERROR_FILE_NOT_FOUND if the file could not be opened.
+ * - CC_ERROR_OUT_OF_MEMORY if the file is too large.
+ * - CC_ERROR_UNKNOWN otherwise.
+ */
+CcResult ccLoadFile(const char* path, CcSourceFile* pFile);
+
+/*
+ * Release a source file loaded by ccLoadFile.
+ *
+ * Parameters:
+ * - pFile: A pointer to the loaded file.
+ */
+void ccUnloadFile(CcSourceFile* pFile);
+
+#endif
@@ -2,8 +2,12 @@
 #define CECE_LEX_H
 
 #include <stddef.h>
+#include <stdint.h>
 
+#include "cece/arguments.h"
+#include "cece/memory.h"
 #include "cece/result.h"
+#include "cece/symbol.h"
 
 /*
  * A string.
@@ -187,15 +191,12 @@ typedef struct CcConstant
 } CcConstant;
 
 /*
- * A token.
+ * A token, as recognized by the parsing functions before it is stored in a token list.
  *
  * Fields:
  * - type: The token type.
- * If the token is a literal:
- * - intLiteral: The integer literal value.
- * If the token is a string or identifier:
- * - offset: The offset of the token in the buffer.
- * - length: The length of the token.
+ * - string: The text of the token.
+ * - constant: The value of the token if it is a constant.
  */
 typedef struct CcToken
 {
@@ -208,24 +209,160 @@ typedef struct CcToken
 
 /*
  * A list of tokens.
+ * Tokens are stored as parallel arrays, so that scanning token types only touches the types.
  *
  * Fields:
- * - buffer: A character buffer for strings and identifiers.
- * - tokens: An array of tokens.
+ * - types: The CcTokenType of each token.
+ * - offsets: The offset of the text of each token in source.
+ * - lengths: The length of the text of each token.
+ * - values: The index of the value of each constant in constants, the symbol of each identifier in symbols, 0 for other tokens. It starts the block holding the other per-token arrays.
  * - count: The number of tokens.
+ * - capacity: The number of tokens allocated.
+ * - constants: The values of the constants.
+ * - constantCount: The number of constants.
+ * - constantCapacity: The number of constants allocated.
+ * - symbols: The names of the identifiers.
+ * - partners: The index of the bracket matching each bracket when brackets were last matched, UINT32_MAX for unmatched ones, the index of the token itself for other tokens.
+ * - partnerCapacity: The number of partners allocated.
+ * - unmatchedIndex: The index of the first unmatched bracket when brackets were last matched, SIZE_MAX if there is none.
+ * - source: The text the offsets refer to.
+ * - text: Storage for the text of the tokens when they do not point into the source, or nullptr.
+ * - textLength: The number of characters of text used.
+ * - textCapacity: The number of characters of text allocated.
  */
 typedef struct CcTokenList
 {
-	CcToken* tokens;
+	uint8_t* types;
+	uint32_t* offsets;
+	uint32_t* lengths;
+	uint32_t* values;
 	size_t count;
+	size_t capacity;
+
+	CcConstant* constants;
+	size_t constantCount;
+	size_t constantCapacity;
+
+	CcSymbolTable symbols;
+
+	uint32_t* partners;
+	size_t partnerCapacity;
+	size_t unmatchedIndex;
+
+	const char* source;
+
+	char* text;
+	size_t textLength;
+	size_t textCapacity;
 } CcTokenList;
 
+/*
+ * A range of tokens of a token list.
+ *
+ * Fields:
+ * - pTokenList: A pointer to the token list.
+ * - start: The index of the first token of the range.
+ * - count: The number of tokens in the range.
+ */
 typedef struct CcConstTokenList
 {
-	const CcToken* tokens;
+	const CcTokenList* pTokenList;
+	size_t start;
 	size_t count;
 } CcConstTokenList;
 
+/*
+ * Get the types of a range of tokens.
+ *
+ * Parameters:
+ * - tokens: A pointer to a range of tokens.
+ *
+ * Returns:
+ * The CcTokenType of each token of the range.
+ */
+const uint8_t* ccGetTokenTypes(const CcConstTokenList* tokens);
+
+/*
+ * Get the text of a token.
+ *
+ * Parameters:
+ * - tokens: A pointer to a range of tokens.
+ * - tokenIndex: The index of the token in the range.
+ *
+ * Returns:
+ * The text of the token.
+ */
+CcStringView ccGetTokenString(const CcConstTokenList* tokens, size_t tokenIndex);
+
+/*
+ * Get the value of a constant.
+ *
+ * Parameters:
+ * - tokens: A pointer to a range of tokens.
+ * - tokenIndex: The index of the token in the range, which must be a constant.
+ *
+ * Returns:
+ * The value of the constant.
+ */
+CcConstant ccGetTokenConstant(const CcConstTokenList* tokens, size_t tokenIndex);
+
+/*
+ * Get the symbol of an identifier.
+ * Identifiers with the same name have the same symbol in a token list.
+ *
+ * Parameters:
+ * - tokens: A pointer to a range of tokens.
+ * - tokenIndex: The index of the token in the range, which must be an identifier.
+ *
+ * Returns:
+ * The symbol of the identifier.
+ */
+uint32_t ccGetTokenSymbol(const CcConstTokenList* tokens, size_t tokenIndex);
+
+/*
+ * Get the bracket matching a token.
+ * The brackets of the token list must be matched.
+ *
+ * Parameters:
+ * - tokens: A pointer to a range of tokens.
+ * - tokenIndex: The index of the token in the range.
+ *
+ * Returns:
+ * - The index in the range of the matching bracket if the token is a bracket.
+ * - tokenIndex if the token is not a bracket.
+ * - SIZE_MAX if the bracket is unmatched or its match is out of the range.
+ */
+size_t ccGetTokenPartner(const CcConstTokenList* tokens, size_t tokenIndex);
+
+/*
+ * Match the parentheses, braces and square brackets of a token list.
+ * Open brackets are kept in a stack threaded through the partners, so matching is a single pass without other allocation.
+ * A closing bracket not matching the last open one is unmatched and leaves that one open.
+ *
+ * Parameters:
+ * - pTokenList: A pointer to a list of tokens.
+ *
+ * Returns:
+ * - CC_SUCCESS if the brackets are matched.
+ * - CC_ERROR_OUT_OF_MEMORY if memory allocation fails.
+ */
+CcResult ccMatchBrackets(CcTokenList* pTokenList);
+
+/*
+ * Append a token to a list of tokens.
+ *
+ * Parameters:
+ * - pTokenList: A pointer to a list of tokens.
+ * - pToken: A pointer to the token.
+ * - offset: The offset of the text of the token in the source of the list.
+ *
+ * Returns:
+ * - CC_SUCCESS if the token is appended.
+ * - CC_ERROR_INVALID_ARGUMENT if the offset or length of the token do not fit in 32 bits, or if there are too many identifiers.
+ * - CC_ERROR_OUT_OF_MEMORY if memory allocation fails, in which case the list is left untouched.
+ */
+CcResult ccAppendToken(CcTokenList* pTokenList, const CcToken* pToken, size_t offset);
+
 /*
  * Parse a string literal.
  *
@@ -280,29 +417,235 @@ bool ccParseConstant(const char* string, CcToken* pToken);
 
 /*
  * Parse an identifier or keyword.
+ * Keywords introduced after the given version of the C standard are parsed as identifiers.
  *
  * Parameters:
  * - string: A string.
+ * - version: The version of the C standard to use.
  * - pToken: A pointer to a token to store the result.
  *
  * Returns:
  * - true if an identifier or keyword was found.
  * - false otherwise.
  */
-bool ccParseIdentifier(const char* string, CcToken* pToken);
+bool ccParseIdentifier(const char* string, CcVersion version, CcToken* pToken);
 
 /*
  * Lex a string into a list of tokens.
+ * Its diagnostics are recorded and written once it is lexed, unless the calling thread already records them.
+ *
+ * Parameters:
+ * - string: A string.
+ * - version: The version of the C standard to use.
+ * - pTokenList: A pointer to a list of tokens.
+ *
+ * Returns:
+ * - CC_SUCCESS if the string is successfully lexed.
+ * - CC_ERROR_OUT_OF_MEMORY if memory allocation fails.
+ */
+CcResult ccLex(CcConstString string, CcVersion version, CcTokenList* pTokenList);
+
+/*
+ * Check whether ccLexParallel splits a string into chunks.
+ *
+ * Parameters:
+ * - length: The length of the string.
+ * - threadCount: The maximum number of threads to use.
+ *
+ * Returns:
+ * - true if the string is long enough and there are enough threads for chunks to be lexed faster than the whole string.
+ * - false if ccLexParallel lexes it like ccLex.
+ */
+bool ccIsSplitWorthIt(size_t length, size_t threadCount);
+
+/*
+ * Lex a string into a list of tokens with several threads.
+ * The string is split into chunks at line breaks outside of string literals and character constants, found by a quick scan of its quotes.
+ * Each chunk is lexed by its own thread, then their tokens are concatenated in order.
+ * The tokens, symbols and diagnostics are the ones ccLex gives. Strings too small to be worth splitting, or too few threads to make up for joining the chunks, are lexed by ccLex.
  *
  * Parameters:
  * - string: A string.
+ * - version: The version of the C standard to use.
+ * - threadCount: The maximum number of threads to use, including the calling thread.
  * - pTokenList: A pointer to a list of tokens.
  *
  * Returns:
  * - CC_SUCCESS if the string is successfully lexed.
  * - CC_ERROR_OUT_OF_MEMORY if memory allocation fails.
  */
-CcResult ccLex(CcConstString string, CcTokenList* pTokenList);
+CcResult ccLexParallel(CcConstString string, CcVersion version, size_t threadCount, CcTokenList* pTokenList);
+
+/*
+ * A function reading source code.
+ * It behaves like fread: it only reads fewer bytes than requested at the end of the input or on error.
+ *
+ * Parameters:
+ * - pUserData: The user data passed to ccLexStream.
+ * - buffer: The buffer to read to.
+ * - size: The number of bytes to read.
+ *
+ * Returns:
+ * The number of bytes read.
+ */
+typedef size_t (*CcRead)(void* pUserData, char* buffer, size_t size);
+
+/*
+ * Lex source code read incrementally into a list of tokens.
+ * The source is read through a window which only grows to fit the longest token, tokens cut by the end of the window are lexed again once it is refilled.
+ * The text of the tokens is copied to the token list.
+ *
+ * Parameters:
+ * - read: The function reading the source code.
+ * - pUserData: The user data passed to the read function.
+ * - version: The version of the C standard to use.
+ * - pTokenList: A pointer to a list of tokens.
+ *
+ * Returns:
+ * - CC_SUCCESS if the source is successfully lexed.
+ * - CC_ERROR_OUT_OF_MEMORY if memory allocation fails.
+ */
+CcResult ccLexStream(CcRead read, void* pUserData, CcVersion version, CcTokenList* pTokenList);
+
+/*
+ * A window over source code read incrementally.
+ *
+ * Fields:
+ * - read: The function reading the source code, nullptr if the whole source is in memory.
+ * - pUserData: The user data passed to the read function.
+ * - buffer: The buffer holding the window, null-terminated at its end.
+ * - size: The size of the buffer.
+ * - start: The offset of the first byte still needed, bytes before it are dropped by the next read.
+ * - end: The offset of the end of the window.
+ * - finished: Whether the whole source has been read.
+ */
+typedef struct CcWindow
+{
+	CcRead read;
+	void* pUserData;
+
+	char* buffer;
+	size_t size;
+
+	size_t start;
+	size_t end;
+
+	bool finished;
+} CcWindow;
+
+/*
+ * A cursor lexing source code one token at a time.
+ * Tokens are appended to a window holding the tokens lexed since the consumer last released them, so that the tokens of the whole source are never held at once.
+ * Identifiers keep their symbol across releases, the storage of released tokens is reused.
+ * A lexer over a stream also only keeps the text from the first token not released yet, so its memory is bounded by the longest run of tokens between releases.
+ *
+ * Fields:
+ * - string: The source in memory, for a stream the text of its window.
+ * - version: The version of the C standard to use.
+ * - position: The index of the next character to lex in the string.
+ * - window: The window the stream is read through.
+ * - tokenList: The window of tokens, whose offsets refer to the string.
+ * - peakCount: The largest number of tokens the window held before being released.
+ * - finished: Whether the whole source is lexed.
+ */
+typedef struct CcLexer
+{
+	CcConstString string;
+	CcVersion version;
+	size_t position;
+
+	CcWindow window;
+
+	CcTokenList tokenList;
+	size_t peakCount;
+
+	bool finished;
+} CcLexer;
+
+/*
+ * Create a lexer over a string.
+ *
+ * Parameters:
+ * - string: A string, which must outlive the lexer.
+ * - version: The version of the C standard to use.
+ * - pLexer: A pointer to the lexer.
+ *
+ * Returns:
+ * - CC_SUCCESS if the lexer is created, it is to be freed with ccFreeLexer.
+ * - CC_ERROR_INVALID_ARGUMENT if the string is too large for 32-bit token offsets.
+ */
+CcResult ccCreateLexer(CcConstString string, CcVersion version, CcLexer* pLexer);
+
+/*
+ * Create a lexer over a string from the storage of an empty lexer, so that lexing does not allocate until it outgrows what it held before.
+ *
+ * Parameters:
+ * - string: A string, which must outlive the lexer.
+ * - version: The version of the C standard to use.
+ * - pLexer: A pointer to a lexer initialized with {} or emptied by ccClearLexer.
+ *
+ * Returns:
+ * - CC_SUCCESS if the lexer is created, it is to be emptied with ccClearLexer or freed with ccFreeLexer.
+ * - CC_ERROR_INVALID_ARGUMENT if the string is too large for 32-bit token offsets.
+ */
+CcResult ccResetLexer(CcConstString string, CcVersion version, CcLexer* pLexer);
+
+/*
+ * Create a lexer over source code read incrementally.
+ * Tokens are lexed like ccLexStream does, but their text is only kept until they are released.
+ *
+ * Parameters:
+ * - read: The function reading the source code.
+ * - pUserData: The user data passed to the read function.
+ * - version: The version of the C standard to use.
+ * - pLexer: A pointer to the lexer.
+ *
+ * Returns:
+ * - CC_SUCCESS if the lexer is created, it is to be freed with ccFreeLexer.
+ * - CC_ERROR_OUT_OF_MEMORY if memory allocation fails.
+ */
+CcResult ccCreateStreamLexer(CcRead read, void* pUserData, CcVersion version, CcLexer* pLexer);
+
+/*
+ * Lex the next token of a lexer into its window.
+ * Characters starting no token are reported and skipped, like ccLex does.
+ *
+ * Parameters:
+ * - pLexer: A pointer to the lexer.
+ *
+ * Returns:
+ * - CC_SUCCESS if a token is appended to the window, or if the source is finished, in which case finished is set.
+ * - CC_ERROR_INVALID_ARGUMENT if there are too many identifiers, or if the text of the window does not fit 32-bit offsets.
+ * - CC_ERROR_OUT_OF_MEMORY if memory allocation fails.
+ */
+CcResult ccNextToken(CcLexer* pLexer);
+
+/*
+ * Release the tokens of the window of a lexer.
+ * Symbols of released tokens stay valid, as do their strings for a lexer over a string, the tokens themselves do not.
+ *
+ * Parameters:
+ * - pLexer: A pointer to the lexer.
+ */
+void ccReleaseTokens(CcLexer* pLexer);
+
+/*
+ * Empty a lexer but keep its storage, so that ccResetLexer can lex another string with it.
+ * The largest window it held is reported, as ccFreeLexer does.
+ *
+ * Parameters:
+ * - pLexer: A pointer to the lexer.
+ */
+void ccClearLexer(CcLexer* pLexer);
+
+/*
+ * Free a lexer.
+ * The largest window it held is reported.
+ *
+ * Parameters:
+ * - pLexer: A pointer to the lexer.
+ */
+void ccFreeLexer(CcLexer* pLexer);
 
 /*
  * Free a token list.
@@ -1,6 +1,7 @@
 #ifndef CECE_MEMORY_H
 #define CECE_MEMORY_H
 
+#include <stddef.h>
 #include <stdint.h>
 #include <stdlib.h>
 
@@ -19,6 +20,19 @@
 #define CC_MIN(first, second) \
 ((first) <= (second) ? (first) : (second))
 
+/*
+ * Get the maximum of two values.
+ *
+ * Parameters:
+ * - first: The first value.
+ * - second: The second value.
+ *
+ * Returns:
+ * The maximum of the two values.
+ */
+#define CC_MAX(first, second) \
+((first) >= (second) ? (first) : (second))
+
 // Maximum size of an object.
 constexpr size_t ccSizeMax = CC_MIN(PTRDIFF_MAX, SIZE_MAX);
 
@@ -86,6 +100,141 @@ typedef int (*CcCompare)(const void* pFirstVoid, const void* pSecondVoid);
  */
 void* ccFind(const void* pValueVoid, const void* arrayVoid, size_t count, size_t size, CcCompare compare);
 
+/*
+ * Hash a buffer.
+ * This is a fast non-cryptographic 64-bit hash (MurmurHash64A), reading the buffer 8 bytes at a time.
+ *
+ * Parameters:
+ * - data: The buffer to hash.
+ * - size: The size of the buffer.
+ * - seed: A seed, hashes with different seeds are independent.
+ *
+ * Returns:
+ * The hash of the buffer.
+ */
+uint64_t ccHash(const void* data, size_t size, uint64_t seed);
+
+/*
+ * Counters of the memory allocated by a thread through ccMalloc, ccRealloc and ccFree.
+ *
+ * Fields:
+ * - allocationCount: The number of allocations.
+ * - reallocationCount: The number of reallocations.
+ * - requestedBytes: The number of bytes requested by allocations.
+ * - reallocatedBytes: The number of bytes requested by reallocations.
+ * - liveBytes: The number of bytes currently allocated.
+ * - peakBytes: The highest number of bytes allocated at once since the peak was last reset.
+ */
+typedef struct CcMemoryStatistics
+{
+	size_t allocationCount;
+	size_t reallocationCount;
+
+	size_t requestedBytes;
+	size_t reallocatedBytes;
+
+	size_t liveBytes;
+	size_t peakBytes;
+} CcMemoryStatistics;
+
+/*
+ * Get the memory counters of the calling thread.
+ *
+ * Returns:
+ * A pointer to the counters.
+ */
+CcMemoryStatistics* ccGetMemoryStatistics(void);
+
+/*
+ * Allocate memory and count the allocation.
+ *
+ * Parameters:
+ * - size: The size of the allocation, greater than 0.
+ *
+ * Returns:
+ * - A pointer to the allocated memory, to be freed with ccFree.
+ * - nullptr if memory allocation fails.
+ */
+void* ccMalloc(size_t size);
+
+/*
+ * Reallocate memory and count the reallocation.
+ *
+ * Parameters:
+ * - pointer: A pointer allocated by ccMalloc or ccRealloc, or nullptr.
+ * - oldSize: The size pointer was allocated with, 0 if it is nullptr.
+ * - newSize: The new size of the allocation, greater than 0.
+ *
+ * Returns:
+ * - A pointer to the reallocated memory, to be freed with ccFree.
+ * - nullptr if memory allocation fails, in which case pointer is left untouched.
+ */
+void* ccRealloc(void* pointer, size_t oldSize, size_t newSize);
+
+/*
+ * Free memory allocated by ccMalloc or ccRealloc.
+ *
+ * Parameters:
+ * - pointer: A pointer allocated by ccMalloc or ccRealloc, or nullptr.
+ * - size: The size pointer was allocated with.
+ */
+void ccFree(void* pointer, size_t size);
+
+/*
+ * A block of memory of an arena.
+ */
+typedef struct CcArenaBlock CcArenaBlock;
+
+/*
+ * An arena allocator.
+ * Allocations are carved out of large blocks and all released at once, which suits the many small objects living as long as a compilation.
+ * An arena initialized with {} is valid and empty.
+ *
+ * Fields:
+ * - pBlock: The block allocations are currently made from, linked to the previous blocks.
+ * - used: The number of bytes used in the current block.
+ * - pSpare: The blocks kept by ccResetArena, which later allocations fill before allocating new ones.
+ */
+typedef struct CcArena
+{
+	CcArenaBlock* pBlock;
+	size_t used;
+
+	CcArenaBlock* pSpare;
+} CcArena;
+
+/*
+ * Allocate memory from an arena.
+ *
+ * Parameters:
+ * - pArena: A pointer to the arena.
+ * - size: The size of the allocation.
+ * - alignment: The alignment of the allocation, a power of two not greater than alignof(max_align_t).
+ *
+ * Returns:
+ * - A pointer to the allocated memory, valid until the arena is freed.
+ * - nullptr if memory allocation fails.
+ */
+void* ccArenaAllocate(CcArena* pArena, size_t size, size_t alignment);
+
+/*
+ * Release all the allocations of an arena but keep its blocks, so that filling it again does not allocate.
+ * Blocks dedicated to a single large allocation are freed.
+ *
+ * Parameters:
+ * - pArena: A pointer to the arena.
+ */
+void ccResetArena(CcArena* pArena);
+
+/*
+ * Free all the memory of an arena.
+ * The arena is left empty and can be used again.
+ *
+ * Parameters:
+ * - pArena: A pointer to the arena.
+ */
+void ccFreeArena(CcArena* pArena);
+
 #define ccFind(pValueVoid, arrayVoid, count, size, compare) _Generic( \
 	true ? (arrayVoid) : (void*)nullptr, \
 	const void*: (const void*)ccFind((pValueVoid), (arrayVoid), (count), (size), (compare)), \
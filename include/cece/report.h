@@ -0,0 +1,249 @@
+#ifndef CECE_REPORT_H
+#define CECE_REPORT_H
+
+#include <stddef.h>
+#include <stdio.h>
+
+#include "cece/memory.h"
+
+/*
+ * The phases of a compilation, with the name they are reported under.
+ */
+#define CC_PHASE(F) \
+	F(READ, "read") \
+	F(LEX, "lex") \
+	F(PARSE, "parse")
+
+#define CC_PHASE_ENUM(name, string) \
+	CC_PHASE_##name,
+
+/*
+ * A compilation phase.
+ */
+typedef enum CcPhase
+{
+	CC_PHASE(CC_PHASE_ENUM)
+	CC_PHASE_COUNT
+} CcPhase;
+
+/*
+ * Get the name of a compilation phase.
+ *
+ * Parameters:
+ * - phase: A compilation phase.
+ *
+ * Returns:
+ * The name of the phase.
+ */
+const char* ccPhaseString(CcPhase phase);
+
+/*
+ * The buffers whose usage is reported, with the name they are reported under.
+ */
+#define CC_BUFFER(F) \
+	F(TOKENS, "tokens") \
+	F(SYMBOLS, "symbols") \
+	F(NODES, "nodes") \
+	F(CHILDREN, "children")
+
+#define CC_BUFFER_ENUM(name, string) \
+	CC_BUFFER_##name,
+
+/*
+ * A buffer whose usage is reported.
+ */
+typedef enum CcBuffer
+{
+	CC_BUFFER(CC_BUFFER_ENUM)
+	CC_BUFFER_COUNT
+} CcBuffer;
+
+/*
+ * Get the name of a buffer.
+ *
+ * Parameters:
+ * - buffer: A buffer.
+ *
+ * Returns:
+ * The name of the buffer.
+ */
+const char* ccBufferString(CcBuffer buffer);
+
+/*
+ * The measurements of a compilation phase.
+ *
+ * Fields:
+ * - count: The number of times the phase ran.
+ * - wallTime: The monotonic wall time spent in the phase, summed over the threads running it, in seconds.
+ * - cpuTime: The CPU time spent in the phase by the threads running it, in seconds.
+ * - allocationCount: The number of allocations made by the phase.
+ * - reallocationCount: The number of reallocations made by the phase.
+ * - requestedBytes: The number of bytes requested by the allocations of the phase.
+ * - reallocatedBytes: The number of bytes requested by the reallocations of the phase.
+ * - peakBytes: The highest number of bytes allocated at once by a thread while running the phase.
+ */
+typedef struct CcPhaseReport
+{
+	size_t count;
+
+	double wallTime;
+	double cpuTime;
+
+	size_t allocationCount;
+	size_t reallocationCount;
+	size_t requestedBytes;
+	size_t reallocatedBytes;
+	size_t peakBytes;
+} CcPhaseReport;
+
+/*
+ * The usage of a buffer.
+ *
+ * Fields:
+ * - used: The number of entries used.
+ * - reserved: The number of entries allocated.
+ */
+typedef struct CcBufferReport
+{
+	size_t used;
+	size_t reserved;
+} CcBufferReport;
+
+/*
+ * The measurements of all compilation phases.
+ *
+ * Fields:
+ * - elapsedTime: The monotonic wall time the whole compilation took, in seconds.
+ * - phases: The measurements of each phase.
+ * - buffers: The usage of each buffer, summed over all files.
+ */
+typedef struct CcReport
+{
+	double elapsedTime;
+
+	CcPhaseReport phases[CC_PHASE_COUNT];
+	CcBufferReport buffers[CC_BUFFER_COUNT];
+} CcReport;
+
+/*
+ * A running measurement of a compilation phase.
+ *
+ * Fields:
+ * - phase: The phase being measured.
+ * - wallTime: The wall time the phase started at.
+ * - cpuTime: The CPU time the phase started at.
+ * - memory: The memory counters of the thread when the phase started.
+ */
+typedef struct CcPhaseTimer
+{
+	CcPhase phase;
+
+	double wallTime;
+	double cpuTime;
+
+	CcMemoryStatistics memory;
+} CcPhaseTimer;
+
+/*
+ * Get the monotonic wall time.
+ *
+ * Returns:
+ * The wall time in seconds, from an arbitrary origin.
+ */
+double ccGetWallTime(void);
+
+/*
+ * Set the report phases of the calling thread are measured into.
+ * Each thread starts without a report, in which case phases are not measured.
+ *
+ * Parameters:
+ * - pReport: A pointer to the report, or nullptr to stop measuring.
+ */
+void ccSetReport(CcReport* pReport);
+
+/*
+ * Get the report phases of the calling thread are measured into.
+ *
+ * Returns:
+ * A pointer to the report, nullptr if phases are not measured.
+ */
+CcReport* ccGetReport(void);
+
+/*
+ * Start measuring a phase.
+ *
+ * Parameters:
+ * - phase: The phase.
+ * - pTimer: A pointer to the timer of the phase.
+ */
+void ccBeginPhase(CcPhase phase, CcPhaseTimer* pTimer);
+
+/*
+ * Stop measuring a phase and add the measurements to the report of the calling thread.
+ *
+ * Parameters:
+ * - pTimer: A pointer to the timer started by ccBeginPhase.
+ */
+void ccEndPhase(const CcPhaseTimer* pTimer);
+
+/*
+ * Stop measuring a phase and start measuring another, as ccEndPhase followed by ccBeginPhase but reading the clocks once.
+ * Phases switching often, such as lexing and parsing each function, take half the time to measure.
+ *
+ * Parameters:
+ * - phase: The phase to start.
+ * - pTimer: A pointer to the timer started by ccBeginPhase, which measures the new phase afterwards.
+ */
+void ccSwitchPhase(CcPhase phase, CcPhaseTimer* pTimer);
+
+/*
+ * Add the usage of a buffer to the report of the calling thread, if any.
+ * Buffers are reported when they reach their largest size, before they are shrunk.
+ *
+ * Parameters:
+ * - buffer: The buffer.
+ * - used: The number of entries used.
+ * - reserved: The number of entries allocated.
+ */
+void ccReportBuffer(CcBuffer buffer, size_t used, size_t reserved);
+
+/*
+ * Add the measurements of a report to another.
+ * Reports measured at the same time overlap, so the elapsed time is the longest of both.
+ *
+ * Parameters:
+ * - pReport: A pointer to the report to add to.
+ * - pOther: A pointer to the report to add.
+ */
+void ccMergeReport(CcReport* pReport, const CcReport* pOther);
+
+/*
+ * Print the time report as a table.
+ * The total wall time is the elapsed time, the CPU times and the wall times of phases are summed over threads, so with several threads they may exceed it.
+ *
+ * Parameters:
+ * - pReport: A pointer to the report.
+ * - file: The stream to print to.
+ */
+void ccPrintTimeReport(const CcReport* pReport, FILE* file);
+
+/*
+ * Print the memory report as tables.
+ * Memory mapped source files are not allocated memory and do not show.
+ *
+ * Parameters:
+ * - pReport: A pointer to the report.
+ * - file: The stream to print to.
+ */
+void ccPrintMemoryReport(const CcReport* pReport, FILE* file);
+
+/*
+ * Write the time report as JSON.
+ *
+ * Parameters:
+ * - pReport: A pointer to the report.
+ * - file: The stream to write to.
+ */
+void ccWriteTimeReportJson(const CcReport* pReport, FILE* file);
+
+#endif
@@ -0,0 +1,69 @@
+#ifndef CECE_SCAN_H
+#define CECE_SCAN_H
+
+#include <stddef.h>
+
+/*
+ * An instruction set the scanning functions can use.
+ */
+typedef enum CcScanLevel
+{
+	CC_SCAN_LEVEL_SCALAR,
+	CC_SCAN_LEVEL_SSE2,
+	CC_SCAN_LEVEL_AVX2,
+	CC_SCAN_LEVEL_COUNT
+} CcScanLevel;
+
+/*
+ * The implementations of the scanning functions for an instruction set.
+ *
+ * Fields:
+ * - scanSpaces: Implementation of ccScanSpaces.
+ * - scanIdentifier: Implementation of ccScanIdentifier.
+ */
+typedef struct CcScanKernels
+{
+	size_t (*scanSpaces)(const char* string);
+	size_t (*scanIdentifier)(const char* string);
+} CcScanKernels;
+
+/*
+ * Get the implementations of the scanning functions for an instruction set.
+ *
+ * Parameters:
+ * - level: The instruction set.
+ * - pKernels: A pointer to the implementations.
+ *
+ * Returns:
+ * - true if the instruction set is supported by the compiler and the processor.
+ * - false otherwise.
+ */
+bool ccGetScanKernels(CcScanLevel level, CcScanKernels* pKernels);
+
+/*
+ * Count the white space characters at the start of a string.
+ * White space is that of the C locale: ' ', '\t', '\n', '\v', '\f' and '\r'.
+ * The fastest instruction set supported by the processor is selected on first use.
+ *
+ * Parameters:
+ * - string: A null-terminated string.
+ *
+ * Returns:
+ * The number of white space characters at the start of the string.
+ */
+size_t ccScanSpaces(const char* string);
+
+/*
+ * Count the identifier characters at the start of a string.
+ * Identifier characters are ASCII letters, digits and '_'.
+ * The fastest instruction set supported by the processor is selected on first use.
+ *
+ * Parameters:
+ * - string: A null-terminated string.
+ *
+ * Returns:
+ * The number of identifier characters at the start of the string.
+ */
+size_t ccScanIdentifier(const char* string);
+
+#endif
@@ -0,0 +1,51 @@
+#ifndef CECE_SERVER_H
+#define CECE_SERVER_H
+
+#include <stddef.h>
+
+#include "cece/result.h"
+
+/*
+ * Run a compile server listening on a local socket.
+ * Clients are served concurrently by a pool of workers, each keeping the storage of its compilations from one request to the next.
+ * A client has a few seconds to send its request and to take each part of the response, after which it is dropped.
+ * The paths of a request are resolved from the directory of its client, so diagnostics name files by their resolved path.
+ * It runs until it receives SIGINT or SIGTERM, or until ccStopServer is called, then finishes the requests it accepted.
+ * Only one server can run in a process at once. Only supported on POSIX systems.
+ *
+ * Parameters:
+ * - path: The path of the socket. A stale socket at this path is replaced.
+ * - workerCount: The number of requests served at once, 0 for the number of processors.
+ *
+ * Returns:
+ * - CC_SUCCESS when the server is stopped.
+ * - CC_ERROR_INVALID_ARGUMENT if the path is too long or already used by something else than a socket.
+ * - CC_ERROR_OUT_OF_MEMORY if the workers could not be allocated.
+ * - CC_ERROR_UNKNOWN if the socket or the workers could not be created.
+ */
+CcResult ccRunServer(const char* path, size_t workerCount);
+
+/*
+ * Ask the compile server of the process to stop, as SIGINT and SIGTERM do.
+ * It can be called from any thread, and from a signal handler. Nothing is done if no server runs.
+ */
+void ccStopServer(void);
+
+/*
+ * Have a compile server run a command line and forward its output and diagnostics.
+ * The output is written to stdout, the diagnostics to the diagnostic stream of the calling thread.
+ * Relative paths are resolved from the current directory of the client.
+ *
+ * Parameters:
+ * - path: The path of the socket of the server.
+ * - argumentCount: The number of arguments.
+ * - arguments: The arguments, as they would be passed to cece.
+ *
+ * Returns:
+ * - The result of the command line on the server.
+ * - CC_ERROR_FILE_NOT_FOUND if the server could not be reached.
+ * - CC_ERROR_UNKNOWN if the connection failed.
+ */
+CcResult ccRunClient(const char* path, size_t argumentCount, const char* const* arguments);
+
+#endif
@@ -0,0 +1,141 @@
+#ifndef CECE_SYMBOL_H
+#define CECE_SYMBOL_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "cece/memory.h"
+#include "cece/result.h"
+
+/*
+ * An interned name.
+ *
+ * Fields:
+ * - name: The characters of the name, owned by the symbol table and not null-terminated.
+ * - length: The length of the name.
+ * - hash: The hash of the name.
+ */
+typedef struct CcSymbol
+{
+	const char* name;
+	uint32_t length;
+	uint32_t hash;
+} CcSymbol;
+
+/*
+ * A table interning names into dense 32-bit symbols.
+ * Each distinct name gets the next symbol, starting at 0, so that comparing names becomes comparing integers.
+ * Names are copied into an arena and found through an open-addressing hash table with linear probing.
+ * A table initialized with {} is valid and empty.
+ *
+ * Fields:
+ * - slots: The hash table, each slot holding a symbol + 1, or 0 if it is empty.
+ * - slotCount: The number of slots, 0 or a power of two.
+ * - symbols: The symbols, indexed by symbol.
+ * - count: The number of symbols.
+ * - capacity: The number of symbols allocated.
+ * - names: The arena holding the characters of the names.
+ * - lookupCount: The number of names interned, including the ones already in the table.
+ * - probeCount: The number of slots inspected by these lookups.
+ * - maximumProbeLength: The highest number of slots inspected by a single lookup.
+ */
+typedef struct CcSymbolTable
+{
+	uint32_t* slots;
+	size_t slotCount;
+
+	CcSymbol* symbols;
+	size_t count;
+	size_t capacity;
+
+	CcArena names;
+
+	size_t lookupCount;
+	size_t probeCount;
+	size_t maximumProbeLength;
+} CcSymbolTable;
+
+/*
+ * Statistics of a symbol table.
+ *
+ * Fields:
+ * - symbolCount: The number of symbols.
+ * - slotCount: The number of slots of the hash table.
+ * - loadFactor: The fraction of slots in use.
+ * - lookupCount: The number of names interned, including the ones already in the table.
+ * - averageProbeLength: The average number of slots inspected per lookup, 0 without lookups.
+ * - maximumProbeLength: The highest number of slots inspected by a single lookup.
+ */
+typedef struct CcSymbolStatistics
+{
+	size_t symbolCount;
+	size_t slotCount;
+	double loadFactor;
+
+	size_t lookupCount;
+	double averageProbeLength;
+	size_t maximumProbeLength;
+} CcSymbolStatistics;
+
+/*
+ * Intern a name.
+ *
+ * Parameters:
+ * - pTable: A pointer to a symbol table.
+ * - name: The characters of the name, copied if the name is new.
+ * - length: The length of the name.
+ * - pSymbol: A pointer to store the symbol of the name.
+ *
+ * Returns:
+ * - CC_SUCCESS if the name is interned.
+ * - CC_ERROR_INVALID_ARGUMENT if the name is longer than UINT32_MAX or the table already holds UINT32_MAX symbols.
+ * - CC_ERROR_OUT_OF_MEMORY if memory allocation fails, in which case the table is left untouched.
+ */
+CcResult ccInternSymbol(CcSymbolTable* pTable, const char* name, size_t length, uint32_t* pSymbol);
+
+/*
+ * Find the symbol of a name without interning it.
+ * Lookups made by this function are not counted in the statistics.
+ *
+ * Parameters:
+ * - pTable: A pointer to a symbol table.
+ * - name: The characters of the name.
+ * - length: The length of the name.
+ * - pSymbol: A pointer to store the symbol of the name.
+ *
+ * Returns:
+ * - true if the name is in the table.
+ * - false otherwise.
+ */
+bool ccFindSymbol(const CcSymbolTable* pTable, const char* name, size_t length, uint32_t* pSymbol);
+
+/*
+ * Get the statistics of a symbol table.
+ *
+ * Parameters:
+ * - pTable: A pointer to a symbol table.
+ *
+ * Returns:
+ * The statistics of the table.
+ */
+CcSymbolStatistics ccGetSymbolStatistics(const CcSymbolTable* pTable);
+
+/*
+ * Remove all the symbols of a symbol table but keep its storage, so that interning names again does not allocate until it outgrows it.
+ * Its statistics start over.
+ *
+ * Parameters:
+ * - pTable: A pointer to a symbol table.
+ */
+void ccClearSymbolTable(CcSymbolTable* pTable);
+
+/*
+ * Free a symbol table.
+ * The table is left empty and can be used again.
+ *
+ * Parameters:
+ * - pTable: A pointer to a symbol table.
+ */
+void ccFreeSymbolTable(CcSymbolTable* pTable);
+
+#endif
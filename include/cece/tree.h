@@ -2,11 +2,12 @@
 #define CECE_TREE_H
 
 #include <stddef.h>
+#include <stdint.h>
 
 #include "cece/lex.h"
 #include "cece/result.h"
 
-typedef enum CcNodeType
+typedef enum CcNodeType: uint8_t
 {
 	CC_NODE_PROGRAM,
 	CC_NODE_FUNCTION,
@@ -15,27 +16,41 @@ typedef enum CcNodeType
 	CC_NODE_CONSTANT
 } CcNodeType;
 
-typedef struct CcNode CcNode;
-
+/*
+ * The payload of a program node.
+ *
+ * Fields:
+ * - childrenStart: The index of the first function in the children, which are stored backward from it.
+ * - childrenCount: The number of functions.
+ */
 typedef struct CcProgramNode
 {
-	size_t childrenStart;
-	size_t childrenCount;
+	uint32_t childrenStart;
+	uint32_t childrenCount;
 } CcProgramNode;
 
+/*
+ * The payload of a function node.
+ *
+ * Fields:
+ * - symbol: The symbol of the name of the function in the symbol table of the tree.
+ * - statementsStart: The index of the first statement in the children, which are stored backward from it.
+ * - statementsCount: The number of statements.
+ */
 typedef struct CcFunctionNode
 {
-	CcStringView name;
+	uint32_t symbol;
 
-	size_t statementsStart;
-	size_t statementsCount;
+	uint32_t statementsStart;
+	uint32_t statementsCount;
 } CcFunctionNode;
 
-typedef size_t CcReturnNode;
+// The index of the node of the returned expression, UINT32_MAX if there is none.
+typedef uint32_t CcReturnNode;
 
 typedef CcConstant CcConstantNode;
 
-typedef enum CcBinOp
+typedef enum CcBinOp: uint8_t
 {
 	CC_BIN_OP_SUM,
 	CC_BIN_OP_DIF,
@@ -57,14 +72,30 @@ typedef enum CcBinOp
 	CC_BIN_OP_LOR
 } CcBinOp;
 
+/*
+ * The payload of a binary operator node.
+ *
+ * Fields:
+ * - op: The operator.
+ * - leftNode: The index of the node of the left operand.
+ * - rightNode: The index of the node of the right operand.
+ */
 typedef struct CcBinOpNode
 {
 	CcBinOp op;
 
-	size_t leftNode;
-	size_t rightNode;
+	uint32_t leftNode;
+	uint32_t rightNode;
 } CcBinOpNode;
 
+/*
+ * A node of a tree with its payload, as read from the tree.
+ * Trees do not store nodes this way.
+ *
+ * Fields:
+ * - type: The type of the node.
+ * - program, function, returnNode, binOpNode, constant: The payload, depending on the type.
+ */
 typedef struct CcNode
 {
 	CcNodeType type;
@@ -81,17 +112,59 @@ typedef struct CcNode
 
 /*
  * An abstract syntax tree.
+ * Nodes are stored as a structure of arrays: an array of types, which is all that traversals looking at the kinds of nodes read,
+ * and an array of 32-bit payloads, indexing the array of the payloads of their kind.
+ * Node indices fit 32 bits since there are at most as many nodes as tokens.
+ * Trees built by the parser keep the payloads and types in one block, starting with the payloads, so that both always have the same capacity.
  *
  * Fields:
- * - nodes: The nodes of the tree.
- * - children: Children nodes.
+ * - types: The type of each node.
+ * - payloads: The payload of each node, the index of the returned node for returns, the index in the payloads of its type otherwise.
  * - count: Number of nodes.
+ * - nodeCapacity: Number of nodes allocated.
+ * - constants: The payloads of constant nodes.
+ * - constantCount: The number of constant payloads.
+ * - constantCapacity: The number of constant payloads allocated.
+ * - binOps: The payloads of binary operator nodes.
+ * - binOpCount: The number of binary operator payloads.
+ * - binOpCapacity: The number of binary operator payloads allocated.
+ * - functions: The payloads of function nodes.
+ * - functionCount: The number of function payloads.
+ * - functionCapacity: The number of function payloads allocated.
+ * - programs: The payloads of program nodes.
+ * - programCount: The number of program payloads.
+ * - programCapacity: The number of program payloads allocated.
+ * - children: Children nodes.
+ * - childCapacity: Number of children allocated.
+ * - symbols: The names of the functions, which the tree owns so that they outlive its tokens.
  */
 typedef struct CcTree
 {
-	CcNode* nodes;
-	size_t* children;
+	uint8_t* types;
+	uint32_t* payloads;
 	size_t count;
+	size_t nodeCapacity;
+
+	CcConstantNode* constants;
+	size_t constantCount;
+	size_t constantCapacity;
+
+	CcBinOpNode* binOps;
+	size_t binOpCount;
+	size_t binOpCapacity;
+
+	CcFunctionNode* functions;
+	size_t functionCount;
+	size_t functionCapacity;
+
+	CcProgramNode* programs;
+	size_t programCount;
+	size_t programCapacity;
+
+	uint32_t* children;
+	size_t childCapacity;
+
+	CcSymbolTable symbols;
 } CcTree;
 
 /*
@@ -99,9 +172,10 @@ typedef struct CcTree
  *
  * Fields:
  * - pTree: A pointer to the tree to build.
- * - pTokenList: A pointer to the token list to parse.
- * - indexCount: The number of indices in the tree's indices buffer.
- * - lastIndex: The last index stored at the end of the indices buffer.
+ * - tokens: A pointer to the range of tokens to parse.
+ * - childCount: The number of children committed at the start of the tree's children buffer.
+ * - lastIndex: The index of the first child stored at the end of the children buffer, not committed yet.
+ * - keepStorage: Whether the tree held storage before parsing, which it then keeps rather than being shrunk to its content or freed on failure.
  */
 typedef struct CcTreeBuilder
 {
@@ -110,6 +184,8 @@ typedef struct CcTreeBuilder
 
 	size_t childCount;
 	size_t lastIndex;
+
+	bool keepStorage;
 } CcTreeBuilder;
 
 typedef enum CcDirection
@@ -120,6 +196,27 @@ typedef enum CcDirection
 
 bool ccSkipParentheses(size_t* pTokenIndex, const CcConstTokenList* tokens, CcDirection direction);
 
+/*
+ * Get a node of a tree with its payload.
+ *
+ * Parameters:
+ * - pTree: A pointer to the tree.
+ * - nodeIndex: The index of the node.
+ *
+ * Returns:
+ * The node.
+ */
+CcNode ccGetNode(const CcTree* pTree, size_t nodeIndex);
+
+/*
+ * Set the highest number of parentheses an expression can nest on the calling thread.
+ * Expressions are parsed without recursion, so the limit only bounds the memory of deeply nested ones.
+ *
+ * Parameters:
+ * - limit: The highest number of nested parentheses, 0 for the default of 65536.
+ */
+void ccSetNestingLimit(size_t limit);
+
 bool ccParseExpression(CcTreeBuilder* pBuilder);
 
 bool ccParseStatement(CcTreeBuilder* pBuilder);
@@ -128,8 +225,45 @@ bool ccParseFunction(CcTreeBuilder* pBuilder);
 
 bool ccParseProgram(CcTreeBuilder* pBuilder);
 
+/*
+ * Parse a range of tokens into a tree.
+ *
+ * Parameters:
+ * - tokens: A pointer to the range of tokens, whose brackets are matched.
+ * - pTree: A pointer to a tree initialized with {}, freed on failure and shrunk to its content otherwise, or a tree emptied by ccClearTree, whose storage is reused and kept as it is.
+ *
+ * Returns:
+ * - CC_SUCCESS if the tokens are parsed.
+ * - CC_ERROR_INVALID_ARGUMENT if the tokens do not form a program.
+ * - CC_ERROR_OUT_OF_MEMORY if memory allocation fails.
+ */
 CcResult ccParse(const CcConstTokenList* tokens, CcTree* pTree);
 
+/*
+ * Parse the tokens of a lexer into a tree, pulling them one top-level function at a time.
+ * The tokens of each function are released once it is parsed, so that only the tokens of one function are held at once.
+ * The tree is the one ccParse builds from the tokens of the whole string, diagnostics of lexing are written once parsing is over.
+ * Pulling the tokens of each function is measured as the lex phase and parsing them as the parse phase.
+ *
+ * Parameters:
+ * - pLexer: A pointer to a lexer, left finished on success.
+ * - pTree: A pointer to a tree initialized with {}, freed on failure and shrunk to its content otherwise, or a tree emptied by ccClearTree, whose storage is reused and kept as it is.
+ *
+ * Returns:
+ * - CC_SUCCESS if the tokens are parsed.
+ * - CC_ERROR_INVALID_ARGUMENT if the tokens do not form a program or there are too many identifiers.
+ * - CC_ERROR_OUT_OF_MEMORY if memory allocation fails.
+ */
+CcResult ccParseLexer(CcLexer* pLexer, CcTree* pTree);
+
+/*
+ * Empty a tree but keep its storage, so that parsing into it again does not allocate until it outgrows what it held before.
+ *
+ * Parameters:
+ * - pTree: A pointer to the tree.
+ */
+void ccClearTree(CcTree* pTree);
+
 void ccFreeTree(CcTree* pTree);
 
 #endif
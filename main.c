@@ -20,6 +20,33 @@ int main(int argumentCount, char** arguments)
 	--argumentCount;
 	++arguments;
 
+	// Server and client modes take over the whole command line.
+	if(strcmp(arguments[0], "--server") == 0)
+	{
+		if(argumentCount != 2)
+		{
+			fputs("Usage: cece --server <socket>\n", stderr);
+			result = CC_ERROR_INVALID_ARGUMENT;
+			goto end;
+		}
+
+		result = ccRunServer(arguments[1], 0);
+		goto end;
+	}
+
+	if(strcmp(arguments[0], "--client") == 0)
+	{
+		if(argumentCount < 2)
+		{
+			fputs("Usage: cece --client <socket> [options] <file-to-compile>...\n", stderr);
+			result = CC_ERROR_INVALID_ARGUMENT;
+			goto end;
+		}
+
+		result = ccRunClient(arguments[1], argumentCount - 2, (const char* const*)arguments + 2);
+		goto end;
+	}
+
 	constexpr size_t limit = ccSizeMax / sizeof(arguments[0]);
 
 #if INT_MAX <= SIZE_MAX
@@ -60,10 +87,9 @@ int main(int argumentCount, char** arguments)
 		goto end;
 	}
 
-	// Compile file.
+	// Compile files.
 	result = ccCompile(&options);
-	free(options.input);
-	free(options.output);
+	ccFreeOptions(&options);
 
 	end:
 	return result == CC_SUCCESS ? EXIT_SUCCESS : EXIT_FAILURE;
@@ -1,12 +1,95 @@
 #include "cece/arguments.h"
 
 #include <assert.h>
-#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
+#include "cece/diagnostic.h"
 #include "cece/memory.h"
 
+/*
+ * Parse a strictly positive decimal count.
+ *
+ * Parameters:
+ * - string: The string to parse.
+ * - pCount: A pointer to the count.
+ *
+ * Returns:
+ * - true if the string is a valid count.
+ * - false otherwise.
+ */
+static bool ccParseCount(const char* string, size_t* const pCount)
+{
+	assert(string != nullptr);
+	assert(pCount != nullptr);
+
+	if(*string == '\0')
+	{
+		return false;
+	}
+
+	size_t count = 0;
+	for(; *string != '\0'; ++string)
+	{
+		if(*string < '0' || *string > '9')
+		{
+			return false;
+		}
+
+		const size_t digit = (size_t)(*string - '0');
+		if(count > (SIZE_MAX - digit) / 10)
+		{
+			return false;
+		}
+
+		count = count * 10 + digit;
+	}
+
+	if(count == 0)
+	{
+		return false;
+	}
+
+	*pCount = count;
+
+	return true;
+}
+
+/*
+ * Get the default output path of an input: the input path with its extension replaced by ".s".
+ *
+ * Parameters:
+ * - input: The input path.
+ *
+ * Returns:
+ * - The output path, to be freed by the caller.
+ * - nullptr if memory allocation fails.
+ */
+static char* ccDefaultOutput(const char* const input)
+{
+	assert(input != nullptr);
+
+	const char* const lastDot = strrchr(input, '.');
+	const char* const lastSlash = strrchr(input, '/');
+	const char* const lastBackslash = strrchr(input, '\\');
+
+	const char* const lastSeparator = lastSlash > lastBackslash ? lastSlash : lastBackslash;
+
+	const size_t outputLength = (lastDot > lastSeparator ? (size_t)(lastDot - input) : strlen(input)) + 2;
+	char* const output = malloc(outputLength + 1);
+	if(!output)
+	{
+		return nullptr;
+	}
+
+	strncpy(output, input, outputLength);
+	output[outputLength - 2] = '.';
+	output[outputLength - 1] = 's';
+	output[outputLength] = '\0';
+
+	return output;
+}
+
 CcResult ccParseArguments(const size_t argumentCount, const char* const* const arguments, CcOptions* const pOptions)
 {
 	// Validate arguments.
@@ -21,15 +104,32 @@ CcResult ccParseArguments(const size_t argumentCount, const char* const* const a
 	CcResult result = CC_SUCCESS;
 
 	*pOptions = (CcOptions){
+		.jobCount = 1,
 		.version = CC_C23
 	};
 
+	char* output = nullptr;
+
 	struct
 	{
 		bool version: 1;
 		bool debug: 1;
+		bool jobs: 1;
+		bool nestingLimit: 1;
+		bool diagnosticLimit: 1;
+		bool timeReport: 1;
+		bool memoryReport: 1;
 	} checks = {};
 
+	// There cannot be more inputs than arguments.
+	pOptions->inputs = calloc(argumentCount, sizeof(pOptions->inputs[0]));
+	if(!pOptions->inputs)
+	{
+		ccDiagnose("Failed to allocate memory.");
+		result = CC_ERROR_OUT_OF_MEMORY;
+		goto clear;
+	}
+
 	for(size_t argumentIndex = 0; argumentIndex < argumentCount; ++argumentIndex)
 	{
 		if(strcmp(arguments[argumentIndex], "-h") == 0)
@@ -41,9 +141,37 @@ CcResult ccParseArguments(const size_t argumentCount, const char* const* const a
 
 		if(strcmp(arguments[argumentIndex], "-o") == 0)
 		{
-			if(pOptions->output)
+			if(output)
+			{
+				ccDiagnose("Multiple outputs specified.");
+				result = CC_ERROR_INVALID_ARGUMENT;
+				goto clear;
+			}
+
+			++argumentIndex;
+			if(argumentIndex == argumentCount)
+			{
+				ccDiagnose("Missing argument for -o.");
+				result = CC_ERROR_INVALID_ARGUMENT;
+				goto clear;
+			}
+
+			output = strdup(arguments[argumentIndex]);
+			if(!output)
+			{
+				ccDiagnose("Failed to allocate memory.");
+				result = CC_ERROR_OUT_OF_MEMORY;
+				goto clear;
+			}
+
+			continue;
+		}
+
+		if(strcmp(arguments[argumentIndex], "--cache-dir") == 0)
+		{
+			if(pOptions->cacheDirectory)
 			{
-				fputs("Multiple outputs specified.\n", stderr);
+				ccDiagnose("Multiple cache directories specified.");
 				result = CC_ERROR_INVALID_ARGUMENT;
 				goto clear;
 			}
@@ -51,15 +179,15 @@ CcResult ccParseArguments(const size_t argumentCount, const char* const* const a
 			++argumentIndex;
 			if(argumentIndex == argumentCount)
 			{
-				fputs("Missing argument for -o.\n", stderr);
+				ccDiagnose("Missing argument for --cache-dir.");
 				result = CC_ERROR_INVALID_ARGUMENT;
 				goto clear;
 			}
 
-			pOptions->output = strdup(arguments[argumentIndex]);
-			if(!pOptions->output)
+			pOptions->cacheDirectory = strdup(arguments[argumentIndex]);
+			if(!pOptions->cacheDirectory)
 			{
-				fputs("Failed to allocate memory.\n", stderr);
+				ccDiagnose("Failed to allocate memory.");
 				result = CC_ERROR_OUT_OF_MEMORY;
 				goto clear;
 			}
@@ -71,7 +199,7 @@ CcResult ccParseArguments(const size_t argumentCount, const char* const* const a
 		{
 			if(checks.version)
 			{
-				fputs("Multiple versions specified.\n", stderr);
+				ccDiagnose("Multiple versions specified.");
 				result = CC_ERROR_INVALID_ARGUMENT;
 				goto clear;
 			}
@@ -81,7 +209,7 @@ CcResult ccParseArguments(const size_t argumentCount, const char* const* const a
 			const char* version = arguments[argumentIndex] + 5;
 			if(version[0] != 'c' || version[1] == '\0' || version[2] == '\0' || version[3] != '\0')
 			{
-				fputs("Invalid version.\n", stderr);
+				ccDiagnose("Invalid version.");
 				result = CC_ERROR_INVALID_ARGUMENT;
 				goto clear;
 			}
@@ -110,7 +238,7 @@ CcResult ccParseArguments(const size_t argumentCount, const char* const* const a
 			}
 			else
 			{
-				fputs("Invalid version.\n", stderr);
+				ccDiagnose("Invalid version.");
 				result = CC_ERROR_INVALID_ARGUMENT;
 				goto clear;
 			}
@@ -122,7 +250,7 @@ CcResult ccParseArguments(const size_t argumentCount, const char* const* const a
 		{
 			if(checks.debug)
 			{
-				fputs("Multiple debug specified.", stderr);
+				ccDiagnose("Multiple debug specified.");
 				result = CC_ERROR_INVALID_ARGUMENT;
 				goto clear;
 			}
@@ -134,65 +262,233 @@ CcResult ccParseArguments(const size_t argumentCount, const char* const* const a
 			continue;
 		}
 
-		if(arguments[argumentIndex][0] == '-')
+		if(strcmp(arguments[argumentIndex], "-ftime-report") == 0)
 		{
-			fprintf(stderr, "Unknown option: %s\n", arguments[argumentIndex]);
-			result = CC_ERROR_INVALID_ARGUMENT;
-			goto clear;
+			if(checks.timeReport)
+			{
+				ccDiagnose("Multiple time reports specified.");
+				result = CC_ERROR_INVALID_ARGUMENT;
+				goto clear;
+			}
+
+			checks.timeReport = true;
+
+			pOptions->timeReport = true;
+
+			continue;
+		}
+
+		if(strcmp(arguments[argumentIndex], "-fmem-report") == 0)
+		{
+			if(checks.memoryReport)
+			{
+				ccDiagnose("Multiple memory reports specified.");
+				result = CC_ERROR_INVALID_ARGUMENT;
+				goto clear;
+			}
+
+			checks.memoryReport = true;
+
+			pOptions->memoryReport = true;
+
+			continue;
+		}
+
+		// The JSON time report implies the time report.
+		if(strncmp(arguments[argumentIndex], "-ftime-report-json=", 19) == 0)
+		{
+			if(pOptions->timeReportPath)
+			{
+				ccDiagnose("Multiple time report paths specified.");
+				result = CC_ERROR_INVALID_ARGUMENT;
+				goto clear;
+			}
+
+			const char* const path = arguments[argumentIndex] + 19;
+			if(*path == '\0')
+			{
+				ccDiagnose("Missing path for -ftime-report-json.");
+				result = CC_ERROR_INVALID_ARGUMENT;
+				goto clear;
+			}
+
+			pOptions->timeReportPath = strdup(path);
+			if(!pOptions->timeReportPath)
+			{
+				ccDiagnose("Failed to allocate memory.");
+				result = CC_ERROR_OUT_OF_MEMORY;
+				goto clear;
+			}
+
+			pOptions->timeReport = true;
+
+			continue;
+		}
+
+		if(strncmp(arguments[argumentIndex], "-fbracket-depth=", 16) == 0)
+		{
+			if(checks.nestingLimit)
+			{
+				ccDiagnose("Multiple bracket depths specified.");
+				result = CC_ERROR_INVALID_ARGUMENT;
+				goto clear;
+			}
+
+			checks.nestingLimit = true;
+
+			if(!ccParseCount(arguments[argumentIndex] + 16, &pOptions->nestingLimit))
+			{
+				ccDiagnose("Invalid bracket depth.");
+				result = CC_ERROR_INVALID_ARGUMENT;
+				goto clear;
+			}
+
+			continue;
+		}
+
+		if(strncmp(arguments[argumentIndex], "-fmax-diagnostics=", 18) == 0)
+		{
+			if(checks.diagnosticLimit)
+			{
+				ccDiagnose("Multiple diagnostic limits specified.");
+				result = CC_ERROR_INVALID_ARGUMENT;
+				goto clear;
+			}
+
+			checks.diagnosticLimit = true;
+
+			if(!ccParseCount(arguments[argumentIndex] + 18, &pOptions->diagnosticLimit))
+			{
+				ccDiagnose("Invalid diagnostic limit.");
+				result = CC_ERROR_INVALID_ARGUMENT;
+				goto clear;
+			}
+
+			continue;
+		}
+
+		if(strncmp(arguments[argumentIndex], "-j", 2) == 0)
+		{
+			if(checks.jobs)
+			{
+				ccDiagnose("Multiple job counts specified.");
+				result = CC_ERROR_INVALID_ARGUMENT;
+				goto clear;
+			}
+
+			checks.jobs = true;
+
+			// Accept both "-j N" and "-jN".
+			const char* jobs = arguments[argumentIndex] + 2;
+			if(*jobs == '\0')
+			{
+				++argumentIndex;
+				if(argumentIndex == argumentCount)
+				{
+					ccDiagnose("Missing argument for -j.");
+					result = CC_ERROR_INVALID_ARGUMENT;
+					goto clear;
+				}
+
+				jobs = arguments[argumentIndex];
+			}
+
+			if(!ccParseCount(jobs, &pOptions->jobCount))
+			{
+				ccDiagnose("Invalid job count.");
+				result = CC_ERROR_INVALID_ARGUMENT;
+				goto clear;
+			}
+
+			continue;
 		}
 
-		if(pOptions->input)
+		// A lone "-" is standard input.
+		if(arguments[argumentIndex][0] == '-' && arguments[argumentIndex][1] != '\0')
 		{
-			fputs("Multiple inputs specified.\n", stderr);
+			ccDiagnose("Unknown option: %s", arguments[argumentIndex]);
 			result = CC_ERROR_INVALID_ARGUMENT;
 			goto clear;
 		}
 
-		pOptions->input = strdup(arguments[argumentIndex]);
-		if(!pOptions->input)
+		pOptions->inputs[pOptions->inputCount] = strdup(arguments[argumentIndex]);
+		if(!pOptions->inputs[pOptions->inputCount])
 		{
-			fputs("Failed to allocate memory.\n", stderr);
+			ccDiagnose("Failed to allocate memory.");
 			result = CC_ERROR_OUT_OF_MEMORY;
 			goto clear;
 		}
+		++pOptions->inputCount;
 	}
 
-	if(!pOptions->input)
+	if(pOptions->inputCount == 0)
 	{
-		fputs("No input specified.\n", stderr);
+		ccDiagnose("No input specified.");
 		result = CC_ERROR_INVALID_ARGUMENT;
 		goto clear;
 	}
 
-	if(!pOptions->output)
+	if(output && pOptions->inputCount > 1)
 	{
-		const char* const lastDot = strrchr(pOptions->input, '.');
-		const char* const lastSlash = strrchr(pOptions->input, '/');
-		const char* const lastBackslash = strrchr(pOptions->input, '\\');
+		ccDiagnose("Cannot specify -o with multiple inputs.");
+		result = CC_ERROR_INVALID_ARGUMENT;
+		goto clear;
+	}
 
-		const char* const lastSeparator = lastSlash > lastBackslash ? lastSlash : lastBackslash;
+	pOptions->outputs = calloc(pOptions->inputCount, sizeof(pOptions->outputs[0]));
+	if(!pOptions->outputs)
+	{
+		ccDiagnose("Failed to allocate memory.");
+		result = CC_ERROR_OUT_OF_MEMORY;
+		goto clear;
+	}
 
-		const size_t outputLength = (lastDot > lastSeparator ? (size_t)(lastDot - pOptions->input) : strlen(pOptions->input)) + 2;
-		pOptions->output = malloc(outputLength + 1);
-		if(!pOptions->output)
+	if(output)
+	{
+		pOptions->outputs[0] = output;
+		output = nullptr;
+	}
+	else
+	{
+		for(size_t inputIndex = 0; inputIndex < pOptions->inputCount; ++inputIndex)
 		{
-			fputs("Failed to allocate memory.\n", stderr);
-			result = CC_ERROR_OUT_OF_MEMORY;
-			goto clear;
+			pOptions->outputs[inputIndex] = ccDefaultOutput(pOptions->inputs[inputIndex]);
+			if(!pOptions->outputs[inputIndex])
+			{
+				ccDiagnose("Failed to allocate memory.");
+				result = CC_ERROR_OUT_OF_MEMORY;
+				goto clear;
+			}
 		}
-
-		strncpy(pOptions->output, pOptions->input, outputLength);
-		pOptions->output[outputLength - 2] = '.';
-		pOptions->output[outputLength - 1] = 's';
-		pOptions->output[outputLength] = '\0';
 	}
 
 	goto end;
 
 	clear:
-	CC_FREE(pOptions->input);
-	CC_FREE(pOptions->output);
+	ccFreeOptions(pOptions);
+	CC_FREE(output);
 
 	end:
 	return result;
 }
+
+void ccFreeOptions(CcOptions* const pOptions)
+{
+	assert(pOptions != nullptr);
+
+	for(size_t inputIndex = 0; inputIndex < pOptions->inputCount; ++inputIndex)
+	{
+		free(pOptions->inputs[inputIndex]);
+		if(pOptions->outputs)
+		{
+			free(pOptions->outputs[inputIndex]);
+		}
+	}
+
+	CC_FREE(pOptions->inputs);
+	CC_FREE(pOptions->outputs);
+	pOptions->inputCount = 0;
+
+	CC_FREE(pOptions->cacheDirectory);
+	CC_FREE(pOptions->timeReportPath);
+}
@@ -0,0 +1,229 @@
+#include "cece/cache.h"
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#ifdef _WIN32
+#include <direct.h>
+#else
+#include <sys/stat.h>
+#endif
+
+#include "cece/cece.h"
+
+// Seeds of the two hashes of a key.
+static constexpr uint64_t ccCacheSeeds[2] = {0x9E3779B97F4A7C15, 0xD6E8FEB86659FD93};
+
+// Number of attempts at creating a temporary entry with a unique name.
+static constexpr unsigned int ccTemporaryAttempts = 16;
+
+// Counter making temporary entry names unique within a thread.
+static thread_local unsigned int ccTemporaryCounter = 0;
+
+CcCacheKey ccCacheKey(const CcConstString source, const CcOptions* const pOptions)
+{
+	assert(source.string != nullptr);
+	assert(pOptions != nullptr);
+
+	// Only the options that change the output are part of the key.
+	const long long version = pOptions->version;
+	const unsigned char debug = pOptions->debug;
+	const uint64_t nestingLimit = pOptions->nestingLimit;
+
+	CcCacheKey key;
+	for(size_t hashIndex = 0; hashIndex < CC_LEN(key.hashes); ++hashIndex)
+	{
+		uint64_t hash = ccHash(source.string, source.length, ccCacheSeeds[hashIndex]);
+		hash = ccHash(&version, sizeof(version), hash);
+		hash = ccHash(&debug, sizeof(debug), hash);
+		hash = ccHash(&nestingLimit, sizeof(nestingLimit), hash);
+		hash = ccHash(CC_VERSION, sizeof(CC_VERSION) - 1, hash);
+
+		key.hashes[hashIndex] = hash;
+	}
+
+	return key;
+}
+
+/*
+ * Build the path of a cache entry.
+ *
+ * Parameters:
+ * - directory: The cache directory.
+ * - pKey: A pointer to the key of the entry.
+ * - suffix: The suffix of the entry.
+ *
+ * Returns:
+ * - The path, to be freed by the caller.
+ * - nullptr if memory allocation fails.
+ */
+static char* ccCachePath(const char* const directory, const CcCacheKey* const pKey, const char* const suffix)
+{
+	const char* const format = "%s/%016llx%016llx%s";
+	const unsigned long long first = pKey->hashes[0];
+	const unsigned long long second = pKey->hashes[1];
+
+	const int length = snprintf(nullptr, 0, format, directory, first, second, suffix);
+	if(length < 0)
+	{
+		return nullptr;
+	}
+
+	char* const path = malloc((size_t)length + 1);
+	if(!path)
+	{
+		return nullptr;
+	}
+
+	snprintf(path, (size_t)length + 1, format, directory, first, second, suffix);
+
+	return path;
+}
+
+/*
+ * Copy the contents of a stream to another.
+ *
+ * Parameters:
+ * - source: The stream to read.
+ * - destination: The stream to write.
+ *
+ * Returns:
+ * - true on success.
+ * - false otherwise.
+ */
+static bool ccCopyStream(FILE* const source, FILE* const destination)
+{
+	char buffer[1 << 14];
+	while(true)
+	{
+		const size_t read = fread(buffer, 1, sizeof(buffer), source);
+		if(read > 0 && fwrite(buffer, 1, read, destination) != read)
+		{
+			return false;
+		}
+
+		if(read < sizeof(buffer))
+		{
+			return !ferror(source);
+		}
+	}
+}
+
+bool ccCacheRestore(const char* const directory, const CcCacheKey* const pKey, const char* const output)
+{
+	assert(directory != nullptr);
+	assert(pKey != nullptr);
+	assert(output != nullptr);
+
+	bool hit = false;
+
+	char* const outputPath = ccCachePath(directory, pKey, ".s");
+	char* const successPath = ccCachePath(directory, pKey, ".ok");
+	if(!outputPath || !successPath)
+	{
+		goto end;
+	}
+
+	FILE* const entry = fopen(outputPath, "rb");
+	if(entry)
+	{
+		FILE* const file = fopen(output, "wb");
+		if(file)
+		{
+			hit = ccCopyStream(entry, file);
+			hit = fclose(file) == 0 && hit;
+		}
+		fclose(entry);
+
+		goto end;
+	}
+
+	FILE* const success = fopen(successPath, "rb");
+	if(success)
+	{
+		fclose(success);
+		hit = true;
+	}
+
+	end:
+	free(successPath);
+	free(outputPath);
+
+	return hit;
+}
+
+bool ccCacheStore(const char* const directory, const CcCacheKey* const pKey, const char* const output)
+{
+	assert(directory != nullptr);
+	assert(pKey != nullptr);
+
+	// The directory usually exists already, failures show when creating the entry.
+#ifdef _WIN32
+	_mkdir(directory);
+#else
+	mkdir(directory, 0777);
+#endif
+
+	bool stored = false;
+
+	FILE* file = nullptr;
+	if(output)
+	{
+		file = fopen(output, "rb");
+		if(!file)
+		{
+			return false;
+		}
+	}
+
+	char* const entryPath = ccCachePath(directory, pKey, file ? ".s" : ".ok");
+	char* temporaryPath = nullptr;
+	FILE* temporary = nullptr;
+	if(!entryPath)
+	{
+		goto end;
+	}
+
+	// Creating the temporary file exclusively avoids clashing with concurrent compilations.
+	for(unsigned int attempt = 0; attempt < ccTemporaryAttempts && !temporary; ++attempt)
+	{
+		char suffix[64];
+		snprintf(suffix, sizeof(suffix), ".%llx.%p.%u.tmp", (unsigned long long)time(nullptr), (void*)&ccTemporaryCounter, ccTemporaryCounter++);
+
+		free(temporaryPath);
+		temporaryPath = ccCachePath(directory, pKey, suffix);
+		if(!temporaryPath)
+		{
+			goto end;
+		}
+
+		temporary = fopen(temporaryPath, "wbx");
+	}
+	if(!temporary)
+	{
+		goto end;
+	}
+
+	stored = !file || ccCopyStream(file, temporary);
+	stored = fclose(temporary) == 0 && stored;
+
+	// Entries are only ever replaced by identical ones, so losing a race is fine.
+	stored = stored && rename(temporaryPath, entryPath) == 0;
+	if(!stored)
+	{
+		remove(temporaryPath);
+	}
+
+	end:
+	free(temporaryPath);
+	free(entryPath);
+	if(file)
+	{
+		fclose(file);
+	}
+
+	return stored;
+}
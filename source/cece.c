@@ -1,154 +1,497 @@
 #include "cece/cece.h"
 
 #include <assert.h>
+#include <stdatomic.h>
 #include <stdlib.h>
+#include <string.h>
+#include <threads.h>
 
-// Initial buffer size for file reading.
-static constexpr size_t ccInitialSize = 1024;
+/*
+ * The location of the diagnostics of a file in the diagnostic file of the worker that compiled it.
+ *
+ * Fields:
+ * - file: The diagnostic file of the worker, nullptr if the diagnostics went straight to stderr.
+ * - start: The offset of the first diagnostic.
+ * - end: The offset past the last diagnostic.
+ */
+typedef struct CcDiagnosticRange
+{
+	FILE* file;
+	long start;
+	long end;
+} CcDiagnosticRange;
+
+/*
+ * Files shared by a pool of compilation workers.
+ *
+ * Fields:
+ * - pOptions: The options holding the files to compile.
+ * - nextInput: The index of the next input to compile.
+ * - results: The result of each input.
+ * - diagnostics: The location of the diagnostics of each input.
+ */
+typedef struct CcBatch
+{
+	const CcOptions* pOptions;
+	atomic_size_t nextInput;
+
+	CcResult* results;
+	CcDiagnosticRange* diagnostics;
+} CcBatch;
+
+/*
+ * A compilation worker.
+ *
+ * Fields:
+ * - pBatch: The batch the worker takes its files from.
+ * - thread: The thread running the worker.
+ * - file: The file buffering the diagnostics of the worker.
+ * - report: The measurements of the phases run by the worker.
+ * - started: Whether the thread was started.
+ */
+typedef struct CcWorker
+{
+	CcBatch* pBatch;
+
+	thrd_t thread;
+	FILE* file;
+
+	CcReport report;
+
+	bool started;
+} CcWorker;
+
+// Workspace of the current thread, nullptr for compilations to use their own storage.
+static thread_local CcWorkspace* ccWorkspace = nullptr;
+
+void ccSetWorkspace(CcWorkspace* const pWorkspace)
+{
+	ccWorkspace = pWorkspace;
+	ccSetDiagnosticArena(pWorkspace ? &pWorkspace->diagnosticArena : nullptr);
+}
+
+void ccFreeWorkspace(CcWorkspace* const pWorkspace)
+{
+	assert(pWorkspace != nullptr);
+
+	ccFreeLexer(&pWorkspace->lexer);
+	ccFreeTree(&pWorkspace->tree);
+	ccFreeArena(&pWorkspace->diagnosticArena);
+}
 
 void ccPrintUsage(FILE* const file)
 {
 	assert(file != nullptr);
 
-	fputs("Usage: cece [options] <file-to-compile>\n", file);
+	fputs(
+		"Usage: cece [options] <file-to-compile>...\n"
+		"       cece --server <socket>\n"
+		"       cece --client <socket> [options] <file-to-compile>...\n",
+		file
+	);
 }
 
-CcResult ccReadFile(const char* const path, CcString* const pString)
+/*
+ * Read source code from a stream.
+ *
+ * Parameters:
+ * - pFileVoid: The stream.
+ * - buffer: The buffer to read to.
+ * - size: The number of bytes to read.
+ *
+ * Returns:
+ * The number of bytes read.
+ */
+static size_t ccReadSource(void* const pFileVoid, char* const buffer, const size_t size)
 {
-	// Validate arguments.
-	assert(path != nullptr);
-	assert(pString != nullptr);
+	return fread(buffer, 1, size, pFileVoid);
+}
 
-	pString->string = nullptr;
+CcResult ccCompileFile(const char* const input, const char* const output, const CcOptions* const pOptions)
+{
+	assert(input != nullptr);
+	assert(output != nullptr);
+	assert(pOptions != nullptr);
 
 	CcResult result = CC_SUCCESS;
 
-	// Open file.
-	FILE* const file = fopen(path, "r");
-	if(!file)
-	{
-		result = CC_ERROR_FILE_NOT_FOUND;
-		goto error;
-	}
+	CcSourceFile source = {};
+	CcCacheKey cacheKey = {};
+	CcTokenList tokenList;
+
+	// The tree and the lexer of the source come from the workspace of the thread if it has one.
+	CcWorkspace* const pWorkspace = ccWorkspace;
+	CcTree localTree = {};
+	CcTree* const pTree = pWorkspace ? &pWorkspace->tree : &localTree;
 
-	// Allocate initial buffer.
-	size_t capacity = ccInitialSize;
-	pString->string = malloc(capacity);
-	if(!pString->string)
+	// Compilations with diagnostics are not cached, so that their diagnostics show again.
+	const size_t diagnosticCount = ccGetDiagnosticCount();
+
+	ccSetNestingLimit(pOptions->nestingLimit);
+	for(size_t code = 0; code < CC_DIAGNOSTIC_COUNT; ++code)
 	{
-		result = CC_ERROR_OUT_OF_MEMORY;
-		goto error;
+		ccSetDiagnosticLimit(code, pOptions->diagnosticLimit);
 	}
 
-	pString->length = 0;
-	size_t toRead = capacity;
-	while(true)
+	// Standard input is lexed as it is read rather than loaded whole, it is not cached since its key would need all of it.
+	const bool isStandardInput = strcmp(input, "-") == 0;
+	CcPhaseTimer timer;
+	if(isStandardInput)
 	{
-		const size_t read = fread(pString->string + pString->length, sizeof(pString->string[0]), toRead, file);
-		pString->length += read;
+		// Parsing pulls the tokens of one function at a time and drops their text once it is parsed, reading is measured as part of lexing.
+		CcLexer lexer;
+		result = ccCreateStreamLexer(ccReadSource, stdin, pOptions->version, &lexer);
+		if(result == CC_SUCCESS)
+		{
+			result = ccParseLexer(&lexer, pTree);
+		}
+		ccFreeLexer(&lexer);
+		if(result != CC_SUCCESS)
+		{
+			goto end;
+		}
+
+		if(ferror(stdin))
+		{
+			ccDiagnose("Failed to read standard input.");
+			ccFreeTree(pTree);
+			result = CC_ERROR_UNKNOWN;
+			goto end;
+		}
 
-		if(read < toRead)
+		goto parsed;
+	}
+	else
+	{
+		// Get source code.
+		ccBeginPhase(CC_PHASE_READ, &timer);
+		result = ccLoadFile(input, &source);
+		ccEndPhase(&timer);
+		if(result != CC_SUCCESS)
 		{
-			if(!feof(file))
+			switch(result)
 			{
-				result = CC_ERROR_UNKNOWN;
-				goto error;
+				case CC_ERROR_FILE_NOT_FOUND:
+					ccDiagnose("Failed to open file \"%s\".", input);
+					break;
+
+				case CC_ERROR_OUT_OF_MEMORY:
+					ccDiagnose("Out of memory.");
+					break;
+
+				default:
+					ccDiagnose("Unknown error occured.");
+					break;
 			}
 
-			if(pString->length >= ccSizeMax)
+			goto end;
+		}
+
+		// Skip compilation altogether if its result is cached.
+		if(pOptions->cacheDirectory)
+		{
+			cacheKey = ccCacheKey(source.string, pOptions);
+			if(ccCacheRestore(pOptions->cacheDirectory, &cacheKey, output))
 			{
-				result = CC_ERROR_OUT_OF_MEMORY;
-				goto error;
+				goto end;
 			}
+		}
+
+		// Diagnostics are located in the source, which stays loaded until the end of the compilation.
+		ccSetDiagnosticSource((CcDiagnosticSource){input, source.string.string, source.string.length});
 
-			char* const newString = realloc(pString->string, pString->length + 1);
-			if(!newString)
+		// Parsing pulls the tokens of one function at a time, measuring lexing and parsing apart, unless the jobs lex the single input faster in chunks.
+		if(pOptions->inputCount > 1 || !ccIsSplitWorthIt(source.string.length, pOptions->jobCount))
+		{
+			CcLexer localLexer;
+			CcLexer* const pLexer = pWorkspace ? &pWorkspace->lexer : &localLexer;
+			result = pWorkspace ? ccResetLexer(source.string, pOptions->version, pLexer) : ccCreateLexer(source.string, pOptions->version, pLexer);
+			if(result == CC_SUCCESS)
+			{
+				result = ccParseLexer(pLexer, pTree);
+			}
+			if(pWorkspace)
+			{
+				ccClearLexer(pLexer);
+			}
+			else
 			{
-				result = CC_ERROR_OUT_OF_MEMORY;
-				goto error;
+				ccFreeLexer(pLexer);
+			}
+			if(result != CC_SUCCESS)
+			{
+				goto end;
 			}
-			pString->string = newString;
-			pString->string[pString->length] = '\0';
 
-			result = CC_SUCCESS;
-			goto end;
+			goto parsed;
 		}
 
-		if(capacity >= ccSizeMax)
+		// A single large input leaves the jobs to lexing its source, whose tokens are then all held at once.
+		ccBeginPhase(CC_PHASE_LEX, &timer);
+		result = ccLexParallel(source.string, pOptions->version, pOptions->jobCount, &tokenList);
+		ccEndPhase(&timer);
+		if(result != CC_SUCCESS)
 		{
-			result = CC_ERROR_OUT_OF_MEMORY;
-			goto error;
+			goto end;
 		}
+	}
+
+	ccBeginPhase(CC_PHASE_PARSE, &timer);
+	result = ccParse(&(const CcConstTokenList){&tokenList, 0, tokenList.count}, pTree);
+	ccEndPhase(&timer);
+	ccFreeTokenList(&tokenList);
+	if(result != CC_SUCCESS)
+	{
+		goto end;
+	}
+
+	parsed:
+
+	if(pWorkspace)
+	{
+		ccClearTree(pTree);
+	}
+	else
+	{
+		ccFreeTree(pTree);
+	}
+
+	if(pOptions->cacheDirectory && !isStandardInput && ccGetDiagnosticCount() == diagnosticCount)
+	{
+		// Code generation does not write an output yet.
+		ccCacheStore(pOptions->cacheDirectory, &cacheKey, nullptr);
+	}
 
-		const size_t newCapacity = capacity > ccSizeMax / 2 ? ccSizeMax : capacity * 2;
-		toRead = newCapacity - capacity;
-		capacity = newCapacity;
+	end:
+	ccSetDiagnosticSource((CcDiagnosticSource){});
+	ccUnloadFile(&source);
+	return result;
+}
+
+/*
+ * Compile files of a batch until there are none left.
+ *
+ * Parameters:
+ * - pWorkerVoid: A pointer to the worker.
+ *
+ * Returns:
+ * Always 0.
+ */
+static int ccRunWorker(void* const pWorkerVoid)
+{
+	CcWorker* const pWorker = pWorkerVoid;
+	CcBatch* const pBatch = pWorker->pBatch;
 
-		char* const newString = realloc(pString->string, capacity);
-		if(!newString)
+	FILE* const previousFile = ccGetDiagnosticFile();
+	CcReport* const pPreviousReport = ccGetReport();
+
+	// Each worker measures into its own report, merged once all workers are done.
+	ccSetReport(pBatch->pOptions->timeReport || pBatch->pOptions->memoryReport ? &pWorker->report : nullptr);
+
+	// Buffer diagnostics so they can be written in input order once all files are compiled.
+	// If no file can be created, they are written to stderr as they come.
+	pWorker->file = tmpfile();
+	ccSetDiagnosticFile(pWorker->file);
+
+	while(true)
+	{
+		const size_t inputIndex = atomic_fetch_add(&pBatch->nextInput, 1);
+		if(inputIndex >= pBatch->pOptions->inputCount)
 		{
-			result = CC_ERROR_OUT_OF_MEMORY;
-			goto error;
+			break;
 		}
-		pString->string = newString;
+
+		CcDiagnosticRange* const pRange = &pBatch->diagnostics[inputIndex];
+		pRange->file = pWorker->file;
+		pRange->start = pWorker->file ? ftell(pWorker->file) : 0;
+
+		pBatch->results[inputIndex] = ccCompileFile(pBatch->pOptions->inputs[inputIndex], pBatch->pOptions->outputs[inputIndex], pBatch->pOptions);
+
+		pRange->end = pWorker->file ? ftell(pWorker->file) : 0;
 	}
 
-	error:
-	CC_FREE(pString->string);
-	pString->length = 0;
+	ccSetDiagnosticFile(previousFile);
+	ccSetReport(pPreviousReport);
 
-	end:
-	fclose(file);
+	return 0;
+}
 
-	return result;
+/*
+ * Copy the buffered diagnostics of a file to the diagnostic stream of the calling thread.
+ *
+ * Parameters:
+ * - pRange: A pointer to the location of the diagnostics.
+ */
+static void ccFlushDiagnostics(const CcDiagnosticRange* const pRange)
+{
+	assert(pRange != nullptr);
+
+	FILE* const file = ccGetDiagnosticFile();
+
+	if(!pRange->file || pRange->end <= pRange->start || fseek(pRange->file, pRange->start, SEEK_SET) != 0)
+	{
+		return;
+	}
+
+	char buffer[4096];
+	size_t remaining = (size_t)(pRange->end - pRange->start);
+	while(remaining > 0)
+	{
+		const size_t read = fread(buffer, 1, CC_MIN(remaining, sizeof(buffer)), pRange->file);
+		if(read == 0)
+		{
+			break;
+		}
+
+		fwrite(buffer, 1, read, file);
+		remaining -= read;
+	}
 }
 
-CcResult ccCompile(const CcOptions* const pOptions)
+/*
+ * Compile all the input files of the options, as described by ccCompile.
+ *
+ * Parameters:
+ * - pOptions: A pointer to the options to use for compilation.
+ * - pReport: A pointer to the report to merge the measurements of worker threads into, nullptr if phases are not measured.
+ *
+ * Returns:
+ * The result of the compilation, as described by ccCompile.
+ */
+static CcResult ccCompileInputs(const CcOptions* const pOptions, CcReport* const pReport)
 {
+	assert(pOptions != nullptr);
+	assert(pOptions->inputCount > 0);
+
 	CcResult result = CC_SUCCESS;
 
-	// Get source code.
-	CcString source = {};
-	result = ccReadFile(pOptions->input, &source);
-	if(result != CC_SUCCESS)
+	const size_t workerCount = CC_MIN(pOptions->jobCount, pOptions->inputCount);
+
+	// Without concurrency, diagnostics are already in order.
+	if(workerCount <= 1)
 	{
-		switch(result)
+		for(size_t inputIndex = 0; inputIndex < pOptions->inputCount; ++inputIndex)
 		{
-			case CC_ERROR_FILE_NOT_FOUND:
-				fprintf(stderr, "Failed to open file \"%s\".\n", pOptions->input);
-				break;
+			const CcResult inputResult = ccCompileFile(pOptions->inputs[inputIndex], pOptions->outputs[inputIndex], pOptions);
+			if(result == CC_SUCCESS)
+			{
+				result = inputResult;
+			}
+		}
+
+		return result;
+	}
 
-			case CC_ERROR_OUT_OF_MEMORY:
-				fputs("Out of memory.\n", stderr);
-				break;
+	CcBatch batch = {.pOptions = pOptions};
+	atomic_init(&batch.nextInput, 0);
 
-			default:
-				fputs("Unknown error occured.\n", stderr);
-				break;
-		}
+	CcWorker* workers = nullptr;
 
+	batch.results = malloc(pOptions->inputCount * sizeof(batch.results[0]));
+	batch.diagnostics = calloc(pOptions->inputCount, sizeof(batch.diagnostics[0]));
+	workers = calloc(workerCount, sizeof(workers[0]));
+	if(!batch.results || !batch.diagnostics || !workers)
+	{
+		ccDiagnose("Out of memory.");
+		result = CC_ERROR_OUT_OF_MEMORY;
 		goto end;
 	}
 
-	const CcConstString constString = {.string = source.string, .length = source.length};
-	CcTokenList tokenList;
-	result = ccLex(constString, &tokenList);
-	if(result != CC_SUCCESS)
+	// The calling thread is the first worker.
+	for(size_t workerIndex = 0; workerIndex < workerCount; ++workerIndex)
 	{
-		goto end;
+		workers[workerIndex].pBatch = &batch;
+	}
+	for(size_t workerIndex = 1; workerIndex < workerCount; ++workerIndex)
+	{
+		workers[workerIndex].started = thrd_create(&workers[workerIndex].thread, ccRunWorker, &workers[workerIndex]) == thrd_success;
 	}
 
-	CcTree tree;
-	result = ccParse(&(const CcConstTokenList){tokenList.tokens, tokenList.count}, &tree);
-	ccFreeTokenList(&tokenList);
-	if(result != CC_SUCCESS)
+	ccRunWorker(&workers[0]);
+
+	for(size_t workerIndex = 1; workerIndex < workerCount; ++workerIndex)
 	{
-		goto end;
+		if(workers[workerIndex].started)
+		{
+			thrd_join(workers[workerIndex].thread, nullptr);
+		}
+	}
+
+	if(pReport)
+	{
+		for(size_t workerIndex = 0; workerIndex < workerCount; ++workerIndex)
+		{
+			ccMergeReport(pReport, &workers[workerIndex].report);
+		}
+	}
+
+	for(size_t inputIndex = 0; inputIndex < pOptions->inputCount; ++inputIndex)
+	{
+		ccFlushDiagnostics(&batch.diagnostics[inputIndex]);
+
+		if(result == CC_SUCCESS)
+		{
+			result = batch.results[inputIndex];
+		}
+	}
+
+	for(size_t workerIndex = 0; workerIndex < workerCount; ++workerIndex)
+	{
+		if(workers[workerIndex].file)
+		{
+			fclose(workers[workerIndex].file);
+		}
 	}
 
-	ccFreeTree(&tree);
-	
 	end:
-	free(source.string);
+	free(workers);
+	free(batch.diagnostics);
+	free(batch.results);
+
+	return result;
+}
+
+CcResult ccCompile(const CcOptions* const pOptions)
+{
+	assert(pOptions != nullptr);
+
+	if(!pOptions->timeReport && !pOptions->memoryReport)
+	{
+		return ccCompileInputs(pOptions, nullptr);
+	}
+
+	CcReport report = {};
+
+	// Phases are measured per thread, the elapsed time once for the whole compilation.
+	const double startTime = ccGetWallTime();
+	CcReport* const pPreviousReport = ccGetReport();
+	ccSetReport(&report);
+	CcResult result = ccCompileInputs(pOptions, &report);
+	ccSetReport(pPreviousReport);
+	report.elapsedTime = ccGetWallTime() - startTime;
+
+	if(pOptions->timeReport)
+	{
+		ccPrintTimeReport(&report, ccGetDiagnosticFile());
+	}
+
+	if(pOptions->memoryReport)
+	{
+		ccPrintMemoryReport(&report, ccGetDiagnosticFile());
+	}
+
+	if(pOptions->timeReportPath)
+	{
+		FILE* const file = fopen(pOptions->timeReportPath, "w");
+		if(!file)
+		{
+			ccDiagnose("Failed to open file \"%s\".", pOptions->timeReportPath);
+			return result == CC_SUCCESS ? CC_ERROR_FILE_NOT_FOUND : result;
+		}
+
+		ccWriteTimeReportJson(&report, file);
+		fclose(file);
+	}
+
 	return result;
 }
@@ -0,0 +1,652 @@
+#include "cece/diagnostic.h"
+
+#include <assert.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "cece/memory.h"
+
+// Diagnostic stream of the current thread, nullptr meaning stderr.
+static thread_local FILE* ccDiagnosticFile = nullptr;
+
+// Number of diagnostics written by the current thread.
+static thread_local size_t ccDiagnosticCount = 0;
+
+// Source code the diagnostics of the current thread refer to.
+static thread_local CcDiagnosticSource ccDiagnosticSource = {};
+
+// Map of the lines of ccDiagnosticSource, built by the first diagnostic locating a position.
+static thread_local CcSourceMap ccDiagnosticSourceMap = {};
+
+// Sink recording the diagnostics reported by the current thread, nullptr to write them as they are reported.
+static thread_local CcDiagnosticSink* ccDiagnosticSink = nullptr;
+
+// Arena the active sink of the current thread records into and gives back once freed, nullptr for sinks to use their own.
+static thread_local CcArena* ccDiagnosticArena = nullptr;
+
+// Highest number of diagnostics with each code written by a sink, 0 meaning no limit.
+static thread_local size_t ccDiagnosticLimits[CC_DIAGNOSTIC_COUNT] = {};
+
+// Number of records in a page of a sink.
+static constexpr size_t ccDiagnosticPageSize = 256;
+
+// Initial capacity of the text written by ccFlushDiagnosticSink.
+static constexpr size_t ccDiagnosticTextCapacity = 1 << 12;
+
+/*
+ * A page of records of a diagnostic sink.
+ *
+ * Fields:
+ * - pNext: The next page, nullptr for the last one.
+ * - count: The number of records of the page.
+ * - records: The records.
+ */
+struct CcDiagnosticPage
+{
+	CcDiagnosticPage* pNext;
+	size_t count;
+	CcDiagnosticRecord records[ccDiagnosticPageSize];
+};
+
+/*
+ * Text written at once by ccFlushDiagnosticSink.
+ *
+ * Fields:
+ * - file: The stream the text is written to.
+ * - string: The text, nullptr until something is appended.
+ * - length: The length of the text.
+ * - capacity: The size of the buffer of the text.
+ */
+typedef struct CcDiagnosticText
+{
+	FILE* file;
+
+	char* string;
+	size_t length;
+	size_t capacity;
+} CcDiagnosticText;
+
+#define CC_DIAGNOSTIC_SEVERITY_CASE(name, severity, message) \
+	case CC_DIAGNOSTIC_##name: \
+		return CC_SEVERITY_##severity;
+
+CcSeverity ccDiagnosticSeverity(const CcDiagnosticCode code)
+{
+	assert(code >= 0 && code < CC_DIAGNOSTIC_COUNT);
+
+	switch(code)
+	{
+		CC_DIAGNOSTIC(CC_DIAGNOSTIC_SEVERITY_CASE)
+
+		default:
+			return CC_SEVERITY_ERROR;
+	}
+}
+
+#define CC_DIAGNOSTIC_MESSAGE_CASE(name, severity, message) \
+	case CC_DIAGNOSTIC_##name: \
+		return message;
+
+const char* ccDiagnosticMessage(const CcDiagnosticCode code)
+{
+	assert(code >= 0 && code < CC_DIAGNOSTIC_COUNT);
+
+	switch(code)
+	{
+		CC_DIAGNOSTIC(CC_DIAGNOSTIC_MESSAGE_CASE)
+
+		default:
+			return nullptr;
+	}
+}
+
+CcResult ccBuildSourceMap(const char* const source, const size_t length, CcSourceMap* const pMap)
+{
+	assert(source != nullptr || length == 0);
+	assert(pMap != nullptr);
+
+	*pMap = (CcSourceMap){.source = source, .length = length, .lineCount = 1};
+
+	// Line breaks are counted first so the lines are allocated once, memchr being vectorized by the C library.
+	const char* const end = source + length;
+	for(const char* lineBreak = length > 0 ? memchr(source, '\n', length) : nullptr; lineBreak; lineBreak = memchr(lineBreak + 1, '\n', end - lineBreak - 1))
+	{
+		++pMap->lineCount;
+	}
+
+	if(pMap->lineCount > ccSizeMax / sizeof(pMap->lineStarts[0]))
+	{
+		return CC_ERROR_OUT_OF_MEMORY;
+	}
+
+	pMap->lineStarts = ccMalloc(pMap->lineCount * sizeof(pMap->lineStarts[0]));
+	if(!pMap->lineStarts)
+	{
+		pMap->lineCount = 0;
+		return CC_ERROR_OUT_OF_MEMORY;
+	}
+
+	pMap->lineStarts[0] = 0;
+	size_t lineIndex = 1;
+	for(const char* lineBreak = length > 0 ? memchr(source, '\n', length) : nullptr; lineBreak; lineBreak = memchr(lineBreak + 1, '\n', end - lineBreak - 1))
+	{
+		pMap->lineStarts[lineIndex] = lineBreak + 1 - source;
+		++lineIndex;
+	}
+
+	return CC_SUCCESS;
+}
+
+bool ccLocate(const CcSourceMap* const pMap, const char* const position, size_t* const pLine, size_t* const pColumn)
+{
+	assert(pMap != nullptr);
+	assert(pLine != nullptr);
+	assert(pColumn != nullptr);
+
+	// Positions are compared as integers since they may point to another object.
+	const uintptr_t start = (uintptr_t)pMap->source;
+	if(!pMap->lineStarts || (uintptr_t)position < start || (uintptr_t)position - start > pMap->length)
+	{
+		return false;
+	}
+
+	const size_t offset = (uintptr_t)position - start;
+
+	// Find the last line starting at or before the offset.
+	size_t low = 0;
+	size_t high = pMap->lineCount;
+	while(high - low > 1)
+	{
+		const size_t middle = low + (high - low) / 2;
+		if(pMap->lineStarts[middle] <= offset)
+		{
+			low = middle;
+		}
+		else
+		{
+			high = middle;
+		}
+	}
+
+	*pLine = low + 1;
+	*pColumn = offset - pMap->lineStarts[low] + 1;
+
+	return true;
+}
+
+void ccFreeSourceMap(CcSourceMap* const pMap)
+{
+	assert(pMap != nullptr);
+
+	ccFree(pMap->lineStarts, pMap->lineCount * sizeof(pMap->lineStarts[0]));
+
+	*pMap = (CcSourceMap){};
+}
+
+void ccSetDiagnosticFile(FILE* const file)
+{
+	ccDiagnosticFile = file;
+}
+
+FILE* ccGetDiagnosticFile(void)
+{
+	return ccDiagnosticFile ? ccDiagnosticFile : stderr;
+}
+
+void ccSetDiagnosticSource(const CcDiagnosticSource source)
+{
+	assert(source.string != nullptr || source.length == 0);
+
+	ccFreeSourceMap(&ccDiagnosticSourceMap);
+	ccDiagnosticSource = source;
+}
+
+CcDiagnosticSource ccGetDiagnosticSource(void)
+{
+	return ccDiagnosticSource;
+}
+
+/*
+ * Locate a position in the source code diagnostics of the calling thread refer to.
+ *
+ * Parameters:
+ * - position: A pointer into the source code, or nullptr.
+ * - pLine: A pointer to store the line.
+ * - pColumn: A pointer to store the column.
+ *
+ * Returns:
+ * - true if the position is located.
+ * - false otherwise.
+ */
+static bool ccLocateDiagnostic(const char* const position, size_t* const pLine, size_t* const pColumn)
+{
+	if(!position || !ccDiagnosticSource.string)
+	{
+		return false;
+	}
+
+	// A map that fails to build is built again by the next diagnostic, until then positions are not located.
+	if(!ccDiagnosticSourceMap.lineStarts)
+	{
+		ccBuildSourceMap(ccDiagnosticSource.string, ccDiagnosticSource.length, &ccDiagnosticSourceMap);
+	}
+
+	return ccLocate(&ccDiagnosticSourceMap, position, pLine, pColumn);
+}
+
+/*
+ * Write a diagnostic line to the diagnostic stream of the calling thread.
+ * The records of the sink of the thread are written first, as they were reported before.
+ *
+ * Parameters:
+ * - position: A pointer into the source code to locate, or nullptr.
+ * - format: A printf format string, without the trailing newline.
+ * - arguments: The format arguments.
+ */
+static void ccWriteDiagnostic(const char* const position, const char* const format, va_list arguments)
+{
+	if(ccDiagnosticSink && ccDiagnosticSink->recordCount > 0)
+	{
+		ccFlushDiagnosticSink(ccDiagnosticSink);
+	}
+
+	FILE* const file = ccGetDiagnosticFile();
+
+	size_t line;
+	size_t column;
+	if(ccLocateDiagnostic(position, &line, &column))
+	{
+		if(ccDiagnosticSource.name)
+		{
+			fprintf(file, "%s:", ccDiagnosticSource.name);
+		}
+		fprintf(file, "%zu:%zu: ", line, column);
+	}
+
+	vfprintf(file, format, arguments);
+	fputc('\n', file);
+
+	++ccDiagnosticCount;
+}
+
+void ccDiagnose(const char* const format, ...)
+{
+	assert(format != nullptr);
+
+	va_list arguments;
+	va_start(arguments, format);
+	ccWriteDiagnostic(nullptr, format, arguments);
+	va_end(arguments);
+}
+
+void ccDiagnoseAt(const char* const position, const char* const format, ...)
+{
+	assert(format != nullptr);
+
+	va_list arguments;
+	va_start(arguments, format);
+	ccWriteDiagnostic(position, format, arguments);
+	va_end(arguments);
+}
+
+void ccSetDiagnosticLimit(const CcDiagnosticCode code, const size_t limit)
+{
+	assert(code >= 0 && code < CC_DIAGNOSTIC_COUNT);
+
+	ccDiagnosticLimits[code] = limit;
+}
+
+void ccSetDiagnosticSink(CcDiagnosticSink* const pSink)
+{
+	ccDiagnosticSink = pSink;
+}
+
+CcDiagnosticSink* ccGetDiagnosticSink(void)
+{
+	return ccDiagnosticSink;
+}
+
+void ccBeginDiagnostics(CcDiagnosticSink* const pSink)
+{
+	assert(pSink != nullptr);
+
+	*pSink = (CcDiagnosticSink){.source = ccDiagnosticSource};
+
+	if(!ccDiagnosticSink)
+	{
+		ccDiagnosticSink = pSink;
+
+		// Only the active sink records, so it is the one taking the arena of the thread.
+		if(ccDiagnosticArena)
+		{
+			pSink->arena = *ccDiagnosticArena;
+			*ccDiagnosticArena = (CcArena){};
+		}
+	}
+}
+
+void ccSetDiagnosticArena(CcArena* const pArena)
+{
+	ccDiagnosticArena = pArena;
+}
+
+void ccEndDiagnostics(CcDiagnosticSink* const pSink)
+{
+	assert(pSink != nullptr);
+
+	if(ccDiagnosticSink == pSink)
+	{
+		ccDiagnosticSink = nullptr;
+		ccFlushDiagnosticSink(pSink);
+	}
+	else
+	{
+		ccFreeDiagnosticSink(pSink);
+	}
+}
+
+/*
+ * Get the offset of a position in a source code.
+ *
+ * Parameters:
+ * - pSource: A pointer to the source code.
+ * - position: A pointer, or nullptr.
+ *
+ * Returns:
+ * The offset of the position, its end included, or SIZE_MAX if it is not in the source code.
+ */
+static size_t ccSourceOffset(const CcDiagnosticSource* const pSource, const char* const position)
+{
+	// Positions are compared as integers since they may point to another object.
+	const uintptr_t start = (uintptr_t)pSource->string;
+
+	if(!pSource->string || !position || (uintptr_t)position < start || (uintptr_t)position - start > pSource->length)
+	{
+		return SIZE_MAX;
+	}
+
+	return (uintptr_t)position - start;
+}
+
+/*
+ * Get the position of an offset in a source code.
+ *
+ * Parameters:
+ * - pSource: A pointer to the source code.
+ * - offset: An offset, or SIZE_MAX.
+ *
+ * Returns:
+ * The position, or nullptr if the offset is SIZE_MAX.
+ */
+static const char* ccSourcePosition(const CcDiagnosticSource* const pSource, const size_t offset)
+{
+	return offset == SIZE_MAX ? nullptr : pSource->string + offset;
+}
+
+/*
+ * Check whether two offsets are repeats of each other.
+ *
+ * Parameters:
+ * - pSource: A pointer to the source code.
+ * - first: An offset, or SIZE_MAX.
+ * - second: An offset, or SIZE_MAX.
+ *
+ * Returns:
+ * - true if both offsets are on the same line of the source code.
+ * - false otherwise, in particular if either is outside of it.
+ */
+static bool ccIsRepeat(const CcDiagnosticSource* const pSource, const size_t first, const size_t second)
+{
+	if(first == SIZE_MAX || second == SIZE_MAX)
+	{
+		return false;
+	}
+
+	const size_t start = CC_MIN(first, second);
+	const size_t end = CC_MAX(first, second);
+
+	return !memchr(pSource->string + start, '\n', end - start);
+}
+
+/*
+ * Record a diagnostic into a sink.
+ *
+ * Parameters:
+ * - pSink: A pointer to the sink.
+ * - pRecord: A pointer to the record.
+ *
+ * Returns:
+ * - true if the diagnostic is recorded.
+ * - false if memory allocation fails.
+ */
+static bool ccRecordDiagnostic(CcDiagnosticSink* const pSink, const CcDiagnosticRecord* const pRecord)
+{
+	CcDiagnosticPage* pPage = pSink->pLastPage;
+	if(pPage)
+	{
+		CcDiagnosticRecord* const pLast = &pPage->records[pPage->count - 1];
+		if(pLast->code == pRecord->code && ccIsRepeat(&pSink->source, pLast->offset, pRecord->offset))
+		{
+			pLast->repeatCount += pRecord->repeatCount;
+			return true;
+		}
+	}
+
+	if(!pPage || pPage->count == ccDiagnosticPageSize)
+	{
+		pPage = ccArenaAllocate(&pSink->arena, sizeof(*pPage), alignof(CcDiagnosticPage));
+		if(!pPage)
+		{
+			return false;
+		}
+		pPage->pNext = nullptr;
+		pPage->count = 0;
+
+		if(pSink->pLastPage)
+		{
+			pSink->pLastPage->pNext = pPage;
+		}
+		else
+		{
+			pSink->pFirstPage = pPage;
+		}
+		pSink->pLastPage = pPage;
+	}
+
+	pPage->records[pPage->count] = *pRecord;
+	++pPage->count;
+	++pSink->recordCount;
+
+	return true;
+}
+
+/*
+ * Write a record to the diagnostic stream of the calling thread.
+ *
+ * Parameters:
+ * - pRecord: A pointer to the record.
+ * - position: The position of the record, or nullptr.
+ */
+static void ccWriteRecord(const CcDiagnosticRecord* const pRecord, const char* const position)
+{
+	const char* const prefix = ccDiagnosticSeverity(pRecord->code) == CC_SEVERITY_WARNING ? "warning: " : "";
+	const char* const message = ccDiagnosticMessage(pRecord->code);
+
+	if(pRecord->repeatCount > 1)
+	{
+		ccDiagnoseAt(position, "%s%s (repeated %zu times)", prefix, message, pRecord->repeatCount);
+	}
+	else
+	{
+		ccDiagnoseAt(position, "%s%s", prefix, message);
+	}
+
+	ccDiagnosticCount += pRecord->repeatCount - 1;
+}
+
+void ccReportDiagnostic(const CcDiagnosticCode code, const char* const position)
+{
+	assert(code >= 0 && code < CC_DIAGNOSTIC_COUNT);
+
+	// Without a sink, or memory for the record, the diagnostic is written right away.
+	if(!ccDiagnosticSink)
+	{
+		ccWriteRecord(&(const CcDiagnosticRecord){code, SIZE_MAX, 1}, position);
+		return;
+	}
+
+	const CcDiagnosticRecord record = {code, ccSourceOffset(&ccDiagnosticSink->source, position), 1};
+	if(!ccRecordDiagnostic(ccDiagnosticSink, &record))
+	{
+		ccWriteRecord(&record, position);
+	}
+}
+
+void ccMergeDiagnosticSink(CcDiagnosticSink* const pSink, const CcDiagnosticSink* const pOther)
+{
+	assert(pSink != nullptr);
+	assert(pOther != nullptr);
+
+	for(const CcDiagnosticPage* pPage = pOther->pFirstPage; pPage; pPage = pPage->pNext)
+	{
+		for(size_t recordIndex = 0; recordIndex < pPage->count; ++recordIndex)
+		{
+			// Offsets are moved to the source of the sink, which is usually the same.
+			CcDiagnosticRecord record = pPage->records[recordIndex];
+			const char* const position = ccSourcePosition(&pOther->source, record.offset);
+			record.offset = ccSourceOffset(&pSink->source, position);
+
+			if(!ccRecordDiagnostic(pSink, &record))
+			{
+				ccWriteRecord(&record, position);
+			}
+		}
+	}
+}
+
+/*
+ * Append formatted text to the text written by ccFlushDiagnosticSink.
+ * If the text cannot grow, it is written and the formatted text is written directly.
+ *
+ * Parameters:
+ * - pText: A pointer to the text.
+ * - format: A printf format string.
+ * - ...: The format arguments.
+ */
+static void ccAppendDiagnosticText(CcDiagnosticText* const pText, const char* const format, ...)
+{
+	va_list arguments;
+	va_start(arguments, format);
+	va_list copy;
+	va_copy(copy, arguments);
+
+	const int length = vsnprintf(pText->string ? pText->string + pText->length : nullptr, pText->capacity - pText->length, format, arguments);
+	if(length < 0 || (size_t)length < pText->capacity - pText->length)
+	{
+		pText->length += length < 0 ? 0 : (size_t)length;
+		goto end;
+	}
+
+	size_t capacity = pText->capacity > 0 ? pText->capacity : ccDiagnosticTextCapacity;
+	while(capacity - pText->length <= (size_t)length && capacity <= ccSizeMax / 2)
+	{
+		capacity *= 2;
+	}
+
+	char* const string = capacity - pText->length > (size_t)length ? ccRealloc(pText->string, pText->capacity, capacity) : nullptr;
+	if(!string)
+	{
+		fwrite(pText->string, 1, pText->length, pText->file);
+		pText->length = 0;
+		vfprintf(pText->file, format, copy);
+		goto end;
+	}
+	pText->string = string;
+	pText->capacity = capacity;
+
+	vsnprintf(pText->string + pText->length, pText->capacity - pText->length, format, copy);
+	pText->length += (size_t)length;
+
+	end:
+	va_end(copy);
+	va_end(arguments);
+}
+
+void ccFlushDiagnosticSink(CcDiagnosticSink* const pSink)
+{
+	assert(pSink != nullptr);
+
+	CcDiagnosticText text = {.file = ccGetDiagnosticFile()};
+
+	size_t writtenCounts[CC_DIAGNOSTIC_COUNT] = {};
+	size_t omittedCounts[CC_DIAGNOSTIC_COUNT] = {};
+	for(const CcDiagnosticPage* pPage = pSink->pFirstPage; pPage; pPage = pPage->pNext)
+	{
+		for(size_t recordIndex = 0; recordIndex < pPage->count; ++recordIndex)
+		{
+			const CcDiagnosticRecord* const pRecord = &pPage->records[recordIndex];
+			ccDiagnosticCount += pRecord->repeatCount;
+
+			if(ccDiagnosticLimits[pRecord->code] > 0 && writtenCounts[pRecord->code] >= ccDiagnosticLimits[pRecord->code])
+			{
+				omittedCounts[pRecord->code] += pRecord->repeatCount;
+				continue;
+			}
+			++writtenCounts[pRecord->code];
+
+			size_t line;
+			size_t column;
+			if(ccLocateDiagnostic(ccSourcePosition(&pSink->source, pRecord->offset), &line, &column))
+			{
+				ccAppendDiagnosticText(&text, "%s%s%zu:%zu: ", ccDiagnosticSource.name ? ccDiagnosticSource.name : "", ccDiagnosticSource.name ? ":" : "", line, column);
+			}
+
+			ccAppendDiagnosticText(&text, "%s%s", ccDiagnosticSeverity(pRecord->code) == CC_SEVERITY_WARNING ? "warning: " : "", ccDiagnosticMessage(pRecord->code));
+			if(pRecord->repeatCount > 1)
+			{
+				ccAppendDiagnosticText(&text, " (repeated %zu times)", pRecord->repeatCount);
+			}
+			ccAppendDiagnosticText(&text, "\n");
+		}
+	}
+
+	for(size_t codeIndex = 0; codeIndex < CC_DIAGNOSTIC_COUNT; ++codeIndex)
+	{
+		if(omittedCounts[codeIndex] > 0)
+		{
+			ccAppendDiagnosticText(&text, "%s (%zu more omitted)\n", ccDiagnosticMessage(codeIndex), omittedCounts[codeIndex]);
+		}
+	}
+
+	if(text.length > 0)
+	{
+		fwrite(text.string, 1, text.length, text.file);
+	}
+	ccFree(text.string, text.capacity);
+
+	ccFreeDiagnosticSink(pSink);
+}
+
+void ccFreeDiagnosticSink(CcDiagnosticSink* const pSink)
+{
+	assert(pSink != nullptr);
+
+	// The arena of the thread is given back with its blocks, unless another sink already did.
+	if(ccDiagnosticArena && !ccDiagnosticArena->pBlock && !ccDiagnosticArena->pSpare)
+	{
+		ccResetArena(&pSink->arena);
+		*ccDiagnosticArena = pSink->arena;
+	}
+	else
+	{
+		ccFreeArena(&pSink->arena);
+	}
+
+	*pSink = (CcDiagnosticSink){.source = pSink->source};
+}
+
+size_t ccGetDiagnosticCount(void)
+{
+	return ccDiagnosticCount;
+}
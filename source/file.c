@@ -0,0 +1,311 @@
+// Needed for mmap, MAP_ANONYMOUS and fdopen.
+#define _DEFAULT_SOURCE
+
+#include "cece/file.h"
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "cece/memory.h"
+
+// Initial buffer size for file reading.
+static constexpr size_t ccInitialSize = 1024;
+
+CcResult ccReadStream(FILE* const file, CcString* const pString)
+{
+	// Validate arguments.
+	assert(file != nullptr);
+	assert(pString != nullptr);
+
+	CcResult result = CC_SUCCESS;
+
+	// Allocate initial buffer.
+	size_t capacity = ccInitialSize;
+	pString->string = ccMalloc(capacity);
+	if(!pString->string)
+	{
+		result = CC_ERROR_OUT_OF_MEMORY;
+		goto error;
+	}
+
+	pString->length = 0;
+	size_t toRead = capacity;
+	while(true)
+	{
+		const size_t read = fread(pString->string + pString->length, sizeof(pString->string[0]), toRead, file);
+		pString->length += read;
+
+		if(read < toRead)
+		{
+			if(!feof(file))
+			{
+				result = CC_ERROR_UNKNOWN;
+				goto error;
+			}
+
+			if(pString->length >= ccSizeMax)
+			{
+				result = CC_ERROR_OUT_OF_MEMORY;
+				goto error;
+			}
+
+			char* const newString = ccRealloc(pString->string, capacity, pString->length + 1);
+			if(!newString)
+			{
+				result = CC_ERROR_OUT_OF_MEMORY;
+				goto error;
+			}
+			pString->string = newString;
+			pString->string[pString->length] = '\0';
+
+			return CC_SUCCESS;
+		}
+
+		if(capacity >= ccSizeMax)
+		{
+			result = CC_ERROR_OUT_OF_MEMORY;
+			goto error;
+		}
+
+		const size_t newCapacity = capacity > ccSizeMax / 2 ? ccSizeMax : capacity * 2;
+
+		char* const newString = ccRealloc(pString->string, capacity, newCapacity);
+		if(!newString)
+		{
+			result = CC_ERROR_OUT_OF_MEMORY;
+			goto error;
+		}
+		pString->string = newString;
+
+		toRead = newCapacity - capacity;
+		capacity = newCapacity;
+	}
+
+	error:
+	ccFree(pString->string, capacity);
+	pString->string = nullptr;
+	pString->length = 0;
+
+	return result;
+}
+
+CcResult ccReadFile(const char* const path, CcString* const pString)
+{
+	// Validate arguments.
+	assert(path != nullptr);
+	assert(pString != nullptr);
+
+	pString->string = nullptr;
+	pString->length = 0;
+
+	// Open file.
+	FILE* const file = fopen(path, "r");
+	if(!file)
+	{
+		return CC_ERROR_FILE_NOT_FOUND;
+	}
+
+	const CcResult result = ccReadStream(file, pString);
+
+	fclose(file);
+
+	return result;
+}
+
+/*
+ * Load a file by reading a stream into a buffer.
+ *
+ * Parameters:
+ * - file: The stream.
+ * - pFile: A pointer to the loaded file.
+ *
+ * Returns:
+ * The same values as ccReadStream.
+ */
+static CcResult ccLoadStream(FILE* const file, CcSourceFile* const pFile)
+{
+	CcString string = {};
+	const CcResult result = ccReadStream(file, &string);
+	if(result != CC_SUCCESS)
+	{
+		return result;
+	}
+
+	pFile->buffer = string.string;
+	pFile->string = (CcConstString){.string = string.string, .length = string.length};
+
+	return CC_SUCCESS;
+}
+
+/*
+ * Load a file by reading it into a buffer.
+ *
+ * Parameters:
+ * - path: Path of the file, or "-" for standard input.
+ * - pFile: A pointer to the loaded file.
+ *
+ * Returns:
+ * The same values as ccLoadFile.
+ */
+static CcResult ccLoadFileBuffer(const char* const path, CcSourceFile* const pFile)
+{
+	if(strcmp(path, "-") == 0)
+	{
+		return ccLoadStream(stdin, pFile);
+	}
+
+	FILE* const file = fopen(path, "r");
+	if(!file)
+	{
+		return CC_ERROR_FILE_NOT_FOUND;
+	}
+
+	const CcResult result = ccLoadStream(file, pFile);
+
+	fclose(file);
+
+	return result;
+}
+
+CcResult ccLoadFile(const char* const path, CcSourceFile* const pFile)
+{
+	// Validate arguments.
+	assert(path != nullptr);
+	assert(pFile != nullptr);
+
+	*pFile = (CcSourceFile){};
+
+#ifdef _WIN32
+	// Text mode translates line endings on Windows, so the contents cannot be mapped as they are.
+	return ccLoadFileBuffer(path, pFile);
+#else
+	if(strcmp(path, "-") == 0)
+	{
+		return ccLoadFileBuffer(path, pFile);
+	}
+
+	const int descriptor = open(path, O_RDONLY);
+	if(descriptor == -1)
+	{
+		return CC_ERROR_FILE_NOT_FOUND;
+	}
+
+	CcResult result = CC_SUCCESS;
+
+	struct stat status;
+	if(fstat(descriptor, &status) != 0)
+	{
+		result = CC_ERROR_UNKNOWN;
+		goto end;
+	}
+
+	// Pipes and devices have no size to map.
+	if(!S_ISREG(status.st_mode))
+	{
+		goto buffer;
+	}
+
+	if(status.st_size == 0)
+	{
+		pFile->string = (CcConstString){.string = "", .length = 0};
+		goto end;
+	}
+
+	const long pageSize = sysconf(_SC_PAGESIZE);
+	if(pageSize <= 0)
+	{
+		goto buffer;
+	}
+
+	const size_t size = (size_t)status.st_size;
+	if((uintmax_t)status.st_size >= ccSizeMax - (size_t)pageSize)
+	{
+		result = CC_ERROR_OUT_OF_MEMORY;
+		goto end;
+	}
+
+	if(size % (size_t)pageSize != 0)
+	{
+		// The rest of the last page is zero-filled, which provides the null terminator.
+		pFile->mappingSize = size;
+		pFile->mapping = mmap(nullptr, pFile->mappingSize, PROT_READ, MAP_PRIVATE, descriptor, 0);
+		if(pFile->mapping == MAP_FAILED)
+		{
+			pFile->mapping = nullptr;
+			goto buffer;
+		}
+	}
+	else
+	{
+		// Reserve an extra zero page after the file, then map the file over the start of the reservation.
+		pFile->mappingSize = size + (size_t)pageSize;
+		pFile->mapping = mmap(nullptr, pFile->mappingSize, PROT_READ, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		if(pFile->mapping == MAP_FAILED)
+		{
+			pFile->mapping = nullptr;
+			goto buffer;
+		}
+
+		if(mmap(pFile->mapping, size, PROT_READ, MAP_PRIVATE | MAP_FIXED, descriptor, 0) == MAP_FAILED)
+		{
+			munmap(pFile->mapping, pFile->mappingSize);
+			pFile->mapping = nullptr;
+			goto buffer;
+		}
+	}
+
+	posix_madvise(pFile->mapping, size, POSIX_MADV_SEQUENTIAL);
+
+	pFile->string = (CcConstString){.string = pFile->mapping, .length = size};
+
+	goto end;
+
+	buffer:
+	pFile->mappingSize = 0;
+
+	// Read from the descriptor already open, opening the path again would lose or repeat the data of a pipe or device.
+	FILE* const file = fdopen(descriptor, "r");
+	if(!file)
+	{
+		result = CC_ERROR_UNKNOWN;
+		goto end;
+	}
+
+	// Closing the stream closes the descriptor.
+	result = ccLoadStream(file, pFile);
+	fclose(file);
+
+	return result;
+
+	end:
+	close(descriptor);
+
+	return result;
+#endif
+}
+
+void ccUnloadFile(CcSourceFile* const pFile)
+{
+	assert(pFile != nullptr);
+
+#ifndef _WIN32
+	if(pFile->mapping)
+	{
+		munmap(pFile->mapping, pFile->mappingSize);
+	}
+#endif
+
+	if(pFile->buffer)
+	{
+		ccFree(pFile->buffer, pFile->string.length + 1);
+	}
+	*pFile = (CcSourceFile){};
+}
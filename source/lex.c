@@ -1,12 +1,16 @@
 #include "cece/lex.h"
 
 #include <assert.h>
-#include <ctype.h>
-#include <stdio.h>
-#include <stdlib.h>
+#include <limits.h>
+#include <stdckdint.h>
 #include <string.h>
+#include <threads.h>
 
+#include "cece/character.h"
+#include "cece/diagnostic.h"
 #include "cece/memory.h"
+#include "cece/report.h"
+#include "cece/scan.h"
 
 typedef struct CcMapping
 {
@@ -17,118 +21,182 @@ typedef struct CcMapping
 #define CC_STRING(string) \
 {string, sizeof(string) - 1}
 
-// Keywords must be stored from longest to shortest and in alphabetical order for bsearch.
-// They could also be stored from shortest to longest, we won't miss longer keywords (e.g. "do" and "double") because we know the length of the identifier.
-static const CcMapping keywordMap[] = {
-	{CC_STRING("_Static_assert"), CC_TOKEN__STATIC_ASSERT},
-	{CC_STRING("static_assert"), CC_TOKEN_STATIC_ASSERT},
-	{CC_STRING("typeof_unqual"), CC_TOKEN_TYPEOF_UNQUAL},
-	{CC_STRING("_Thread_local"), CC_TOKEN__THREAD_LOCAL},
-	{CC_STRING("thread_local"), CC_TOKEN_THREAD_LOCAL},
-	{CC_STRING("_Decimal128"), CC_TOKEN__DECIMAL_128},
-	{CC_STRING("_Decimal32"), CC_TOKEN__DECIMAL_32},
-	{CC_STRING("_Decimal64"), CC_TOKEN__DECIMAL_64},
-	{CC_STRING("_Imaginary"), CC_TOKEN__IMAGINARY},
-	{CC_STRING("constexpr"), CC_TOKEN_CONSTEXPR},
-	{CC_STRING("_Alignas"), CC_TOKEN__ALIGNAS},
-	{CC_STRING("_Alignof"), CC_TOKEN__ALIGNOF},
-	{CC_STRING("_Complex"), CC_TOKEN__COMPLEX},
-	{CC_STRING("_Generic"), CC_TOKEN__GENERIC},
-	{CC_STRING("continue"), CC_TOKEN_CONTINUE},
-	{CC_STRING("register"), CC_TOKEN_REGISTER},
-	{CC_STRING("restrict"), CC_TOKEN_RESTRICT},
-	{CC_STRING("unsigned"), CC_TOKEN_UNSIGNED},
-	{CC_STRING("volatile"), CC_TOKEN_VOLATILE},
-	{CC_STRING("_Atomic"), CC_TOKEN__ATOMIC},
-	{CC_STRING("_BitInt"), CC_TOKEN__BIT_INT},
-	{CC_STRING("alignas"), CC_TOKEN_ALIGNAS},
-	{CC_STRING("alignof"), CC_TOKEN_ALIGNOF},
-	{CC_STRING("default"), CC_TOKEN_DEFAULT},
-	{CC_STRING("typedef"), CC_TOKEN_TYPEDEF},
-	{CC_STRING("double"), CC_TOKEN_DOUBLE},
-	{CC_STRING("extern"), CC_TOKEN_EXTERN},
-	{CC_STRING("return"), CC_TOKEN_RETURN},
-	{CC_STRING("signed"), CC_TOKEN_SIGNED},
-	{CC_STRING("sizeof"), CC_TOKEN_SIZEOF},
-	{CC_STRING("static"), CC_TOKEN_STATIC},
-	{CC_STRING("struct"), CC_TOKEN_STRUCT},
-	{CC_STRING("switch"), CC_TOKEN_SWITCH},
-	{CC_STRING("typeof"), CC_TOKEN_TYPEOF},
-	{CC_STRING("_Bool"), CC_TOKEN__BOOL},
-	{CC_STRING("break"), CC_TOKEN_BREAK},
-	{CC_STRING("const"), CC_TOKEN_CONST},
-	{CC_STRING("false"), CC_TOKEN_FALSE},
-	{CC_STRING("float"), CC_TOKEN_FLOAT},
-	{CC_STRING("short"), CC_TOKEN_SHORT},
-	{CC_STRING("union"), CC_TOKEN_UNION},
-	{CC_STRING("while"), CC_TOKEN_WHILE},
-	{CC_STRING("auto"), CC_TOKEN_AUTO},
-	{CC_STRING("bool"), CC_TOKEN_BOOL},
-	{CC_STRING("case"), CC_TOKEN_CASE},
-	{CC_STRING("char"), CC_TOKEN_CHAR},
-	{CC_STRING("else"), CC_TOKEN_ELSE},
-	{CC_STRING("enum"), CC_TOKEN_ENUM},
-	{CC_STRING("goto"), CC_TOKEN_GOTO},
-	{CC_STRING("long"), CC_TOKEN_LONG},
-	{CC_STRING("true"), CC_TOKEN_TRUE},
-	{CC_STRING("void"), CC_TOKEN_VOID},
-	{CC_STRING("for"), CC_TOKEN_FOR},
-	{CC_STRING("int"), CC_TOKEN_INT},
-	{CC_STRING("do"), CC_TOKEN_DO},
-	{CC_STRING("if"), CC_TOKEN_IF}
+/*
+ * A keyword.
+ *
+ * Fields:
+ * - string: The spelling of the keyword.
+ * - token: The token type of the keyword.
+ * - version: The first version of the C standard the keyword is part of.
+ */
+typedef struct CcKeyword
+{
+	CcConstString string;
+	CcTokenType token;
+	CcVersion version;
+} CcKeyword;
+
+// Bounds of the length of keywords, shorter or longer identifiers are not looked up.
+static constexpr size_t ccKeywordMinimumLength = 2;
+static constexpr size_t ccKeywordMaximumLength = 14;
+
+// Size of the keyword table, a power of two.
+static constexpr size_t ccKeywordTableSize = 256;
+
+/*
+ * Hash a keyword candidate into the keyword table.
+ * The hash is perfect over the keywords: each keyword gets its own slot, so a lookup is a single probe.
+ * Any change to the keywords must keep it collision-free and move the keywords to their new slots.
+ *
+ * Parameters:
+ * - string: An identifier, between ccKeywordMinimumLength and ccKeywordMaximumLength long.
+ *
+ * Returns:
+ * The slot of the identifier in the keyword table.
+ */
+static size_t ccHashKeyword(const CcStringView string)
+{
+	const unsigned char* const characters = (const unsigned char*)string.string;
+
+	return ((characters[0] + string.length) * 8 + characters[1] * 3 + characters[string.length - 1]) & (ccKeywordTableSize - 1);
+}
+
+// Keywords stored at the slot given by ccHashKeyword, empty slots have a length of 0.
+static const CcKeyword keywords[ccKeywordTableSize] = {
+	[1] = {CC_STRING("const"), CC_TOKEN_CONST, CC_C90},
+	[2] = {CC_STRING("double"), CC_TOKEN_DOUBLE, CC_C90},
+	[7] = {CC_STRING("for"), CC_TOKEN_FOR, CC_C90},
+	[10] = {CC_STRING("continue"), CC_TOKEN_CONTINUE, CC_C90},
+	[16] = {CC_STRING("float"), CC_TOKEN_FLOAT, CC_C90},
+	[20] = {CC_STRING("goto"), CC_TOKEN_GOTO, CC_C90},
+	[30] = {CC_STRING("int"), CC_TOKEN_INT, CC_C90},
+	[31] = {CC_STRING("constexpr"), CC_TOKEN_CONSTEXPR, CC_C23},
+	[46] = {CC_STRING("extern"), CC_TOKEN_EXTERN, CC_C90},
+	[52] = {CC_STRING("long"), CC_TOKEN_LONG, CC_C90},
+	[70] = {CC_STRING("_Decimal32"), CC_TOKEN__DECIMAL_32, CC_C23},
+	[72] = {CC_STRING("_Decimal64"), CC_TOKEN__DECIMAL_64, CC_C23},
+	[82] = {CC_STRING("_Bool"), CC_TOKEN__BOOL, CC_C99},
+	[84] = {CC_STRING("_Decimal128"), CC_TOKEN__DECIMAL_128, CC_C23},
+	[86] = {CC_STRING("_Atomic"), CC_TOKEN__ATOMIC, CC_C11},
+	[93] = {CC_STRING("return"), CC_TOKEN_RETURN, CC_C90},
+	[97] = {CC_STRING("_Alignof"), CC_TOKEN__ALIGNOF, CC_C11},
+	[103] = {CC_STRING("signed"), CC_TOKEN_SIGNED, CC_C90},
+	[105] = {CC_STRING("sizeof"), CC_TOKEN_SIZEOF, CC_C90},
+	[106] = {CC_STRING("_BitInt"), CC_TOKEN__BIT_INT, CC_C23},
+	[108] = {CC_STRING("short"), CC_TOKEN_SHORT, CC_C90},
+	[110] = {CC_STRING("_Alignas"), CC_TOKEN__ALIGNAS, CC_C11},
+	[112] = {CC_STRING("_Generic"), CC_TOKEN__GENERIC, CC_C11},
+	[113] = {CC_STRING("register"), CC_TOKEN_REGISTER, CC_C90},
+	[115] = {CC_STRING("restrict"), CC_TOKEN_RESTRICT, CC_C99},
+	[121] = {CC_STRING("_Complex"), CC_TOKEN__COMPLEX, CC_C99},
+	[123] = {CC_STRING("true"), CC_TOKEN_TRUE, CC_C23},
+	[125] = {CC_STRING("while"), CC_TOKEN_WHILE, CC_C90},
+	[129] = {CC_STRING("void"), CC_TOKEN_VOID, CC_C90},
+	[135] = {CC_STRING("static"), CC_TOKEN_STATIC, CC_C90},
+	[136] = {CC_STRING("union"), CC_TOKEN_UNION, CC_C90},
+	[149] = {CC_STRING("switch"), CC_TOKEN_SWITCH, CC_C90},
+	[150] = {CC_STRING("unsigned"), CC_TOKEN_UNSIGNED, CC_C90},
+	[152] = {CC_STRING("struct"), CC_TOKEN_STRUCT, CC_C90},
+	[156] = {CC_STRING("_Imaginary"), CC_TOKEN__IMAGINARY, CC_C99},
+	[161] = {CC_STRING("typeof"), CC_TOKEN_TYPEOF, CC_C23},
+	[162] = {CC_STRING("volatile"), CC_TOKEN_VOLATILE, CC_C90},
+	[164] = {CC_STRING("thread_local"), CC_TOKEN_THREAD_LOCAL, CC_C23},
+	[169] = {CC_STRING("typedef"), CC_TOKEN_TYPEDEF, CC_C90},
+	[192] = {CC_STRING("case"), CC_TOKEN_CASE, CC_C90},
+	[200] = {CC_STRING("_Thread_local"), CC_TOKEN__THREAD_LOCAL, CC_C11},
+	[208] = {CC_STRING("static_assert"), CC_TOKEN_STATIC_ASSERT, CC_C23},
+	[213] = {CC_STRING("_Static_assert"), CC_TOKEN__STATIC_ASSERT, CC_C11},
+	[223] = {CC_STRING("typeof_unqual"), CC_TOKEN_TYPEOF_UNQUAL, CC_C23},
+	[224] = {CC_STRING("false"), CC_TOKEN_FALSE, CC_C23},
+	[226] = {CC_STRING("char"), CC_TOKEN_CHAR, CC_C90},
+	[233] = {CC_STRING("bool"), CC_TOKEN_BOOL, CC_C23},
+	[234] = {CC_STRING("alignof"), CC_TOKEN_ALIGNOF, CC_C23},
+	[236] = {CC_STRING("do"), CC_TOKEN_DO, CC_C90},
+	[240] = {CC_STRING("if"), CC_TOKEN_IF, CC_C90},
+	[241] = {CC_STRING("else"), CC_TOKEN_ELSE, CC_C90},
+	[246] = {CC_STRING("auto"), CC_TOKEN_AUTO, CC_C90},
+	[247] = {CC_STRING("alignas"), CC_TOKEN_ALIGNAS, CC_C23},
+	[249] = {CC_STRING("break"), CC_TOKEN_BREAK, CC_C90},
+	[251] = {CC_STRING("default"), CC_TOKEN_DEFAULT, CC_C90},
+	[255] = {CC_STRING("enum"), CC_TOKEN_ENUM, CC_C90}
 };
-constexpr size_t keywordCount = CC_LEN(keywordMap);
-
-// Tokens must be stored from longest to shortest to avoid missing longer tokens (e.g. "+" and "=" instead of "+=").
-static const CcMapping tokens[] = {
-	{CC_STRING("<<="), CC_TOKEN_LEFT_SHIFT_EQUAL},
-	{CC_STRING(">>="), CC_TOKEN_RIGHT_SHIFT_EQUAL},
-	{CC_STRING("+="), CC_TOKEN_PLUS_EQUAL},
-	{CC_STRING("-="), CC_TOKEN_MINUS_EQUAL},
-	{CC_STRING("*="), CC_TOKEN_STAR_EQUAL},
-	{CC_STRING("/="), CC_TOKEN_SLASH_EQUAL},
-	{CC_STRING("%="), CC_TOKEN_PERCENT_EQUAL},
-	{CC_STRING("&="), CC_TOKEN_AMPERSAND_EQUAL},
-	{CC_STRING("|="), CC_TOKEN_BAR_EQUAL},
-	{CC_STRING("^="), CC_TOKEN_CARET_EQUAL},
-	{CC_STRING("<<"), CC_TOKEN_LEFT_SHIFT},
-	{CC_STRING(">>"), CC_TOKEN_RIGHT_SHIFT},
-	{CC_STRING("++"), CC_TOKEN_PLUS_PLUS},
-	{CC_STRING("--"), CC_TOKEN_MINUS_MINUS},
-	{CC_STRING("=="), CC_TOKEN_EQUAL_EQUAL},
-	{CC_STRING("!="), CC_TOKEN_NOT_EQUAL},
-	{CC_STRING("<="), CC_TOKEN_LESS_EQUAL},
-	{CC_STRING(">="), CC_TOKEN_GREATER_EQUAL},
-	{CC_STRING("&&"), CC_TOKEN_AMPERSAND_AMPERSAND},
-	{CC_STRING("||"), CC_TOKEN_BAR_BAR},
-	{CC_STRING("->"), CC_TOKEN_ARROW},
-	{CC_STRING("("), CC_TOKEN_OPEN_PARENTHESIS},
-	{CC_STRING(")"), CC_TOKEN_CLOSE_PARENTHESIS},
-	{CC_STRING("{"), CC_TOKEN_OPEN_BRACE},
-	{CC_STRING("}"), CC_TOKEN_CLOSE_BRACE},
-	{CC_STRING("["), CC_TOKEN_OPEN_BRACKET},
-	{CC_STRING("]"), CC_TOKEN_CLOSE_BRACKET},
-	{CC_STRING(";"), CC_TOKEN_SEMICOLON},
-	{CC_STRING("+"), CC_TOKEN_PLUS},
-	{CC_STRING("-"), CC_TOKEN_MINUS},
-	{CC_STRING("*"), CC_TOKEN_STAR},
-	{CC_STRING("/"), CC_TOKEN_SLASH},
-	{CC_STRING("%"), CC_TOKEN_PERCENT},
-	{CC_STRING("&"), CC_TOKEN_AMPERSAND},
-	{CC_STRING("|"), CC_TOKEN_BAR},
-	{CC_STRING("^"), CC_TOKEN_CARET},
-	{CC_STRING("~"), CC_TOKEN_TILDE},
-	{CC_STRING("="), CC_TOKEN_EQUAL},
-	{CC_STRING("<"), CC_TOKEN_LESS},
-	{CC_STRING(">"), CC_TOKEN_GREATER},
-	{CC_STRING("!"), CC_TOKEN_EXCLAMATION},
-	{CC_STRING("?"), CC_TOKEN_QUESTION},
-	{CC_STRING(","), CC_TOKEN_COMMA},
-	{CC_STRING("."), CC_TOKEN_DOT},
-	{CC_STRING(":"), CC_TOKEN_COLON}
+
+// Maximum number of punctuators starting with the same character.
+static constexpr size_t ccPunctuatorCandidateCount = 4;
+
+// Punctuators indexed by their first character, each row is stored from longest to shortest to avoid missing longer tokens (e.g. "+" instead of "+=").
+// Rows end at the first entry of length 0.
+static const CcMapping punctuators[UCHAR_MAX + 1][ccPunctuatorCandidateCount] = {
+	['<'] = {
+		{CC_STRING("<<="), CC_TOKEN_LEFT_SHIFT_EQUAL},
+		{CC_STRING("<<"), CC_TOKEN_LEFT_SHIFT},
+		{CC_STRING("<="), CC_TOKEN_LESS_EQUAL},
+		{CC_STRING("<"), CC_TOKEN_LESS}
+	},
+	['>'] = {
+		{CC_STRING(">>="), CC_TOKEN_RIGHT_SHIFT_EQUAL},
+		{CC_STRING(">>"), CC_TOKEN_RIGHT_SHIFT},
+		{CC_STRING(">="), CC_TOKEN_GREATER_EQUAL},
+		{CC_STRING(">"), CC_TOKEN_GREATER}
+	},
+	['+'] = {
+		{CC_STRING("+="), CC_TOKEN_PLUS_EQUAL},
+		{CC_STRING("++"), CC_TOKEN_PLUS_PLUS},
+		{CC_STRING("+"), CC_TOKEN_PLUS}
+	},
+	['-'] = {
+		{CC_STRING("-="), CC_TOKEN_MINUS_EQUAL},
+		{CC_STRING("--"), CC_TOKEN_MINUS_MINUS},
+		{CC_STRING("->"), CC_TOKEN_ARROW},
+		{CC_STRING("-"), CC_TOKEN_MINUS}
+	},
+	['*'] = {
+		{CC_STRING("*="), CC_TOKEN_STAR_EQUAL},
+		{CC_STRING("*"), CC_TOKEN_STAR}
+	},
+	['/'] = {
+		{CC_STRING("/="), CC_TOKEN_SLASH_EQUAL},
+		{CC_STRING("/"), CC_TOKEN_SLASH}
+	},
+	['%'] = {
+		{CC_STRING("%="), CC_TOKEN_PERCENT_EQUAL},
+		{CC_STRING("%"), CC_TOKEN_PERCENT}
+	},
+	['&'] = {
+		{CC_STRING("&="), CC_TOKEN_AMPERSAND_EQUAL},
+		{CC_STRING("&&"), CC_TOKEN_AMPERSAND_AMPERSAND},
+		{CC_STRING("&"), CC_TOKEN_AMPERSAND}
+	},
+	['|'] = {
+		{CC_STRING("|="), CC_TOKEN_BAR_EQUAL},
+		{CC_STRING("||"), CC_TOKEN_BAR_BAR},
+		{CC_STRING("|"), CC_TOKEN_BAR}
+	},
+	['^'] = {
+		{CC_STRING("^="), CC_TOKEN_CARET_EQUAL},
+		{CC_STRING("^"), CC_TOKEN_CARET}
+	},
+	['='] = {
+		{CC_STRING("=="), CC_TOKEN_EQUAL_EQUAL},
+		{CC_STRING("="), CC_TOKEN_EQUAL}
+	},
+	['!'] = {
+		{CC_STRING("!="), CC_TOKEN_NOT_EQUAL},
+		{CC_STRING("!"), CC_TOKEN_EXCLAMATION}
+	},
+	['('] = {{CC_STRING("("), CC_TOKEN_OPEN_PARENTHESIS}},
+	[')'] = {{CC_STRING(")"), CC_TOKEN_CLOSE_PARENTHESIS}},
+	['{'] = {{CC_STRING("{"), CC_TOKEN_OPEN_BRACE}},
+	['}'] = {{CC_STRING("}"), CC_TOKEN_CLOSE_BRACE}},
+	['['] = {{CC_STRING("["), CC_TOKEN_OPEN_BRACKET}},
+	[']'] = {{CC_STRING("]"), CC_TOKEN_CLOSE_BRACKET}},
+	[';'] = {{CC_STRING(";"), CC_TOKEN_SEMICOLON}},
+	['~'] = {{CC_STRING("~"), CC_TOKEN_TILDE}},
+	['?'] = {{CC_STRING("?"), CC_TOKEN_QUESTION}},
+	[','] = {{CC_STRING(","), CC_TOKEN_COMMA}},
+	['.'] = {{CC_STRING("."), CC_TOKEN_DOT}},
+	[':'] = {{CC_STRING(":"), CC_TOKEN_COLON}}
 };
-constexpr size_t tokenCount = CC_LEN(tokens);
-constexpr size_t tokenSize = sizeof(tokens[0]);
 
 #define CC_TOKEN_CASE(name) \
 	case CC_TOKEN_##name: \
@@ -154,50 +222,6 @@ bool ccIsKeyword(const CcTokenType type)
 	return type >= CC_TOKEN_VOID && type <= CC_TOKEN_GOTO;
 }
 
-/*
- * Check for token string equality.
- *
- * Parameters:
- * - pStringVoid: A string.
- * - pTokenVoid: A pointer to a CcConstString which is the token string.
- *
- * Returns:
- * - 0 if the strings are equal.
- * - 1 otherwise.
- */
-static int ccCompareToken(const void* const stringVoid, const void* const pTokenVoid)
-{
-	const char* const string = stringVoid;
-	const CcConstString* const pToken = pTokenVoid;
-
-	return strncmp(pToken->string, string, pToken->length);
-}
-
-/*
- * Check for two strings equality.
- *
- * Parameters:
- * - pStringVoid: A pointer to a CcConstString to test.
- * - pKeywordVoid: A pointer to a keyword CcConstString.
- *
- * Returns:
- * - 0 if the strings are equal.
- * - -1 if the string is before the keyword.
- * - 1 if the string is after the keyword.
- */
-static int ccCompareString(const void* const pStringVoid, const void* const pKeywordVoid)
-{
-	const CcConstString* const pString = pStringVoid;
-	const CcConstString* const pKeyword = pKeywordVoid;
-
-	if(pString->length != pKeyword->length)
-	{
-		return (pString->length < pKeyword->length) - (pString->length > pKeyword->length);
-	}
-
-	return strncmp(pString->string, pKeyword->string, pString->length);
-}
-
 /*
  * Pop a character from a string.
  *
@@ -219,10 +243,7 @@ static void ccPop(CcConstString* const pString, const size_t count)
  */
 static void ccSkipSpaces(CcConstString* const pString)
 {
-	while(isspace((unsigned char)*pString->string))
-	{
-		ccPop(pString, 1);
-	}
+	ccPop(pString, ccScanSpaces(pString->string));
 }
 
 bool ccParseString(const char* string, CcToken* const pToken)
@@ -242,9 +263,9 @@ bool ccParseString(const char* string, CcToken* const pToken)
 
 	while(*string != '\0' && (*string != '"' || *(string - 1) == '\\'))
 	{
-		if(!isprint((unsigned char)*string))
+		if(!(ccCharacterClasses[(unsigned char)*string] & CC_CHARACTER_PRINTABLE))
 		{
-			fprintf(stderr, "Invalid character in string literal.\n");
+			ccReportDiagnostic(CC_DIAGNOSTIC_INVALID_STRING_CHARACTER, string);
 		}
 
 		++string;
@@ -255,7 +276,7 @@ bool ccParseString(const char* string, CcToken* const pToken)
 	}
 	else
 	{
-		fprintf(stderr, "Unfinished string literal.\n");
+		ccReportDiagnostic(CC_DIAGNOSTIC_UNFINISHED_STRING, pToken->string.string);
 	}
 
 	pToken->string.length = string - pToken->string.string;
@@ -286,7 +307,7 @@ bool ccParseCharacter(const char* string, CcToken* const pToken)
 		(string[0] == '\\' && (string[1] == '\0' || string[2] != '\''))
 	)
 	{
-		fprintf(stderr, "Invalid character constant.\n");
+		ccReportDiagnostic(CC_DIAGNOSTIC_INVALID_CHARACTER_CONSTANT, string - 1);
 		return false;
 	}
 
@@ -306,45 +327,192 @@ bool ccParseToken(const char* const string, CcToken* const pToken)
 	assert(string != nullptr);
 	assert(pToken != nullptr);
 
-	const CcMapping* const pMapping = ccFind(string, tokens, tokenCount, tokenSize, ccCompareToken);
-	if(!pMapping)
+	// The first character selects the candidates, the others are compared one by one and stop at the end of the string.
+	const CcMapping* const candidates = punctuators[(unsigned char)*string];
+	for(size_t candidateIndex = 0; candidateIndex < ccPunctuatorCandidateCount; ++candidateIndex)
 	{
-		return false;
+		const CcMapping* const pCandidate = &candidates[candidateIndex];
+		if(pCandidate->string.length == 0)
+		{
+			return false;
+		}
+
+		size_t characterIndex = 1;
+		while(characterIndex < pCandidate->string.length && string[characterIndex] == pCandidate->string.string[characterIndex])
+		{
+			++characterIndex;
+		}
+
+		if(characterIndex == pCandidate->string.length)
+		{
+			pToken->type = pCandidate->token;
+			pToken->string.string = string;
+			pToken->string.length = pCandidate->string.length;
+
+			return true;
+		}
 	}
 
-	pToken->type = pMapping->token;
-	pToken->string.string = string;
-	pToken->string.length = pMapping->string.length;
+	return false;
+}
 
-	return true;
+/*
+ * Convert an ASCII letter to lower case, whatever the locale.
+ * Other characters may change, but never into a letter.
+ *
+ * Parameters:
+ * - character: The character to convert.
+ *
+ * Returns:
+ * The lower case letter if the character is a letter.
+ */
+static unsigned char ccToLower(const unsigned char character)
+{
+	return character | 0x20;
 }
 
 /*
- * Check if a character is a digit in some base.
+ * Get the class of the digits in some base.
  *
  * Parameters:
- * - character: The character to test.
  * - base: The base, should be 2, 8, 10 or 16.
  *
  * Returns:
- * - true if the character is a digit in the given base.
- * - false otherwise.
+ * The class of the digits in the given base.
+ */
+static CcCharacterClass ccDigitClass(const unsigned char base)
+{
+	switch(base)
+	{
+		case 2:
+			return CC_CHARACTER_BINARY_DIGIT;
+
+		case 8:
+			return CC_CHARACTER_OCTAL_DIGIT;
+
+		case 16:
+			return CC_CHARACTER_HEXADECIMAL_DIGIT;
+
+		default:
+			return CC_CHARACTER_DECIMAL_DIGIT;
+	}
+}
+
+// Number of digits converted at once by ccParseConstant.
+static constexpr size_t ccDigitBlockSize = 8;
+
+/*
+ * Get the value of a block of digits.
+ * The digits are combined in the lanes of a 64-bit word: by pairs, then pairs of pairs, then the two halves.
+ *
+ * Parameters:
+ * - digits: ccDigitBlockSize digits in the given base, the most significant first.
+ * - base: The base, 2, 8, 10 or 16.
+ *
+ * Returns:
+ * The value of the digits.
  */
-static bool ccIsDigit(const char character, const unsigned char base)
+static uint64_t ccParseDigitBlock(const unsigned char* const digits, const uint64_t base)
 {
-	static constexpr char digits[16] = "0123456789ABCDEF";
+	// The first digit goes to the lowest byte whatever the byte order, compilers merge this into a single load.
+	uint64_t word = 0;
+	for(size_t digitIndex = 0; digitIndex < ccDigitBlockSize; ++digitIndex)
+	{
+		word |= (uint64_t)digits[digitIndex] << (8 * digitIndex);
+	}
+
+	// Hexadecimal letters have their bit 6 set and a low nibble 9 below their value.
+	word = (word & 0x0F0F0F0F0F0F0F0F) + ((word >> 6) & 0x0101010101010101) * 9;
+
+	word = (word & 0x00FF00FF00FF00FF) * base + ((word >> 8) & 0x00FF00FF00FF00FF);
+	word = (word & 0x0000FFFF0000FFFF) * (base * base) + ((word >> 16) & 0x0000FFFF0000FFFF);
 
-	const char upperCharacter = toupper((unsigned char)character);
+	return (word & 0x00000000FFFFFFFF) * (base * base * base * base) + (word >> 32);
+}
 
-	for(unsigned char digitIndex = 0; digitIndex < base; ++digitIndex)
+/*
+ * Promote the type of an integer constant to the next type of its promotion list.
+ *
+ * Parameters:
+ * - pType: A pointer to the type of the constant.
+ * - pMaximum: A pointer to the largest value of the type.
+ * - base: The base of the constant.
+ * - isUnsigned: Whether the constant has an unsigned suffix.
+ *
+ * Returns:
+ * - true if the type is promoted.
+ * - false if there is no larger type.
+ */
+static bool ccPromoteConstant(CcConstantType* const pType, unsigned long long* const pMaximum, const unsigned char base, const bool isUnsigned)
+{
+	if(*pMaximum == LLONG_MAX && base != 10 && !isUnsigned)
 	{
-		if(upperCharacter == digits[digitIndex])
+		*pMaximum = ULLONG_MAX;
+		*pType = CC_CONSTANT_UNSIGNED_LONG_LONG;
+	}
+	else if(*pMaximum == ULLONG_MAX || *pMaximum == LLONG_MAX)
+	{
+		return false;
+	}
+	else if(*pMaximum == ULONG_MAX)
+	{
+		if(base == 10 || isUnsigned)
 		{
-			return true;
+			*pMaximum = ULLONG_MAX;
+			*pType = CC_CONSTANT_UNSIGNED_LONG_LONG;
+		}
+		else
+		{
+			*pMaximum = LLONG_MAX;
+			*pType = CC_CONSTANT_LONG_LONG;
+		}
+	}
+	else if(*pMaximum == LONG_MAX)
+	{
+		if(base == 10)
+		{
+			*pMaximum = LLONG_MAX;
+			*pType = CC_CONSTANT_LONG_LONG;
+		}
+		else
+		{
+			*pMaximum = ULONG_MAX;
+			*pType = CC_CONSTANT_UNSIGNED_LONG;
 		}
 	}
+	else if(*pMaximum == UINT_MAX)
+	{
+		if(base == 10 || isUnsigned)
+		{
+			*pMaximum = ULONG_MAX;
+			*pType = CC_CONSTANT_UNSIGNED_LONG;
+		}
+		else
+		{
+			*pMaximum = LONG_MAX;
+			*pType = CC_CONSTANT_LONG;
+		}
+	}
+	else if(*pMaximum == INT_MAX)
+	{
+		if(base == 10)
+		{
+			*pMaximum = LONG_MAX;
+			*pType = CC_CONSTANT_LONG;
+		}
+		else
+		{
+			*pMaximum = UINT_MAX;
+			*pType = CC_CONSTANT_UNSIGNED_INT;
+		}
+	}
+	else
+	{
+		ccDiagnose("Should not happen.");
+		return false;
+	}
 
-	return false;
+	return true;
 }
 
 bool ccParseConstant(const char* string, CcToken* const pToken)
@@ -352,7 +520,7 @@ bool ccParseConstant(const char* string, CcToken* const pToken)
 	assert(string != nullptr);
 	assert(pToken != nullptr);
 
-	if(!isdigit((unsigned char)*string))
+	if(!(ccCharacterClasses[(unsigned char)*string] & CC_CHARACTER_DECIMAL_DIGIT))
 	{
 		return false;
 	}
@@ -365,37 +533,40 @@ bool ccParseConstant(const char* string, CcToken* const pToken)
 
 	if(string[0] == '0')
 	{
-		if(tolower((unsigned char)string[1]) == 'x')
+		if(ccToLower(string[1]) == 'x')
 		{
 			base = 16;
 			string += 2;
 		}
-		else if(tolower((unsigned char)string[1]) == 'b')
+		else if(ccToLower(string[1]) == 'b')
 		{
 			base = 2;
 			string += 2;
 		}
-		else if(isdigit((unsigned char)string[1]))
+		else if(ccCharacterClasses[(unsigned char)string[1]] & CC_CHARACTER_DECIMAL_DIGIT)
 		{
 			base = 8;
 			++string;
 		}
 	}
 
+	const CcCharacterClass digitClass = ccDigitClass(base);
+	constexpr unsigned short alphanumericClass = CC_CHARACTER_LETTER | CC_CHARACTER_DECIMAL_DIGIT;
+
 	CcConstantType type = CC_CONSTANT_INT;
 
 	const unsigned char* temp = (const unsigned char*)string;
-	while(ccIsDigit(*temp, base))
+	while(ccCharacterClasses[*temp] & digitClass)
 	{
 		++temp;
 	}
-	if(isalpha(*temp))
+	if(ccCharacterClasses[*temp] & CC_CHARACTER_LETTER)
 	{
 		if(
 			(
-				(tolower(temp[0]) == 'u' && tolower(temp[1]) == 'l' && temp[2] == temp[1]) ||
-				(tolower(temp[0]) == 'l' && temp[1] == temp[0] && tolower(temp[2]) == 'u')
-			) && !isalnum(temp[3])
+				(ccToLower(temp[0]) == 'u' && ccToLower(temp[1]) == 'l' && temp[2] == temp[1]) ||
+				(ccToLower(temp[0]) == 'l' && temp[1] == temp[0] && ccToLower(temp[2]) == 'u')
+			) && !(ccCharacterClasses[temp[3]] & alphanumericClass)
 		)
 		{
 			type = CC_CONSTANT_UNSIGNED_LONG_LONG;
@@ -403,30 +574,30 @@ bool ccParseConstant(const char* string, CcToken* const pToken)
 
 		else if(
 			(
-				(tolower(temp[0]) == 'u' && tolower(temp[1]) == 'l') ||
-				(tolower(temp[0]) == 'l' && tolower(temp[1]) == 'u')
-			) && !isalnum(temp[2])
+				(ccToLower(temp[0]) == 'u' && ccToLower(temp[1]) == 'l') ||
+				(ccToLower(temp[0]) == 'l' && ccToLower(temp[1]) == 'u')
+			) && !(ccCharacterClasses[temp[2]] & alphanumericClass)
 		)
 		{
 			type = CC_CONSTANT_UNSIGNED_LONG;
 		}
 
 		else if(
-			tolower(temp[0]) == 'u' && !isalnum(temp[1])
+			ccToLower(temp[0]) == 'u' && !(ccCharacterClasses[temp[1]] & alphanumericClass)
 		)
 		{
 			type = CC_CONSTANT_UNSIGNED_INT;
 		}
 
 		else if(
-			tolower(temp[0]) == 'l' && temp[1] == temp[0] && !isalnum(temp[2])
+			ccToLower(temp[0]) == 'l' && temp[1] == temp[0] && !(ccCharacterClasses[temp[2]] & alphanumericClass)
 		)
 		{
 			type = CC_CONSTANT_LONG_LONG;
 		}
 
 		else if(
-			tolower(temp[0]) == 'l' && !isalnum(temp[1])
+			ccToLower(temp[0]) == 'l' && !(ccCharacterClasses[temp[1]] & alphanumericClass)
 		)
 		{
 			type = CC_CONSTANT_LONG;
@@ -434,128 +605,85 @@ bool ccParseConstant(const char* string, CcToken* const pToken)
 
 		else
 		{
-			fprintf(stderr, "Invalid integer literal suffix.\n");
+			ccReportDiagnostic(CC_DIAGNOSTIC_INVALID_INTEGER_SUFFIX, (const char*)temp);
 		}
 	}
 
 	const bool isUnsigned = type >= CC_CONSTANT_UNSIGNED_INT;
 
-	unsigned long long compare = INT_MAX;
+	unsigned long long maximum = INT_MAX;
 	switch(type)
 	{
 		case CC_CONSTANT_UNSIGNED_LONG_LONG:
-			compare = ULLONG_MAX;
+			maximum = ULLONG_MAX;
 			break;
 
 		case CC_CONSTANT_UNSIGNED_LONG:
-			compare = ULONG_MAX;
+			maximum = ULONG_MAX;
 			break;
 
 		case CC_CONSTANT_UNSIGNED_INT:
-			compare = UINT_MAX;
+			maximum = UINT_MAX;
 			break;
 
 		case CC_CONSTANT_LONG_LONG:
-			compare = LLONG_MAX;
+			maximum = LLONG_MAX;
 			break;
 
 		case CC_CONSTANT_LONG:
-			compare = LONG_MAX;
+			maximum = LONG_MAX;
 			break;
 
 		case CC_CONSTANT_INT:
-			compare = INT_MAX;
+			maximum = INT_MAX;
 			break;
 
 		default:
-			fprintf(stderr, "Unreachable.\n");
+			ccDiagnose("Unreachable.");
 			break;
 	}
 
-	pToken->constant.value = 0;
+	// Digits are converted a block at a time, the first block taking the digits left over and padded with zeros.
+	const unsigned char* const digits = (const unsigned char*)string;
+	const size_t digitCount = temp - digits;
+
+	const uint64_t blockScale = (uint64_t)base * base * base * base * base * base * base * base;
 
-	while(ccIsDigit(*string, base))
+	unsigned long long value = 0;
+	bool tooLarge = false;
+	for(size_t digitIndex = 0, blockLength = (digitCount - 1) % ccDigitBlockSize + 1; digitIndex < digitCount; digitIndex += blockLength, blockLength = ccDigitBlockSize)
 	{
-		const unsigned char c = ('0' <= *string && *string <= '9') ? *string - '0' : (unsigned char)(tolower((unsigned char)*string) - 'a' + 10);
-		++string;
+		const unsigned char* pBlock = digits + digitIndex;
 
-		while(pToken->constant.value > (compare - c) / base)
+		unsigned char block[ccDigitBlockSize];
+		if(blockLength < ccDigitBlockSize)
 		{
-			if(compare == LLONG_MAX && base != 10 && !isUnsigned)
-			{
-				compare = ULLONG_MAX;
-				type = CC_CONSTANT_UNSIGNED_LONG_LONG;
-			}
-			else if(compare == ULLONG_MAX || compare == LLONG_MAX)
-			{
-				fprintf(stderr, "Integer literal too large.\n");
-				break;
-			}
-			else if(compare == ULONG_MAX)
-			{
-				if(base == 10 || isUnsigned)
-				{
-					compare = ULLONG_MAX;
-					type = CC_CONSTANT_UNSIGNED_LONG_LONG;
-				}
-				else
-				{
-					compare = LLONG_MAX;
-					type = CC_CONSTANT_LONG_LONG;
-				}
-			}
-			else if(compare == LONG_MAX)
-			{
-				if(base == 10)
-				{
-					compare = LLONG_MAX;
-					type = CC_CONSTANT_LONG_LONG;
-				}
-				else
-				{
-					compare = ULONG_MAX;
-					type = CC_CONSTANT_UNSIGNED_LONG;
-				}
-			}
-			else if(compare == UINT_MAX)
-			{
-				if(base == 10 || isUnsigned)
-				{
-					compare = ULONG_MAX;
-					type = CC_CONSTANT_UNSIGNED_LONG;
-				}
-				else
-				{
-					compare = LONG_MAX;
-					type = CC_CONSTANT_LONG;
-				}
-			}
-			else if(compare == INT_MAX)
-			{
-				if(base == 10)
-				{
-					compare = LONG_MAX;
-					type = CC_CONSTANT_LONG;
-				}
-				else
-				{
-					compare = UINT_MAX;
-					type = CC_CONSTANT_UNSIGNED_INT;
-				}
-			}
-			else
-			{
-				fprintf(stderr, "Should not happen.\n");
-			}
+			memset(block, '0', ccDigitBlockSize - blockLength);
+			memcpy(block + ccDigitBlockSize - blockLength, pBlock, blockLength);
+			pBlock = block;
 		}
 
-		pToken->constant.value *= base;
-		pToken->constant.value += c;
+		// The value wraps like the digits were added one by one once it is too large.
+		tooLarge = ckd_mul(&value, value, blockScale) || tooLarge;
+		tooLarge = ckd_add(&value, value, ccParseDigitBlock(pBlock, base)) || tooLarge;
+	}
+	string += digitCount;
+
+	pToken->constant.value = value;
+
+	// The value only grows with each digit, so the type is the first promotion of the suffix type holding the whole value.
+	while(tooLarge || value > maximum)
+	{
+		if(!ccPromoteConstant(&type, &maximum, base, isUnsigned))
+		{
+			ccReportDiagnostic(CC_DIAGNOSTIC_INTEGER_TOO_LARGE, pToken->string.string);
+			break;
+		}
 	}
 
 	pToken->constant.type = type;
 
-	while(isalnum((unsigned char)*string))
+	while(ccCharacterClasses[(unsigned char)*string] & alphanumericClass)
 	{
 		++string;
 	}
@@ -565,12 +693,12 @@ bool ccParseConstant(const char* string, CcToken* const pToken)
 	return true;
 }
 
-bool ccParseIdentifier(const char* string, CcToken* const pToken)
+bool ccParseIdentifier(const char* const string, const CcVersion version, CcToken* const pToken)
 {
 	assert(string != nullptr);
 	assert(pToken != nullptr);
 
-	if(!isalpha((unsigned char)*string) && *string != '_')
+	if(!(ccCharacterClasses[(unsigned char)*string] & CC_CHARACTER_IDENTIFIER_START))
 	{
 		return false;
 	}
@@ -578,16 +706,20 @@ bool ccParseIdentifier(const char* string, CcToken* const pToken)
 	pToken->type = CC_TOKEN_IDENTIFIER;
 	pToken->string.string = string;
 
-	++string;
-	while(isalnum((unsigned char)*string) || *string == '_')
+	pToken->string.length = 1 + ccScanIdentifier(string + 1);
+
+	if(pToken->string.length < ccKeywordMinimumLength || pToken->string.length > ccKeywordMaximumLength)
 	{
-		++string;
+		return true;
 	}
 
-	pToken->string.length = string - pToken->string.string;
-
-	CcMapping* const pKeyword = bsearch(&pToken->string, keywordMap, keywordCount, sizeof(keywordMap[0]), ccCompareString);
-	if(pKeyword)
+	// Keywords of later versions of the standard are identifiers.
+	const CcKeyword* const pKeyword = &keywords[ccHashKeyword(pToken->string)];
+	if(
+		pKeyword->string.length == pToken->string.length &&
+		pKeyword->version <= version &&
+		memcmp(pKeyword->string.string, pToken->string.string, pToken->string.length) == 0
+	)
 	{
 		pToken->type = pKeyword->token;
 	}
@@ -595,98 +727,1578 @@ bool ccParseIdentifier(const char* string, CcToken* const pToken)
 	return true;
 }
 
-CcResult ccLex(CcConstString string, CcTokenList* const pTokenList)
+/*
+ * The class of the first byte of a token, selecting the recognizer of the token.
+ */
+typedef enum CcLexClass
 {
-	// Validate arguments.
-	assert(string.string != nullptr);
-	assert(string.length == strlen(string.string));
-	assert(pTokenList != nullptr);
+	CC_LEX_CLASS_INVALID,
+	CC_LEX_CLASS_STRING,
+	CC_LEX_CLASS_CHARACTER,
+	CC_LEX_CLASS_PUNCTUATOR,
+	CC_LEX_CLASS_CONSTANT,
+	CC_LEX_CLASS_IDENTIFIER
+} CcLexClass;
 
-	pTokenList->count = 0;
+// Maximum number of states of the punctuator automaton, including the start state.
+static constexpr size_t ccPunctuatorStateCount = 64;
 
-	if(string.length == 0)
-	{
-		pTokenList->tokens = nullptr;
+// Maximum number of byte classes of the punctuator automaton, class 0 holding the bytes no punctuator contains.
+static constexpr size_t ccPunctuatorClassCount = 32;
 
-		return CC_SUCCESS;
-	}
+/*
+ * The tables driving the lexer, generated from the mapping tables.
+ *
+ * Fields:
+ * - classes: The CcLexClass of each byte starting a token.
+ * - punctuatorClasses: The class of each byte in the punctuator automaton.
+ * - transitions: The next state of the punctuator automaton by state and byte class, 0 if the automaton stops.
+ * - accepting: Whether each state of the punctuator automaton ends a punctuator.
+ * - tokens: The punctuator ending at each accepting state.
+ */
+typedef struct CcLexTables
+{
+	unsigned char classes[UCHAR_MAX + 1];
 
-	if(ccSizeMax / sizeof(pTokenList->tokens[0]) < string.length)
-	{
-		return CC_ERROR_OUT_OF_MEMORY;
-	}
+	unsigned char punctuatorClasses[UCHAR_MAX + 1];
+	unsigned char transitions[ccPunctuatorStateCount][ccPunctuatorClassCount];
+	bool accepting[ccPunctuatorStateCount];
+	CcTokenType tokens[ccPunctuatorStateCount];
+} CcLexTables;
+
+static CcLexTables ccLexTables;
+
+static once_flag ccLexTablesOnce = ONCE_FLAG_INIT;
 
-	pTokenList->tokens = malloc(string.length * sizeof(pTokenList->tokens[0]));
-	if(!pTokenList->tokens)
+/*
+ * Build the lexer tables.
+ * Each punctuator adds its path to the automaton, a trie whose states are the prefixes of punctuators.
+ */
+static void ccBuildLexTables(void)
+{
+	CcLexTables* const pTables = &ccLexTables;
+
+	size_t stateCount = 1;
+	size_t classCount = 1;
+	for(size_t first = 0; first <= UCHAR_MAX; ++first)
 	{
-		fprintf(stderr, "Failed to allocate memory.\n");
-		return CC_ERROR_OUT_OF_MEMORY;
+		for(size_t candidateIndex = 0; candidateIndex < ccPunctuatorCandidateCount && punctuators[first][candidateIndex].string.length > 0; ++candidateIndex)
+		{
+			const CcMapping* const pMapping = &punctuators[first][candidateIndex];
+
+			size_t state = 0;
+			for(size_t characterIndex = 0; characterIndex < pMapping->string.length; ++characterIndex)
+			{
+				const unsigned char character = pMapping->string.string[characterIndex];
+				if(pTables->punctuatorClasses[character] == 0)
+				{
+					assert(classCount < ccPunctuatorClassCount);
+					pTables->punctuatorClasses[character] = classCount++;
+				}
+
+				unsigned char* const pNext = &pTables->transitions[state][pTables->punctuatorClasses[character]];
+				if(*pNext == 0)
+				{
+					assert(stateCount < ccPunctuatorStateCount);
+					*pNext = stateCount++;
+				}
+				state = *pNext;
+			}
+
+			pTables->accepting[state] = true;
+			pTables->tokens[state] = pMapping->token;
+		}
 	}
 
-	while(*string.string)
+	for(size_t character = 0; character <= UCHAR_MAX; ++character)
 	{
-		ccSkipSpaces(&string);
-		if(!*string.string)
+		if(character == '"')
 		{
-			break;
+			pTables->classes[character] = CC_LEX_CLASS_STRING;
 		}
-
-		if(ccParseString(string.string, &pTokenList->tokens[pTokenList->count]))
+		else if(character == '\'')
 		{
-			goto add;
+			pTables->classes[character] = CC_LEX_CLASS_CHARACTER;
 		}
-
-		if(ccParseCharacter(string.string, &pTokenList->tokens[pTokenList->count]))
+		else if(pTables->transitions[0][pTables->punctuatorClasses[character]] != 0)
 		{
-			goto add;
+			pTables->classes[character] = CC_LEX_CLASS_PUNCTUATOR;
 		}
-
-		if(ccParseToken(string.string, &pTokenList->tokens[pTokenList->count]))
+		else if(ccCharacterClasses[character] & CC_CHARACTER_DECIMAL_DIGIT)
 		{
-			goto add;
+			pTables->classes[character] = CC_LEX_CLASS_CONSTANT;
 		}
-
-		if(ccParseConstant(string.string, &pTokenList->tokens[pTokenList->count]))
+		else if(ccCharacterClasses[character] & CC_CHARACTER_IDENTIFIER_START)
 		{
-			goto add;
+			pTables->classes[character] = CC_LEX_CLASS_IDENTIFIER;
 		}
+	}
+}
 
-		if(ccParseIdentifier(string.string, &pTokenList->tokens[pTokenList->count]))
+/*
+ * Lex a punctuator by running the punctuator automaton.
+ * The automaton runs as long as it has a transition, the last accepting state it went through gives the longest punctuator.
+ *
+ * Parameters:
+ * - string: The string to lex.
+ * - pToken: A pointer to the token.
+ *
+ * Returns:
+ * - true if a punctuator starts the string.
+ * - false otherwise.
+ */
+static bool ccLexPunctuator(const char* const string, CcToken* const pToken)
+{
+	bool accepted = false;
+
+	size_t state = 0;
+	size_t length = 0;
+	while(true)
+	{
+		// The null terminator is in class 0, which has no transition.
+		const size_t next = ccLexTables.transitions[state][ccLexTables.punctuatorClasses[(unsigned char)string[length]]];
+		if(next == 0)
 		{
-			goto add;
+			break;
 		}
 
-		fprintf(stderr, "Unexpected token.\n");
-		ccPop(&string, 1);
-		continue;
-
-		add:
-		pTokenList->tokens[pTokenList->count].string.string = string.string;
-		ccPop(&string, pTokenList->tokens[pTokenList->count].string.length);
-		++pTokenList->count;
-	}
+		state = next;
+		++length;
 
-	if(pTokenList->count == 0)
-	{
-		CC_FREE(pTokenList->tokens);
-	}
-	else
-	{
-		CcToken* const newTokens = realloc(pTokenList->tokens, pTokenList->count * sizeof(pTokenList->tokens[0]));
-		if(!newTokens)
+		if(ccLexTables.accepting[state])
 		{
-			return CC_ERROR_UNKNOWN;
+			pToken->type = ccLexTables.tokens[state];
+			pToken->string.length = length;
+			accepted = true;
 		}
-		pTokenList->tokens = newTokens;
 	}
 
-	return CC_SUCCESS;
+	pToken->string.string = string;
+
+	return accepted;
 }
 
-void ccFreeTokenList(CcTokenList* const pTokenList)
+/*
+ * Lex the token at the start of a string.
+ * The class of its first byte selects the only recognizer that can match it, so each token is read in one pass.
+ *
+ * Parameters:
+ * - string: A string, not starting with a space.
+ * - version: The version of the C standard to use.
+ * - pToken: A pointer to a token to store the result.
+ *
+ * Returns:
+ * - true if a token was found.
+ * - false otherwise.
+ */
+static bool ccLexToken(const char* const string, const CcVersion version, CcToken* const pToken)
 {
-	assert(pTokenList != nullptr);
+	switch(ccLexTables.classes[(unsigned char)*string])
+	{
+		case CC_LEX_CLASS_STRING:
+			return ccParseString(string, pToken);
 
-	CC_FREE(pTokenList->tokens);
-	pTokenList->count = 0;
+		case CC_LEX_CLASS_CHARACTER:
+			return ccParseCharacter(string, pToken);
+
+		case CC_LEX_CLASS_PUNCTUATOR:
+			return ccLexPunctuator(string, pToken);
+
+		case CC_LEX_CLASS_CONSTANT:
+			return ccParseConstant(string, pToken);
+
+		case CC_LEX_CLASS_IDENTIFIER:
+			return ccParseIdentifier(string, version, pToken);
+
+		default:
+			return false;
+	}
+}
+
+// Token types are stored on a byte.
+static_assert(CC_TOKEN_STRING <= UINT8_MAX);
+
+// Minimum capacity of token lists, and initial capacity of their constants.
+static constexpr size_t ccMinimumTokenCapacity = 16;
+
+// Bytes per token of the arrays of a token list, which share one block holding the values, offsets, lengths and types in that order.
+static constexpr size_t ccTokenSize = 3 * sizeof(uint32_t) + sizeof(uint8_t);
+
+/*
+ * Move the arrays of a token list inside their block, from where they are for a capacity to where they are for another.
+ * Arrays are moved starting from the side they move towards, so that none is overwritten before it is moved.
+ *
+ * Parameters:
+ * - block: The block of the arrays.
+ * - count: The number of tokens.
+ * - oldCapacity: The capacity the arrays are laid out for.
+ * - capacity: The capacity to lay the arrays out for.
+ */
+static void ccMoveTokenArrays(char* const block, const size_t count, const size_t oldCapacity, const size_t capacity)
+{
+	// The values are first, so they never move.
+	static const size_t starts[] = {sizeof(uint32_t), 2 * sizeof(uint32_t), 3 * sizeof(uint32_t)};
+	static const size_t elementSizes[] = {sizeof(uint32_t), sizeof(uint32_t), sizeof(uint8_t)};
+
+	for(size_t index = 0; index < CC_LEN(starts); ++index)
+	{
+		const size_t arrayIndex = capacity > oldCapacity ? CC_LEN(starts) - 1 - index : index;
+		memmove(block + starts[arrayIndex] * capacity, block + starts[arrayIndex] * oldCapacity, count * elementSizes[arrayIndex]);
+	}
+}
+
+/*
+ * Change the capacity of a token list.
+ * The arrays share one block, so that they are resized together: either all of them get the new capacity, or none does.
+ *
+ * Parameters:
+ * - pTokenList: A pointer to a list of tokens.
+ * - capacity: The new capacity, at least the number of tokens. The arrays are freed if it is 0.
+ *
+ * Returns:
+ * - true on success.
+ * - false if memory allocation fails, in which case the list is left untouched.
+ */
+static bool ccResizeTokenList(CcTokenList* const pTokenList, const size_t capacity)
+{
+	assert(pTokenList != nullptr);
+	assert(capacity >= pTokenList->count);
+
+	const size_t oldCapacity = pTokenList->capacity;
+	const size_t count = pTokenList->count;
+	char* const block = (char*)pTokenList->values;
+
+	if(capacity > ccSizeMax / ccTokenSize)
+	{
+		return false;
+	}
+
+	char* newBlock = nullptr;
+	if(capacity == 0)
+	{
+		ccFree(block, oldCapacity * ccTokenSize);
+	}
+	else
+	{
+		// Arrays are packed before the block shrinks and spread once it has grown.
+		if(capacity < oldCapacity)
+		{
+			ccMoveTokenArrays(block, count, oldCapacity, capacity);
+		}
+
+		newBlock = ccRealloc(block, oldCapacity * ccTokenSize, capacity * ccTokenSize);
+		if(!newBlock)
+		{
+			if(capacity < oldCapacity)
+			{
+				ccMoveTokenArrays(block, count, capacity, oldCapacity);
+			}
+
+			return false;
+		}
+
+		if(capacity > oldCapacity)
+		{
+			ccMoveTokenArrays(newBlock, count, oldCapacity, capacity);
+		}
+	}
+
+	pTokenList->values = (uint32_t*)newBlock;
+	pTokenList->offsets = newBlock ? (uint32_t*)(newBlock + sizeof(uint32_t) * capacity) : nullptr;
+	pTokenList->lengths = newBlock ? (uint32_t*)(newBlock + 2 * sizeof(uint32_t) * capacity) : nullptr;
+	pTokenList->types = newBlock ? (uint8_t*)(newBlock + 3 * sizeof(uint32_t) * capacity) : nullptr;
+	pTokenList->capacity = capacity;
+
+	return true;
+}
+
+const uint8_t* ccGetTokenTypes(const CcConstTokenList* const tokens)
+{
+	assert(tokens != nullptr);
+	assert(tokens->pTokenList != nullptr);
+	assert(tokens->start + tokens->count <= tokens->pTokenList->count);
+
+	return tokens->pTokenList->types ? tokens->pTokenList->types + tokens->start : nullptr;
+}
+
+CcStringView ccGetTokenString(const CcConstTokenList* const tokens, const size_t tokenIndex)
+{
+	assert(tokens != nullptr);
+	assert(tokens->pTokenList != nullptr);
+	assert(tokenIndex < tokens->count);
+
+	const CcTokenList* const pTokenList = tokens->pTokenList;
+	const size_t index = tokens->start + tokenIndex;
+
+	return (CcStringView){pTokenList->source + pTokenList->offsets[index], pTokenList->lengths[index]};
+}
+
+CcConstant ccGetTokenConstant(const CcConstTokenList* const tokens, const size_t tokenIndex)
+{
+	assert(tokens != nullptr);
+	assert(tokens->pTokenList != nullptr);
+	assert(tokenIndex < tokens->count);
+
+	const CcTokenList* const pTokenList = tokens->pTokenList;
+	const size_t index = tokens->start + tokenIndex;
+
+	assert(pTokenList->types[index] == CC_TOKEN_CONSTANT);
+
+	return pTokenList->constants[pTokenList->values[index]];
+}
+
+uint32_t ccGetTokenSymbol(const CcConstTokenList* const tokens, const size_t tokenIndex)
+{
+	assert(tokens != nullptr);
+	assert(tokens->pTokenList != nullptr);
+	assert(tokenIndex < tokens->count);
+
+	const CcTokenList* const pTokenList = tokens->pTokenList;
+	const size_t index = tokens->start + tokenIndex;
+
+	assert(pTokenList->types[index] == CC_TOKEN_IDENTIFIER);
+
+	return pTokenList->values[index];
+}
+
+size_t ccGetTokenPartner(const CcConstTokenList* const tokens, const size_t tokenIndex)
+{
+	assert(tokens != nullptr);
+	assert(tokens->pTokenList != nullptr);
+	assert(tokenIndex < tokens->count);
+	assert(tokens->start + tokens->count <= tokens->pTokenList->partnerCapacity);
+
+	const uint32_t partner = tokens->pTokenList->partners[tokens->start + tokenIndex];
+	if(partner == UINT32_MAX || partner < tokens->start || partner - tokens->start >= tokens->count)
+	{
+		return SIZE_MAX;
+	}
+
+	return partner - tokens->start;
+}
+
+CcResult ccMatchBrackets(CcTokenList* const pTokenList)
+{
+	assert(pTokenList != nullptr);
+
+	if(pTokenList->count > pTokenList->partnerCapacity)
+	{
+		uint32_t* const partners = ccRealloc(pTokenList->partners, pTokenList->partnerCapacity * sizeof(pTokenList->partners[0]), pTokenList->count * sizeof(pTokenList->partners[0]));
+		if(!partners)
+		{
+			return CC_ERROR_OUT_OF_MEMORY;
+		}
+		pTokenList->partners = partners;
+		pTokenList->partnerCapacity = pTokenList->count;
+	}
+
+	pTokenList->unmatchedIndex = SIZE_MAX;
+
+	// Each open bracket holds the previous one of the stack until it is matched.
+	uint32_t* const partners = pTokenList->partners;
+	uint32_t top = UINT32_MAX;
+	for(size_t tokenIndex = 0; tokenIndex < pTokenList->count; ++tokenIndex)
+	{
+		CcTokenType openType;
+		switch(pTokenList->types[tokenIndex])
+		{
+			case CC_TOKEN_OPEN_PARENTHESIS:
+			case CC_TOKEN_OPEN_BRACE:
+			case CC_TOKEN_OPEN_BRACKET:
+				partners[tokenIndex] = top;
+				top = tokenIndex;
+				continue;
+
+			case CC_TOKEN_CLOSE_PARENTHESIS:
+				openType = CC_TOKEN_OPEN_PARENTHESIS;
+				break;
+
+			case CC_TOKEN_CLOSE_BRACE:
+				openType = CC_TOKEN_OPEN_BRACE;
+				break;
+
+			case CC_TOKEN_CLOSE_BRACKET:
+				openType = CC_TOKEN_OPEN_BRACKET;
+				break;
+
+			default:
+				partners[tokenIndex] = tokenIndex;
+				continue;
+		}
+
+		if(top == UINT32_MAX || pTokenList->types[top] != openType)
+		{
+			partners[tokenIndex] = UINT32_MAX;
+			pTokenList->unmatchedIndex = CC_MIN(pTokenList->unmatchedIndex, tokenIndex);
+			continue;
+		}
+
+		const uint32_t open = top;
+		top = partners[open];
+		partners[open] = tokenIndex;
+		partners[tokenIndex] = open;
+	}
+
+	// Brackets left in the stack are unmatched.
+	while(top != UINT32_MAX)
+	{
+		const uint32_t open = top;
+		top = partners[open];
+		partners[open] = UINT32_MAX;
+		pTokenList->unmatchedIndex = CC_MIN(pTokenList->unmatchedIndex, open);
+	}
+
+	return CC_SUCCESS;
+}
+
+CcResult ccAppendToken(CcTokenList* const pTokenList, const CcToken* const pToken, const size_t offset)
+{
+	assert(pTokenList != nullptr);
+	assert(pToken != nullptr);
+
+	if(offset > UINT32_MAX || pToken->string.length > UINT32_MAX || pTokenList->count >= UINT32_MAX)
+	{
+		return CC_ERROR_INVALID_ARGUMENT;
+	}
+
+	if(pTokenList->count == pTokenList->capacity)
+	{
+		if(pTokenList->capacity > ccSizeMax / 2)
+		{
+			return CC_ERROR_OUT_OF_MEMORY;
+		}
+
+		const size_t capacity = pTokenList->capacity > 0 ? pTokenList->capacity * 2 : ccMinimumTokenCapacity;
+		if(!ccResizeTokenList(pTokenList, capacity))
+		{
+			return CC_ERROR_OUT_OF_MEMORY;
+		}
+	}
+
+	// Identifiers hold their symbol, constants the index of their value.
+	uint32_t value = 0;
+	if(pToken->type == CC_TOKEN_IDENTIFIER)
+	{
+		const CcResult result = ccInternSymbol(&pTokenList->symbols, pToken->string.string, pToken->string.length, &value);
+		if(result != CC_SUCCESS)
+		{
+			return result;
+		}
+	}
+	else if(pToken->type == CC_TOKEN_CONSTANT)
+	{
+		if(pTokenList->constantCount == pTokenList->constantCapacity)
+		{
+			if(pTokenList->constantCapacity > ccSizeMax / sizeof(pTokenList->constants[0]) / 2)
+			{
+				return CC_ERROR_OUT_OF_MEMORY;
+			}
+
+			const size_t capacity = pTokenList->constantCapacity > 0 ? pTokenList->constantCapacity * 2 : ccMinimumTokenCapacity;
+			CcConstant* const newConstants = ccRealloc(pTokenList->constants, pTokenList->constantCapacity * sizeof(pTokenList->constants[0]), capacity * sizeof(pTokenList->constants[0]));
+			if(!newConstants)
+			{
+				return CC_ERROR_OUT_OF_MEMORY;
+			}
+			pTokenList->constants = newConstants;
+			pTokenList->constantCapacity = capacity;
+		}
+
+		value = pTokenList->constantCount;
+		pTokenList->constants[pTokenList->constantCount] = pToken->constant;
+		++pTokenList->constantCount;
+	}
+
+	pTokenList->types[pTokenList->count] = pToken->type;
+	pTokenList->offsets[pTokenList->count] = offset;
+	pTokenList->lengths[pTokenList->count] = pToken->string.length;
+	pTokenList->values[pTokenList->count] = value;
+	++pTokenList->count;
+
+	return CC_SUCCESS;
+}
+
+/*
+ * Shrink a token list to its tokens once lexing is over.
+ * The number of tokens reserved while lexing is reported first.
+ *
+ * Parameters:
+ * - pTokenList: A pointer to a list of tokens.
+ *
+ * Returns:
+ * - true on success.
+ * - false if the tokens could not be reallocated, in which case the list is left untouched.
+ */
+static bool ccShrinkTokenList(CcTokenList* const pTokenList)
+{
+	ccReportBuffer(CC_BUFFER_TOKENS, pTokenList->count, pTokenList->capacity);
+	ccReportBuffer(CC_BUFFER_SYMBOLS, pTokenList->symbols.count, pTokenList->symbols.slotCount);
+
+	if(pTokenList->count < pTokenList->capacity && !ccResizeTokenList(pTokenList, pTokenList->count))
+	{
+		return false;
+	}
+
+	if(pTokenList->constantCount == 0)
+	{
+		ccFree(pTokenList->constants, pTokenList->constantCapacity * sizeof(pTokenList->constants[0]));
+		pTokenList->constants = nullptr;
+		pTokenList->constantCapacity = 0;
+	}
+	else if(pTokenList->constantCount < pTokenList->constantCapacity)
+	{
+		CcConstant* const newConstants = ccRealloc(pTokenList->constants, pTokenList->constantCapacity * sizeof(pTokenList->constants[0]), pTokenList->constantCount * sizeof(pTokenList->constants[0]));
+		if(!newConstants)
+		{
+			return false;
+		}
+		pTokenList->constants = newConstants;
+		pTokenList->constantCapacity = pTokenList->constantCount;
+	}
+
+	// Text is only copied for tokens, so it is never empty once allocated.
+	if(pTokenList->textLength < pTokenList->textCapacity)
+	{
+		char* const newText = ccRealloc(pTokenList->text, pTokenList->textCapacity, pTokenList->textLength);
+		if(!newText)
+		{
+			return false;
+		}
+		pTokenList->text = newText;
+		pTokenList->textCapacity = pTokenList->textLength;
+		pTokenList->source = newText;
+	}
+
+	return true;
+}
+
+// Average number of bytes per token ccLex reserves tokens for at first, typical code has about 4.
+static constexpr size_t ccBytesPerToken = 4;
+
+/*
+ * Lex a range of a string into a list of tokens.
+ * The range must start and end outside of any token. The characters around it are still read as lookahead, so that its tokens are the ones of the whole string.
+ *
+ * Parameters:
+ * - source: The whole string, null-terminated.
+ * - start: The index of the first character of the range.
+ * - end: The index past the last character of the range.
+ * - version: The version of the C standard to use.
+ * - pTokenList: A pointer to a list of tokens, overwritten.
+ *
+ * Returns:
+ * - CC_SUCCESS if the range is successfully lexed.
+ * - CC_ERROR_OUT_OF_MEMORY if memory allocation fails, in which case the list is freed.
+ */
+static CcResult ccLexRange(const char* const source, const size_t start, const size_t end, const CcVersion version, CcTokenList* const pTokenList)
+{
+	*pTokenList = (CcTokenList){.source = source};
+
+	// Tokens grow from an estimate rather than one per byte, so memory follows the number of tokens.
+	if(!ccResizeTokenList(pTokenList, CC_MAX((end - start) / ccBytesPerToken, ccMinimumTokenCapacity)))
+	{
+		ccDiagnose("Failed to allocate memory.");
+		return CC_ERROR_OUT_OF_MEMORY;
+	}
+
+	CcConstString string = {source + start, end - start};
+	const char* const stop = source + end;
+	while(true)
+	{
+		ccSkipSpaces(&string);
+		if(string.string >= stop)
+		{
+			break;
+		}
+
+		CcToken token;
+		if(!ccLexToken(string.string, version, &token))
+		{
+			ccReportDiagnostic(CC_DIAGNOSTIC_UNEXPECTED_TOKEN, string.string);
+			ccPop(&string, 1);
+			continue;
+		}
+
+		if(ccAppendToken(pTokenList, &token, string.string - source) != CC_SUCCESS)
+		{
+			ccDiagnose("Failed to allocate memory.");
+			ccFreeTokenList(pTokenList);
+			return CC_ERROR_OUT_OF_MEMORY;
+		}
+
+		ccPop(&string, token.string.length);
+	}
+
+	return CC_SUCCESS;
+}
+
+/*
+ * Lex a string, reporting diagnostics to the sink of the calling thread.
+ *
+ * Parameters:
+ * - string: The string to lex.
+ * - version: The version of the C standard to use.
+ * - pTokenList: A pointer to a list of tokens to store the result.
+ *
+ * Returns:
+ * The same results as ccLex.
+ */
+static CcResult ccLexSource(const CcConstString string, const CcVersion version, CcTokenList* const pTokenList)
+{
+	*pTokenList = (CcTokenList){.source = string.string, .unmatchedIndex = SIZE_MAX};
+
+	call_once(&ccLexTablesOnce, ccBuildLexTables);
+
+	if(string.length == 0)
+	{
+		return CC_SUCCESS;
+	}
+
+	// Tokens refer to their text with 32-bit offsets.
+	if(string.length > UINT32_MAX)
+	{
+		ccDiagnose("Source code too large.");
+		return CC_ERROR_INVALID_ARGUMENT;
+	}
+
+	const CcResult result = ccLexRange(string.string, 0, string.length, version, pTokenList);
+	if(result != CC_SUCCESS)
+	{
+		return result;
+	}
+
+	if(!ccShrinkTokenList(pTokenList))
+	{
+		return CC_ERROR_UNKNOWN;
+	}
+
+	if(ccMatchBrackets(pTokenList) != CC_SUCCESS)
+	{
+		ccDiagnose("Failed to allocate memory.");
+		ccFreeTokenList(pTokenList);
+		return CC_ERROR_OUT_OF_MEMORY;
+	}
+
+	return CC_SUCCESS;
+}
+
+CcResult ccLex(const CcConstString string, const CcVersion version, CcTokenList* const pTokenList)
+{
+	// Validate arguments.
+	assert(string.string != nullptr);
+	assert(string.length == strlen(string.string));
+	assert(pTokenList != nullptr);
+
+	// Diagnostics are written once the whole string is lexed.
+	CcDiagnosticSink sink;
+	ccBeginDiagnostics(&sink);
+	const CcResult result = ccLexSource(string, version, pTokenList);
+	ccEndDiagnostics(&sink);
+
+	return result;
+}
+
+// Minimum number of bytes lexed by each thread of ccLexParallel.
+static constexpr size_t ccParallelChunkSize = 1 << 20;
+
+/*
+ * Minimum number of threads ccLexParallel splits a string for.
+ * Joining the chunks runs on the calling thread and measured at 30 to 50% of the time of lexing the string on one thread, for strings of 4 to 16 MiB,
+ * so chunks only lex faster once each thread lexes at most a quarter of the string.
+ */
+static constexpr size_t ccParallelMinimumThreads = 4;
+
+bool ccIsSplitWorthIt(const size_t length, const size_t threadCount)
+{
+	// Small strings and few threads are not worth the cost of joining the chunks.
+	return CC_MIN(threadCount, length / ccParallelChunkSize) >= ccParallelMinimumThreads && length <= UINT32_MAX;
+}
+
+/*
+ * A chunk of a string lexed by ccLexParallel.
+ *
+ * Fields:
+ * - source: The whole string.
+ * - start: The index of the first character of the chunk.
+ * - end: The index past the last character of the chunk.
+ * - version: The version of the C standard to use.
+ * - tokenList: The tokens of the chunk.
+ * - diagnostics: The sink recording the diagnostics of the chunk.
+ * - result: The result of lexing the chunk.
+ * - thread: The thread lexing the chunk.
+ * - started: Whether the thread was started.
+ */
+typedef struct CcLexChunk
+{
+	const char* source;
+	size_t start;
+	size_t end;
+	CcVersion version;
+
+	CcTokenList tokenList;
+	CcDiagnosticSink diagnostics;
+	CcResult result;
+
+	thrd_t thread;
+	bool started;
+} CcLexChunk;
+
+/*
+ * Lex a chunk.
+ *
+ * Parameters:
+ * - pChunkVoid: A pointer to the chunk.
+ *
+ * Returns:
+ * Always 0.
+ */
+static int ccLexChunk(void* const pChunkVoid)
+{
+	CcLexChunk* const pChunk = pChunkVoid;
+
+	CcDiagnosticSink* const pPreviousSink = ccGetDiagnosticSink();
+	ccSetDiagnosticSink(&pChunk->diagnostics);
+
+	pChunk->result = ccLexRange(pChunk->source, pChunk->start, pChunk->end, pChunk->version, &pChunk->tokenList);
+
+	ccSetDiagnosticSink(pPreviousSink);
+
+	return 0;
+}
+
+/*
+ * Skip a string literal or a character constant the way ccLexToken reads it.
+ *
+ * Parameters:
+ * - source: A string.
+ * - position: The index of the quote starting the literal.
+ *
+ * Returns:
+ * The index past the literal, or past the quote if it does not start a valid character constant.
+ */
+static size_t ccSkipLiteral(const char* const source, const size_t position)
+{
+	// Like ccParseString, the literal ends at the first quote not preceded by a backslash.
+	if(source[position] == '"')
+	{
+		size_t end = position + 1;
+		while(source[end] != '\0' && (source[end] != '"' || source[end - 1] == '\\'))
+		{
+			++end;
+		}
+
+		return source[end] == '"' ? end + 1 : end;
+	}
+
+	// Like ccParseCharacter, an invalid constant is an unexpected token and only its quote is skipped.
+	const char* const string = source + position + 1;
+	if(
+		string[0] == '\0' ||
+		(string[0] != '\\' && string[1] != '\'') ||
+		(string[0] == '\\' && (string[1] == '\0' || string[2] != '\''))
+	)
+	{
+		return position + 1;
+	}
+
+	return position + (string[0] == '\\' ? 4 : 3);
+}
+
+/*
+ * Split a string into chunks starting and ending outside of any token.
+ * Chunks end at line breaks, which only string literals and character constants can hold: scanning the quotes of the string is enough to skip those.
+ *
+ * Parameters:
+ * - string: A string.
+ * - chunkCount: The number of chunks wanted.
+ * - splits: An array of chunkCount + 1 indices to store the bounds of the chunks.
+ *
+ * Returns:
+ * The number of chunks, fewer than wanted if the string lacks line breaks.
+ */
+static size_t ccSplitSource(const CcConstString string, const size_t chunkCount, size_t* const splits)
+{
+	splits[0] = 0;
+	size_t splitCount = 1;
+
+	// The lexer is outside of any literal at position, quote is the index of the next quote.
+	size_t position = 0;
+	size_t quote = strcspn(string.string, "\"'");
+	for(size_t chunkIndex = 1; chunkIndex < chunkCount; ++chunkIndex)
+	{
+		const size_t target = CC_MAX(string.length / chunkCount * chunkIndex, splits[splitCount - 1] + 1);
+
+		size_t split = string.length;
+		while(position < string.length)
+		{
+			// Line breaks before the next quote are outside of literals.
+			const size_t from = CC_MAX(position, target);
+			if(from < quote)
+			{
+				const char* const lineBreak = memchr(string.string + from, '\n', quote - from);
+				if(lineBreak)
+				{
+					split = lineBreak - string.string;
+					break;
+				}
+			}
+
+			if(quote >= string.length)
+			{
+				break;
+			}
+
+			position = ccSkipLiteral(string.string, quote);
+			quote = position + strcspn(string.string + position, "\"'");
+		}
+
+		if(split >= string.length)
+		{
+			break;
+		}
+
+		splits[splitCount] = split;
+		++splitCount;
+		position = split;
+	}
+
+	splits[splitCount] = string.length;
+
+	return splitCount;
+}
+
+/*
+ * Concatenate the tokens of chunks into a list of tokens.
+ *
+ * Parameters:
+ * - chunks: The lexed chunks, in order.
+ * - chunkCount: The number of chunks.
+ * - pTokenList: A pointer to an empty list of tokens, with the source of the chunks.
+ *
+ * Returns:
+ * - CC_SUCCESS if the tokens are concatenated.
+ * - CC_ERROR_OUT_OF_MEMORY if memory allocation fails.
+ */
+static CcResult ccJoinChunks(const CcLexChunk* const chunks, const size_t chunkCount, CcTokenList* const pTokenList)
+{
+	size_t tokenCount = 0;
+	size_t constantCount = 0;
+	size_t symbolCount = 0;
+	for(size_t chunkIndex = 0; chunkIndex < chunkCount; ++chunkIndex)
+	{
+		tokenCount += chunks[chunkIndex].tokenList.count;
+		constantCount += chunks[chunkIndex].tokenList.constantCount;
+		symbolCount = CC_MAX(symbolCount, chunks[chunkIndex].tokenList.symbols.count);
+	}
+
+	if(!ccResizeTokenList(pTokenList, CC_MAX(tokenCount, ccMinimumTokenCapacity)))
+	{
+		return CC_ERROR_OUT_OF_MEMORY;
+	}
+
+	if(constantCount > 0)
+	{
+		pTokenList->constants = ccMalloc(constantCount * sizeof(pTokenList->constants[0]));
+		if(!pTokenList->constants)
+		{
+			return CC_ERROR_OUT_OF_MEMORY;
+		}
+		pTokenList->constantCapacity = constantCount;
+	}
+
+	// Symbols of a chunk, mapped to the symbols of the list.
+	uint32_t* symbols = nullptr;
+	if(symbolCount > 0)
+	{
+		symbols = ccMalloc(symbolCount * sizeof(symbols[0]));
+		if(!symbols)
+		{
+			return CC_ERROR_OUT_OF_MEMORY;
+		}
+	}
+
+	CcResult result = CC_SUCCESS;
+	for(size_t chunkIndex = 0; chunkIndex < chunkCount; ++chunkIndex)
+	{
+		const CcTokenList* const pChunk = &chunks[chunkIndex].tokenList;
+
+		// Names are interned in the order they first appear in the chunk, so symbols are numbered as ccLex numbers them.
+		for(size_t symbolIndex = 0; symbolIndex < pChunk->symbols.count; ++symbolIndex)
+		{
+			const CcSymbol* const pSymbol = &pChunk->symbols.symbols[symbolIndex];
+			result = ccInternSymbol(&pTokenList->symbols, pSymbol->name, pSymbol->length, &symbols[symbolIndex]);
+			if(result != CC_SUCCESS)
+			{
+				goto end;
+			}
+		}
+
+		const size_t start = pTokenList->count;
+		memcpy(pTokenList->types + start, pChunk->types, pChunk->count * sizeof(pChunk->types[0]));
+		memcpy(pTokenList->offsets + start, pChunk->offsets, pChunk->count * sizeof(pChunk->offsets[0]));
+		memcpy(pTokenList->lengths + start, pChunk->lengths, pChunk->count * sizeof(pChunk->lengths[0]));
+		for(size_t tokenIndex = 0; tokenIndex < pChunk->count; ++tokenIndex)
+		{
+			uint32_t value = pChunk->values[tokenIndex];
+			if(pChunk->types[tokenIndex] == CC_TOKEN_IDENTIFIER)
+			{
+				value = symbols[value];
+			}
+			else if(pChunk->types[tokenIndex] == CC_TOKEN_CONSTANT)
+			{
+				value += pTokenList->constantCount;
+			}
+
+			pTokenList->values[start + tokenIndex] = value;
+		}
+		pTokenList->count += pChunk->count;
+
+		if(pChunk->constantCount > 0)
+		{
+			memcpy(pTokenList->constants + pTokenList->constantCount, pChunk->constants, pChunk->constantCount * sizeof(pChunk->constants[0]));
+			pTokenList->constantCount += pChunk->constantCount;
+		}
+	}
+
+	end:
+	ccFree(symbols, symbolCount * sizeof(symbols[0]));
+
+	return result;
+}
+
+/*
+ * Lex a string with several threads, reporting diagnostics to the sink of the calling thread.
+ *
+ * Parameters:
+ * - string: The string to lex.
+ * - version: The version of the C standard to use.
+ * - threadCount: The highest number of threads to use, including the calling thread.
+ * - pTokenList: A pointer to a list of tokens to store the result.
+ *
+ * Returns:
+ * The same results as ccLexParallel.
+ */
+static CcResult ccLexChunks(const CcConstString string, const CcVersion version, const size_t threadCount, CcTokenList* const pTokenList)
+{
+	const size_t chunkCount = CC_MIN(threadCount, string.length / ccParallelChunkSize);
+	if(!ccIsSplitWorthIt(string.length, threadCount))
+	{
+		return ccLexSource(string, version, pTokenList);
+	}
+
+	call_once(&ccLexTablesOnce, ccBuildLexTables);
+
+	CcResult result = CC_SUCCESS;
+
+	*pTokenList = (CcTokenList){.source = string.string, .unmatchedIndex = SIZE_MAX};
+
+	size_t* const splits = ccMalloc((chunkCount + 1) * sizeof(splits[0]));
+	CcLexChunk* const chunks = ccMalloc(chunkCount * sizeof(chunks[0]));
+	if(!splits || !chunks)
+	{
+		ccFree(chunks, chunkCount * sizeof(chunks[0]));
+		ccFree(splits, (chunkCount + 1) * sizeof(splits[0]));
+
+		ccDiagnose("Failed to allocate memory.");
+		return CC_ERROR_OUT_OF_MEMORY;
+	}
+
+	const size_t splitCount = ccSplitSource(string, chunkCount, splits);
+
+	if(splitCount <= 1)
+	{
+		ccFree(chunks, chunkCount * sizeof(chunks[0]));
+		ccFree(splits, (chunkCount + 1) * sizeof(splits[0]));
+
+		return ccLexSource(string, version, pTokenList);
+	}
+
+	// Each chunk records its diagnostics, merged in order once all are lexed so that repeats are merged across chunks too.
+	for(size_t chunkIndex = 0; chunkIndex < splitCount; ++chunkIndex)
+	{
+		chunks[chunkIndex] = (CcLexChunk){
+			.source = string.string,
+			.start = splits[chunkIndex],
+			.end = splits[chunkIndex + 1],
+			.version = version,
+			.diagnostics = {.source = ccGetDiagnosticSource()}
+		};
+	}
+
+	// The calling thread lexes the first chunk, and the chunks whose thread could not start.
+	for(size_t chunkIndex = 1; chunkIndex < splitCount; ++chunkIndex)
+	{
+		chunks[chunkIndex].started = thrd_create(&chunks[chunkIndex].thread, ccLexChunk, &chunks[chunkIndex]) == thrd_success;
+	}
+
+	ccLexChunk(&chunks[0]);
+
+	for(size_t chunkIndex = 1; chunkIndex < splitCount; ++chunkIndex)
+	{
+		if(chunks[chunkIndex].started)
+		{
+			thrd_join(chunks[chunkIndex].thread, nullptr);
+		}
+		else
+		{
+			ccLexChunk(&chunks[chunkIndex]);
+		}
+	}
+
+	for(size_t chunkIndex = 0; chunkIndex < splitCount; ++chunkIndex)
+	{
+		ccMergeDiagnosticSink(ccGetDiagnosticSink(), &chunks[chunkIndex].diagnostics);
+		ccFreeDiagnosticSink(&chunks[chunkIndex].diagnostics);
+
+		if(result == CC_SUCCESS)
+		{
+			result = chunks[chunkIndex].result;
+		}
+	}
+
+	if(result == CC_SUCCESS)
+	{
+		result = ccJoinChunks(chunks, splitCount, pTokenList);
+		if(result != CC_SUCCESS)
+		{
+			ccDiagnose("Failed to allocate memory.");
+			ccFreeTokenList(pTokenList);
+		}
+	}
+
+	for(size_t chunkIndex = 0; chunkIndex < splitCount; ++chunkIndex)
+	{
+		ccFreeTokenList(&chunks[chunkIndex].tokenList);
+	}
+	ccFree(chunks, chunkCount * sizeof(chunks[0]));
+	ccFree(splits, (chunkCount + 1) * sizeof(splits[0]));
+
+	// The list is already the size of its tokens, this only reports it.
+	if(result == CC_SUCCESS && !ccShrinkTokenList(pTokenList))
+	{
+		return CC_ERROR_UNKNOWN;
+	}
+
+	if(result == CC_SUCCESS && ccMatchBrackets(pTokenList) != CC_SUCCESS)
+	{
+		ccDiagnose("Failed to allocate memory.");
+		ccFreeTokenList(pTokenList);
+		return CC_ERROR_OUT_OF_MEMORY;
+	}
+
+	return result;
+}
+
+CcResult ccLexParallel(const CcConstString string, const CcVersion version, const size_t threadCount, CcTokenList* const pTokenList)
+{
+	// Validate arguments.
+	assert(string.string != nullptr);
+	assert(string.length == strlen(string.string));
+	assert(threadCount > 0);
+	assert(pTokenList != nullptr);
+
+	CcDiagnosticSink sink;
+	ccBeginDiagnostics(&sink);
+	const CcResult result = ccLexChunks(string, version, threadCount, pTokenList);
+	ccEndDiagnostics(&sink);
+
+	return result;
+}
+
+// Initial size of the windows of ccLexStream and stream lexers.
+static constexpr size_t ccWindowSize = 1 << 16;
+
+// Initial capacity of the token list of ccLexStream.
+static constexpr size_t ccStreamTokenCapacity = 1 << 10;
+
+/*
+ * Refill a window.
+ * The bytes from its start are moved to the start of the buffer, which grows if they fill more than half of it, so that each read fills at least half of the buffer.
+ *
+ * Parameters:
+ * - pWindow: A pointer to the window.
+ *
+ * Returns:
+ * - CC_SUCCESS if the window is refilled.
+ * - CC_ERROR_OUT_OF_MEMORY if memory allocation fails.
+ */
+static CcResult ccRefillWindow(CcWindow* const pWindow)
+{
+	assert(pWindow != nullptr);
+	assert(!pWindow->finished);
+
+	memmove(pWindow->buffer, pWindow->buffer + pWindow->start, pWindow->end - pWindow->start);
+	pWindow->end -= pWindow->start;
+	pWindow->start = 0;
+
+	if(pWindow->end >= pWindow->size / 2)
+	{
+		if(pWindow->size > ccSizeMax / 2)
+		{
+			return CC_ERROR_OUT_OF_MEMORY;
+		}
+
+		char* const newBuffer = ccRealloc(pWindow->buffer, pWindow->size, pWindow->size * 2);
+		if(!newBuffer)
+		{
+			return CC_ERROR_OUT_OF_MEMORY;
+		}
+		pWindow->buffer = newBuffer;
+		pWindow->size *= 2;
+	}
+
+	const size_t size = pWindow->size - 1 - pWindow->end;
+	const size_t read = pWindow->read(pWindow->pUserData, pWindow->buffer + pWindow->end, size);
+	assert(read <= size);
+
+	pWindow->end += read;
+	pWindow->buffer[pWindow->end] = '\0';
+	pWindow->finished = read < size;
+
+	return CC_SUCCESS;
+}
+
+/*
+ * Check if the token at some position of a window is entirely inside it.
+ * The lexing functions look at most one byte past identifiers, constants and string literals, and 3 bytes past the start of other tokens.
+ *
+ * Parameters:
+ * - pWindow: A pointer to the window.
+ * - position: The offset of the token in the window.
+ *
+ * Returns:
+ * - true if the token can be lexed without reading more.
+ * - false otherwise.
+ */
+static bool ccIsTokenInWindow(const CcWindow* const pWindow, const size_t position)
+{
+	assert(pWindow != nullptr);
+	assert(position < pWindow->end);
+
+	const char* const string = pWindow->buffer + position;
+	const char* const end = pWindow->buffer + pWindow->end;
+
+	if(*string == '"')
+	{
+		for(const char* pCharacter = string + 1; pCharacter < end; ++pCharacter)
+		{
+			if(*pCharacter == '\0' || (*pCharacter == '"' && pCharacter[-1] != '\\'))
+			{
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	if(ccCharacterClasses[(unsigned char)*string] & CC_CHARACTER_IDENTIFIER)
+	{
+		// The window is null-terminated, so the scan stops at its end.
+		return string + ccScanIdentifier(string) < end;
+	}
+
+	return end - string > 3;
+}
+
+/*
+ * Copy text to the text of a token list, which becomes the source of its tokens.
+ * The text grows geometrically, so its copies are amortized.
+ *
+ * Parameters:
+ * - pTokenList: A pointer to a list of tokens, whose source is its text.
+ * - string: The text to copy.
+ * - pOffset: A pointer to the offset of the copy in the text.
+ *
+ * Returns:
+ * - CC_SUCCESS on success.
+ * - CC_ERROR_INVALID_ARGUMENT if the text would not fit 32-bit offsets.
+ * - CC_ERROR_OUT_OF_MEMORY if memory allocation fails.
+ */
+static CcResult ccAppendText(CcTokenList* const pTokenList, const CcStringView string, size_t* const pOffset)
+{
+	assert(pTokenList != nullptr);
+	assert(pOffset != nullptr);
+
+	if(string.length > UINT32_MAX - pTokenList->textLength)
+	{
+		return CC_ERROR_INVALID_ARGUMENT;
+	}
+
+	if(pTokenList->textCapacity - pTokenList->textLength < string.length)
+	{
+		size_t capacity = pTokenList->textCapacity > 0 ? pTokenList->textCapacity : ccWindowSize;
+		while(capacity - pTokenList->textLength < string.length)
+		{
+			capacity *= 2;
+		}
+
+		char* const newText = ccRealloc(pTokenList->text, pTokenList->textCapacity, capacity);
+		if(!newText)
+		{
+			return CC_ERROR_OUT_OF_MEMORY;
+		}
+		pTokenList->text = newText;
+		pTokenList->textCapacity = capacity;
+		pTokenList->source = newText;
+	}
+
+	memcpy(pTokenList->text + pTokenList->textLength, string.string, string.length);
+	*pOffset = pTokenList->textLength;
+	pTokenList->textLength += string.length;
+
+	return CC_SUCCESS;
+}
+
+CcResult ccLexStream(const CcRead read, void* const pUserData, const CcVersion version, CcTokenList* const pTokenList)
+{
+	// Validate arguments.
+	assert(read != nullptr);
+	assert(pTokenList != nullptr);
+
+	CcResult result = CC_SUCCESS;
+
+	*pTokenList = (CcTokenList){.unmatchedIndex = SIZE_MAX};
+
+	call_once(&ccLexTablesOnce, ccBuildLexTables);
+
+	// Diagnostics are written once the whole source is lexed. The window is overwritten by each read, so they are reported without a position.
+	CcDiagnosticSink sink;
+	ccBeginDiagnostics(&sink);
+
+	CcWindow window = {
+		.read = read,
+		.pUserData = pUserData,
+		.size = ccWindowSize
+	};
+
+	window.buffer = ccMalloc(window.size);
+	if(!window.buffer || !ccResizeTokenList(pTokenList, ccStreamTokenCapacity))
+	{
+		result = CC_ERROR_OUT_OF_MEMORY;
+		goto clear;
+	}
+	window.buffer[0] = '\0';
+
+	while(true)
+	{
+		window.start += ccScanSpaces(window.buffer + window.start);
+
+		// Read more when the window is exhausted or cuts the next token.
+		if(window.start == window.end || (!window.finished && !ccIsTokenInWindow(&window, window.start)))
+		{
+			if(window.finished)
+			{
+				break;
+			}
+
+			result = ccRefillWindow(&window);
+			if(result != CC_SUCCESS)
+			{
+				goto clear;
+			}
+
+			continue;
+		}
+
+		CcToken token;
+		if(!ccLexToken(window.buffer + window.start, version, &token))
+		{
+			ccReportDiagnostic(CC_DIAGNOSTIC_UNEXPECTED_TOKEN, nullptr);
+			++window.start;
+			continue;
+		}
+
+		// The window is overwritten by later reads, so the token list keeps a copy of the text of its tokens.
+		size_t offset;
+		result = ccAppendText(pTokenList, token.string, &offset);
+		if(result == CC_SUCCESS)
+		{
+			result = ccAppendToken(pTokenList, &token, offset);
+		}
+		if(result != CC_SUCCESS)
+		{
+			goto clear;
+		}
+
+		window.start += token.string.length;
+	}
+
+	// The list is still valid if it cannot shrink.
+	ccShrinkTokenList(pTokenList);
+
+	result = ccMatchBrackets(pTokenList);
+	if(result != CC_SUCCESS)
+	{
+		goto clear;
+	}
+
+	goto end;
+
+	clear:
+	ccDiagnose(result == CC_ERROR_INVALID_ARGUMENT ? "Source code too large." : "Failed to allocate memory.");
+	ccFreeTokenList(pTokenList);
+
+	end:
+	ccEndDiagnostics(&sink);
+	ccFree(window.buffer, window.size);
+
+	return result;
+}
+
+CcResult ccCreateLexer(const CcConstString string, const CcVersion version, CcLexer* const pLexer)
+{
+	// Validate arguments.
+	assert(string.string != nullptr);
+	assert(string.length == strlen(string.string));
+	assert(pLexer != nullptr);
+
+	*pLexer = (CcLexer){
+		.string = string,
+		.version = version,
+		.tokenList = {.source = string.string, .unmatchedIndex = SIZE_MAX}
+	};
+
+	call_once(&ccLexTablesOnce, ccBuildLexTables);
+
+	// Tokens refer to their text with 32-bit offsets.
+	if(string.length > UINT32_MAX)
+	{
+		ccDiagnose("Source code too large.");
+		return CC_ERROR_INVALID_ARGUMENT;
+	}
+
+	return CC_SUCCESS;
+}
+
+CcResult ccCreateStreamLexer(const CcRead read, void* const pUserData, const CcVersion version, CcLexer* const pLexer)
+{
+	// Validate arguments.
+	assert(read != nullptr);
+	assert(pLexer != nullptr);
+
+	*pLexer = (CcLexer){
+		.version = version,
+		.window = {
+			.read = read,
+			.pUserData = pUserData,
+			.size = ccWindowSize
+		},
+		.tokenList = {.unmatchedIndex = SIZE_MAX}
+	};
+
+	call_once(&ccLexTablesOnce, ccBuildLexTables);
+
+	pLexer->window.buffer = ccMalloc(pLexer->window.size);
+	if(!pLexer->window.buffer)
+	{
+		pLexer->window.size = 0;
+		ccDiagnose("Failed to allocate memory.");
+		return CC_ERROR_OUT_OF_MEMORY;
+	}
+	pLexer->window.buffer[0] = '\0';
+
+	pLexer->string = (CcConstString){pLexer->window.buffer, 0};
+	pLexer->tokenList.source = pLexer->window.buffer;
+
+	return CC_SUCCESS;
+}
+
+CcResult ccResetLexer(const CcConstString string, const CcVersion version, CcLexer* const pLexer)
+{
+	// Validate arguments.
+	assert(string.string != nullptr);
+	assert(string.length == strlen(string.string));
+	assert(pLexer != nullptr);
+	assert(pLexer->tokenList.count == 0 && pLexer->tokenList.symbols.count == 0 && !pLexer->window.read);
+
+	pLexer->string = string;
+	pLexer->version = version;
+	pLexer->tokenList.source = string.string;
+	pLexer->tokenList.unmatchedIndex = SIZE_MAX;
+
+	call_once(&ccLexTablesOnce, ccBuildLexTables);
+
+	// Tokens refer to their text with 32-bit offsets.
+	if(string.length > UINT32_MAX)
+	{
+		ccDiagnose("Source code too large.");
+		return CC_ERROR_INVALID_ARGUMENT;
+	}
+
+	return CC_SUCCESS;
+}
+
+/*
+ * Read more of the source of a stream lexer.
+ * The text from the first token of its window is kept, the offsets of the tokens and the position are moved with it.
+ *
+ * Parameters:
+ * - pLexer: A pointer to a stream lexer.
+ *
+ * Returns:
+ * - CC_SUCCESS if the window is refilled.
+ * - CC_ERROR_INVALID_ARGUMENT if the text of the window would not fit 32-bit offsets.
+ * - CC_ERROR_OUT_OF_MEMORY if memory allocation fails.
+ */
+static CcResult ccRefillLexer(CcLexer* const pLexer)
+{
+	assert(pLexer != nullptr);
+
+	CcWindow* const pWindow = &pLexer->window;
+	CcTokenList* const pTokenList = &pLexer->tokenList;
+
+	const size_t start = pTokenList->count > 0 ? pTokenList->offsets[0] : pLexer->position;
+
+	pWindow->start = start;
+	const CcResult result = ccRefillWindow(pWindow);
+	if(result != CC_SUCCESS)
+	{
+		return result;
+	}
+
+	// Tokens refer to their text with 32-bit offsets.
+	if(pWindow->end > UINT32_MAX)
+	{
+		return CC_ERROR_INVALID_ARGUMENT;
+	}
+
+	if(start > 0)
+	{
+		for(size_t tokenIndex = 0; tokenIndex < pTokenList->count; ++tokenIndex)
+		{
+			pTokenList->offsets[tokenIndex] -= start;
+		}
+		pLexer->position -= start;
+	}
+
+	pLexer->string = (CcConstString){pWindow->buffer, pWindow->end};
+	pTokenList->source = pWindow->buffer;
+
+	return CC_SUCCESS;
+}
+
+CcResult ccNextToken(CcLexer* const pLexer)
+{
+	assert(pLexer != nullptr);
+
+	CcResult result = CC_SUCCESS;
+
+	CcConstString string = {pLexer->string.string + pLexer->position, pLexer->string.length - pLexer->position};
+	while(true)
+	{
+		ccSkipSpaces(&string);
+		pLexer->position = string.string - pLexer->string.string;
+
+		// A stream is read further when the window is exhausted or cuts the next token.
+		if(pLexer->window.read && !pLexer->window.finished && (string.length == 0 || !ccIsTokenInWindow(&pLexer->window, pLexer->position)))
+		{
+			result = ccRefillLexer(pLexer);
+			if(result != CC_SUCCESS)
+			{
+				ccDiagnose(result == CC_ERROR_INVALID_ARGUMENT ? "Source code too large." : "Failed to allocate memory.");
+				break;
+			}
+
+			string = (CcConstString){pLexer->string.string + pLexer->position, pLexer->string.length - pLexer->position};
+			continue;
+		}
+
+		if(string.length == 0)
+		{
+			pLexer->finished = true;
+			break;
+		}
+
+		// The window of a stream is overwritten by later reads, so its diagnostics have no position.
+		CcToken token;
+		if(!ccLexToken(string.string, pLexer->version, &token))
+		{
+			ccReportDiagnostic(CC_DIAGNOSTIC_UNEXPECTED_TOKEN, pLexer->window.read ? nullptr : string.string);
+			ccPop(&string, 1);
+			continue;
+		}
+
+		result = ccAppendToken(&pLexer->tokenList, &token, string.string - pLexer->string.string);
+		if(result != CC_SUCCESS)
+		{
+			ccDiagnose("Failed to allocate memory.");
+			break;
+		}
+
+		ccPop(&string, token.string.length);
+		break;
+	}
+
+	pLexer->position = string.string - pLexer->string.string;
+
+	return result;
+}
+
+void ccReleaseTokens(CcLexer* const pLexer)
+{
+	assert(pLexer != nullptr);
+
+	pLexer->peakCount = CC_MAX(pLexer->peakCount, pLexer->tokenList.count);
+
+	// Constants are only referred to by tokens of the window, symbols are kept for the whole string.
+	pLexer->tokenList.count = 0;
+	pLexer->tokenList.constantCount = 0;
+}
+
+/*
+ * Report the largest window of tokens a lexer held and its symbols.
+ *
+ * Parameters:
+ * - pLexer: A pointer to the lexer.
+ */
+static void ccReportLexer(const CcLexer* const pLexer)
+{
+	ccReportBuffer(CC_BUFFER_TOKENS, CC_MAX(pLexer->peakCount, pLexer->tokenList.count), pLexer->tokenList.capacity);
+	ccReportBuffer(CC_BUFFER_SYMBOLS, pLexer->tokenList.symbols.count, pLexer->tokenList.symbols.slotCount);
+}
+
+void ccClearLexer(CcLexer* const pLexer)
+{
+	assert(pLexer != nullptr);
+
+	ccReportLexer(pLexer);
+
+	CcTokenList* const pTokenList = &pLexer->tokenList;
+	pTokenList->count = 0;
+	pTokenList->constantCount = 0;
+	pTokenList->unmatchedIndex = SIZE_MAX;
+	pTokenList->source = nullptr;
+	pTokenList->textLength = 0;
+	ccClearSymbolTable(&pTokenList->symbols);
+
+	pLexer->string = (CcConstString){};
+	pLexer->position = 0;
+	pLexer->window = (CcWindow){.buffer = pLexer->window.buffer, .size = pLexer->window.size};
+	pLexer->peakCount = 0;
+	pLexer->finished = false;
+}
+
+void ccFreeLexer(CcLexer* const pLexer)
+{
+	assert(pLexer != nullptr);
+
+	ccReportLexer(pLexer);
+
+	ccFreeTokenList(&pLexer->tokenList);
+	ccFree(pLexer->window.buffer, pLexer->window.size);
+
+	*pLexer = (CcLexer){};
+}
+
+void ccFreeTokenList(CcTokenList* const pTokenList)
+{
+	assert(pTokenList != nullptr);
+
+	ccFree(pTokenList->values, pTokenList->capacity * ccTokenSize);
+	ccFree(pTokenList->constants, pTokenList->constantCapacity * sizeof(pTokenList->constants[0]));
+	ccFree(pTokenList->partners, pTokenList->partnerCapacity * sizeof(pTokenList->partners[0]));
+	ccFree(pTokenList->text, pTokenList->textCapacity);
+	ccFreeSymbolTable(&pTokenList->symbols);
+
+	*pTokenList = (CcTokenList){};
 }
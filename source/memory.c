@@ -1,9 +1,24 @@
 #include "cece/memory.h"
 
 #include <assert.h>
+#include <stdalign.h>
+#include <string.h>
 
 #undef ccFind
 
+struct CcArenaBlock
+{
+	CcArenaBlock* pPrevious;
+	size_t size;
+	alignas(max_align_t) unsigned char data[];
+};
+
+// Size of the data of an arena block, larger allocations get a block of their own.
+static constexpr size_t ccArenaBlockSize = 1 << 16;
+
+// Memory counters of the current thread.
+static thread_local CcMemoryStatistics ccMemoryStatistics = {};
+
 void* ccFind(const void* const pValueVoid, const void* const arrayVoid, const size_t count, const size_t size, const CcCompare compare)
 {
 	assert(pValueVoid != nullptr);
@@ -22,3 +37,224 @@ void* ccFind(const void* const pValueVoid, const void* const arrayVoid, const si
 
 	return nullptr;
 }
+
+uint64_t ccHash(const void* const data, const size_t size, const uint64_t seed)
+{
+	assert(data != nullptr || size == 0);
+
+	constexpr uint64_t multiplier = 0xC6A4A7935BD1E995;
+	constexpr int shift = 47;
+
+	const unsigned char* bytes = data;
+	const unsigned char* const end = bytes + size / 8 * 8;
+
+	uint64_t hash = seed ^ (size * multiplier);
+
+	for(; bytes < end; bytes += 8)
+	{
+		uint64_t word;
+		memcpy(&word, bytes, sizeof(word));
+
+		word *= multiplier;
+		word ^= word >> shift;
+		word *= multiplier;
+
+		hash ^= word;
+		hash *= multiplier;
+	}
+
+	const size_t remaining = size % 8;
+	if(remaining > 0)
+	{
+		for(size_t byteIndex = remaining; byteIndex > 0; --byteIndex)
+		{
+			hash ^= (uint64_t)bytes[byteIndex - 1] << (8 * (byteIndex - 1));
+		}
+		hash *= multiplier;
+	}
+
+	hash ^= hash >> shift;
+	hash *= multiplier;
+	hash ^= hash >> shift;
+
+	return hash;
+}
+
+CcMemoryStatistics* ccGetMemoryStatistics(void)
+{
+	return &ccMemoryStatistics;
+}
+
+/*
+ * Count bytes becoming live.
+ *
+ * Parameters:
+ * - size: The number of bytes.
+ */
+static void ccAddLiveBytes(const size_t size)
+{
+	ccMemoryStatistics.liveBytes += size;
+	if(ccMemoryStatistics.liveBytes > ccMemoryStatistics.peakBytes)
+	{
+		ccMemoryStatistics.peakBytes = ccMemoryStatistics.liveBytes;
+	}
+}
+
+void* ccMalloc(const size_t size)
+{
+	assert(size > 0);
+
+	void* const pointer = malloc(size);
+	if(!pointer)
+	{
+		return nullptr;
+	}
+
+	++ccMemoryStatistics.allocationCount;
+	ccMemoryStatistics.requestedBytes += size;
+	ccAddLiveBytes(size);
+
+	return pointer;
+}
+
+void* ccRealloc(void* const pointer, const size_t oldSize, const size_t newSize)
+{
+	assert(pointer != nullptr || oldSize == 0);
+	assert(newSize > 0);
+
+	if(!pointer)
+	{
+		return ccMalloc(newSize);
+	}
+
+	void* const newPointer = realloc(pointer, newSize);
+	if(!newPointer)
+	{
+		return nullptr;
+	}
+
+	++ccMemoryStatistics.reallocationCount;
+	ccMemoryStatistics.reallocatedBytes += newSize;
+	ccMemoryStatistics.liveBytes -= CC_MIN(oldSize, ccMemoryStatistics.liveBytes);
+	ccAddLiveBytes(newSize);
+
+	return newPointer;
+}
+
+void ccFree(void* const pointer, const size_t size)
+{
+	if(!pointer)
+	{
+		return;
+	}
+
+	free(pointer);
+
+	// Memory freed by another thread than the one allocating it does not make the counter wrap.
+	ccMemoryStatistics.liveBytes -= CC_MIN(size, ccMemoryStatistics.liveBytes);
+}
+
+void* ccArenaAllocate(CcArena* const pArena, const size_t size, const size_t alignment)
+{
+	assert(pArena != nullptr);
+	assert(alignment > 0 && (alignment & (alignment - 1)) == 0);
+	assert(alignment <= alignof(max_align_t));
+
+	if(pArena->pBlock)
+	{
+		const size_t offset = (pArena->used + alignment - 1) & ~(alignment - 1);
+		if(offset <= pArena->pBlock->size && size <= pArena->pBlock->size - offset)
+		{
+			pArena->used = offset + size;
+			return pArena->pBlock->data + offset;
+		}
+	}
+
+	const size_t blockSize = size > ccArenaBlockSize ? size : ccArenaBlockSize;
+	if(blockSize > ccSizeMax - sizeof(CcArenaBlock))
+	{
+		return nullptr;
+	}
+
+	// Spare blocks all have the standard size.
+	CcArenaBlock* pBlock = pArena->pSpare;
+	if(pBlock && blockSize == ccArenaBlockSize)
+	{
+		pArena->pSpare = pBlock->pPrevious;
+	}
+	else
+	{
+		pBlock = ccMalloc(sizeof(CcArenaBlock) + blockSize);
+		if(!pBlock)
+		{
+			return nullptr;
+		}
+
+		pBlock->size = blockSize;
+	}
+
+	// Keep filling the current block if the new one is dedicated to a large allocation.
+	if(pArena->pBlock && size > ccArenaBlockSize)
+	{
+		pBlock->pPrevious = pArena->pBlock->pPrevious;
+		pArena->pBlock->pPrevious = pBlock;
+	}
+	else
+	{
+		pBlock->pPrevious = pArena->pBlock;
+		pArena->pBlock = pBlock;
+		pArena->used = size;
+	}
+
+	return pBlock->data;
+}
+
+/*
+ * Free a list of arena blocks.
+ *
+ * Parameters:
+ * - pBlock: A pointer to the last block of the list, or nullptr.
+ */
+static void ccFreeArenaBlocks(CcArenaBlock* pBlock)
+{
+	while(pBlock)
+	{
+		CcArenaBlock* const pPrevious = pBlock->pPrevious;
+		ccFree(pBlock, sizeof(CcArenaBlock) + pBlock->size);
+		pBlock = pPrevious;
+	}
+}
+
+void ccResetArena(CcArena* const pArena)
+{
+	assert(pArena != nullptr);
+
+	CcArenaBlock* pBlock = pArena->pBlock;
+	while(pBlock)
+	{
+		CcArenaBlock* const pPrevious = pBlock->pPrevious;
+		if(pBlock->size == ccArenaBlockSize)
+		{
+			pBlock->pPrevious = pArena->pSpare;
+			pArena->pSpare = pBlock;
+		}
+		else
+		{
+			ccFree(pBlock, sizeof(CcArenaBlock) + pBlock->size);
+		}
+		pBlock = pPrevious;
+	}
+
+	pArena->pBlock = nullptr;
+	pArena->used = 0;
+}
+
+void ccFreeArena(CcArena* const pArena)
+{
+	assert(pArena != nullptr);
+
+	ccFreeArenaBlocks(pArena->pBlock);
+	ccFreeArenaBlocks(pArena->pSpare);
+
+	*pArena = (CcArena){};
+}
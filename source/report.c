@@ -0,0 +1,353 @@
+// Needed for clock_gettime.
+#define _POSIX_C_SOURCE 199309L
+
+#include "cece/report.h"
+
+#include <assert.h>
+#include <time.h>
+
+#include "cece/memory.h"
+
+// Report the phases of the calling thread are measured into, nullptr if they are not measured.
+static thread_local CcReport* ccReport = nullptr;
+
+#define CC_PHASE_CASE(name, string) \
+	case CC_PHASE_##name: \
+		return string;
+
+const char* ccPhaseString(const CcPhase phase)
+{
+	assert(phase >= 0 && phase < CC_PHASE_COUNT);
+
+	switch(phase)
+	{
+		CC_PHASE(CC_PHASE_CASE)
+
+		default:
+			return nullptr;
+	}
+}
+
+#define CC_BUFFER_CASE(name, string) \
+	case CC_BUFFER_##name: \
+		return string;
+
+const char* ccBufferString(const CcBuffer buffer)
+{
+	assert(buffer >= 0 && buffer < CC_BUFFER_COUNT);
+
+	switch(buffer)
+	{
+		CC_BUFFER(CC_BUFFER_CASE)
+
+		default:
+			return nullptr;
+	}
+}
+
+/*
+ * Convert a time to seconds.
+ *
+ * Parameters:
+ * - time: The time.
+ *
+ * Returns:
+ * The time in seconds.
+ */
+static double ccSeconds(const struct timespec time)
+{
+	return (double)time.tv_sec + (double)time.tv_nsec / 1e9;
+}
+
+double ccGetWallTime(void)
+{
+	struct timespec time = {};
+
+#if defined(TIME_MONOTONIC)
+	timespec_get(&time, TIME_MONOTONIC);
+#elif defined(CLOCK_MONOTONIC)
+	clock_gettime(CLOCK_MONOTONIC, &time);
+#else
+	timespec_get(&time, TIME_UTC);
+#endif
+
+	return ccSeconds(time);
+}
+
+/*
+ * Get the CPU time of the calling thread.
+ * Falls back to the CPU time of the process where threads are not measured separately.
+ *
+ * Returns:
+ * The CPU time in seconds.
+ */
+static double ccCpuTime(void)
+{
+#if defined(TIME_THREAD_ACTIVE)
+	struct timespec time = {};
+	timespec_get(&time, TIME_THREAD_ACTIVE);
+	return ccSeconds(time);
+#elif defined(CLOCK_THREAD_CPUTIME_ID)
+	struct timespec time = {};
+	clock_gettime(CLOCK_THREAD_CPUTIME_ID, &time);
+	return ccSeconds(time);
+#else
+	return (double)clock() / CLOCKS_PER_SEC;
+#endif
+}
+
+void ccSetReport(CcReport* const pReport)
+{
+	ccReport = pReport;
+}
+
+CcReport* ccGetReport(void)
+{
+	return ccReport;
+}
+
+/*
+ * Start measuring a phase from clock readings.
+ * The peak of the phase is measured from its start, the previous peak is restored when it ends.
+ *
+ * Parameters:
+ * - phase: The phase.
+ * - pTimer: A pointer to the timer of the phase.
+ * - wallTime: The wall time the phase starts at.
+ * - cpuTime: The CPU time the phase starts at.
+ */
+static void ccStartPhase(const CcPhase phase, CcPhaseTimer* const pTimer, const double wallTime, const double cpuTime)
+{
+	CcMemoryStatistics* const pMemory = ccGetMemoryStatistics();
+	pTimer->phase = phase;
+	pTimer->memory = *pMemory;
+	pMemory->peakBytes = pMemory->liveBytes;
+
+	pTimer->wallTime = wallTime;
+	pTimer->cpuTime = cpuTime;
+}
+
+/*
+ * Stop measuring a phase at clock readings and add the measurements to the report of the calling thread.
+ *
+ * Parameters:
+ * - pTimer: A pointer to the timer of the phase.
+ * - wallTime: The wall time the phase ends at.
+ * - cpuTime: The CPU time the phase ends at.
+ */
+static void ccStopPhase(const CcPhaseTimer* const pTimer, const double wallTime, const double cpuTime)
+{
+	CcPhaseReport* const pPhase = &ccReport->phases[pTimer->phase];
+	++pPhase->count;
+	pPhase->wallTime += wallTime - pTimer->wallTime;
+	pPhase->cpuTime += cpuTime - pTimer->cpuTime;
+
+	CcMemoryStatistics* const pMemory = ccGetMemoryStatistics();
+	pPhase->allocationCount += pMemory->allocationCount - pTimer->memory.allocationCount;
+	pPhase->reallocationCount += pMemory->reallocationCount - pTimer->memory.reallocationCount;
+	pPhase->requestedBytes += pMemory->requestedBytes - pTimer->memory.requestedBytes;
+	pPhase->reallocatedBytes += pMemory->reallocatedBytes - pTimer->memory.reallocatedBytes;
+	if(pMemory->peakBytes > pPhase->peakBytes)
+	{
+		pPhase->peakBytes = pMemory->peakBytes;
+	}
+
+	if(pTimer->memory.peakBytes > pMemory->peakBytes)
+	{
+		pMemory->peakBytes = pTimer->memory.peakBytes;
+	}
+}
+
+void ccBeginPhase(const CcPhase phase, CcPhaseTimer* const pTimer)
+{
+	assert(phase >= 0 && phase < CC_PHASE_COUNT);
+	assert(pTimer != nullptr);
+
+	pTimer->phase = phase;
+
+	// Reading clocks is only worth it when someone looks at the report.
+	if(!ccReport)
+	{
+		return;
+	}
+
+	ccStartPhase(phase, pTimer, ccGetWallTime(), ccCpuTime());
+}
+
+void ccEndPhase(const CcPhaseTimer* const pTimer)
+{
+	assert(pTimer != nullptr);
+
+	if(!ccReport)
+	{
+		return;
+	}
+
+	ccStopPhase(pTimer, ccGetWallTime(), ccCpuTime());
+}
+
+void ccSwitchPhase(const CcPhase phase, CcPhaseTimer* const pTimer)
+{
+	assert(phase >= 0 && phase < CC_PHASE_COUNT);
+	assert(pTimer != nullptr);
+
+	if(!ccReport)
+	{
+		pTimer->phase = phase;
+		return;
+	}
+
+	// Reading the CPU time is a system call on most platforms, both phases share the readings.
+	const double wallTime = ccGetWallTime();
+	const double cpuTime = ccCpuTime();
+	ccStopPhase(pTimer, wallTime, cpuTime);
+	ccStartPhase(phase, pTimer, wallTime, cpuTime);
+}
+
+void ccReportBuffer(const CcBuffer buffer, const size_t used, const size_t reserved)
+{
+	assert(buffer >= 0 && buffer < CC_BUFFER_COUNT);
+	assert(used <= reserved);
+
+	if(!ccReport)
+	{
+		return;
+	}
+
+	ccReport->buffers[buffer].used += used;
+	ccReport->buffers[buffer].reserved += reserved;
+}
+
+void ccMergeReport(CcReport* const pReport, const CcReport* const pOther)
+{
+	assert(pReport != nullptr);
+	assert(pOther != nullptr);
+
+	pReport->elapsedTime = CC_MAX(pReport->elapsedTime, pOther->elapsedTime);
+
+	for(size_t phaseIndex = 0; phaseIndex < CC_PHASE_COUNT; ++phaseIndex)
+	{
+		pReport->phases[phaseIndex].count += pOther->phases[phaseIndex].count;
+		pReport->phases[phaseIndex].wallTime += pOther->phases[phaseIndex].wallTime;
+		pReport->phases[phaseIndex].cpuTime += pOther->phases[phaseIndex].cpuTime;
+
+		pReport->phases[phaseIndex].allocationCount += pOther->phases[phaseIndex].allocationCount;
+		pReport->phases[phaseIndex].reallocationCount += pOther->phases[phaseIndex].reallocationCount;
+		pReport->phases[phaseIndex].requestedBytes += pOther->phases[phaseIndex].requestedBytes;
+		pReport->phases[phaseIndex].reallocatedBytes += pOther->phases[phaseIndex].reallocatedBytes;
+		pReport->phases[phaseIndex].peakBytes = CC_MAX(pReport->phases[phaseIndex].peakBytes, pOther->phases[phaseIndex].peakBytes);
+	}
+
+	for(size_t bufferIndex = 0; bufferIndex < CC_BUFFER_COUNT; ++bufferIndex)
+	{
+		pReport->buffers[bufferIndex].used += pOther->buffers[bufferIndex].used;
+		pReport->buffers[bufferIndex].reserved += pOther->buffers[bufferIndex].reserved;
+	}
+}
+
+/*
+ * Sum the measurements of all phases of a report.
+ * The wall time is the sum of the wall times of the phases, not the elapsed time.
+ *
+ * Parameters:
+ * - pReport: A pointer to the report.
+ *
+ * Returns:
+ * The measurements of all phases together.
+ */
+static CcPhaseReport ccTotalReport(const CcReport* const pReport)
+{
+	CcPhaseReport total = {};
+	for(size_t phaseIndex = 0; phaseIndex < CC_PHASE_COUNT; ++phaseIndex)
+	{
+		total.count += pReport->phases[phaseIndex].count;
+		total.wallTime += pReport->phases[phaseIndex].wallTime;
+		total.cpuTime += pReport->phases[phaseIndex].cpuTime;
+	}
+
+	return total;
+}
+
+void ccPrintTimeReport(const CcReport* const pReport, FILE* const file)
+{
+	assert(pReport != nullptr);
+	assert(file != nullptr);
+
+	const CcPhaseReport total = ccTotalReport(pReport);
+
+	fprintf(file, "%-8s %8s %12s %12s %8s\n", "Phase", "Count", "Wall (ms)", "CPU (ms)", "Wall (%)");
+	for(size_t phaseIndex = 0; phaseIndex < CC_PHASE_COUNT; ++phaseIndex)
+	{
+		const CcPhaseReport* const pPhase = &pReport->phases[phaseIndex];
+		fprintf(
+			file,
+			"%-8s %8zu %12.3f %12.3f %8.1f\n",
+			ccPhaseString(phaseIndex),
+			pPhase->count,
+			pPhase->wallTime * 1e3,
+			pPhase->cpuTime * 1e3,
+			total.wallTime > 0 ? pPhase->wallTime / total.wallTime * 100 : 0
+		);
+	}
+	fprintf(file, "%-8s %8zu %12.3f %12.3f\n", "total", total.count, pReport->elapsedTime * 1e3, total.cpuTime * 1e3);
+}
+
+void ccPrintMemoryReport(const CcReport* const pReport, FILE* const file)
+{
+	assert(pReport != nullptr);
+	assert(file != nullptr);
+
+	fprintf(file, "%-8s %10s %10s %16s %16s %12s\n", "Phase", "Allocs", "Reallocs", "Requested (KiB)", "Realloc (KiB)", "Peak (KiB)");
+	for(size_t phaseIndex = 0; phaseIndex < CC_PHASE_COUNT; ++phaseIndex)
+	{
+		const CcPhaseReport* const pPhase = &pReport->phases[phaseIndex];
+		fprintf(
+			file,
+			"%-8s %10zu %10zu %16.1f %16.1f %12.1f\n",
+			ccPhaseString(phaseIndex),
+			pPhase->allocationCount,
+			pPhase->reallocationCount,
+			pPhase->requestedBytes / 1024.0,
+			pPhase->reallocatedBytes / 1024.0,
+			pPhase->peakBytes / 1024.0
+		);
+	}
+
+	fprintf(file, "%-8s %10s %10s %16s\n", "Buffer", "Used", "Reserved", "Reserved/used");
+	for(size_t bufferIndex = 0; bufferIndex < CC_BUFFER_COUNT; ++bufferIndex)
+	{
+		const CcBufferReport* const pBuffer = &pReport->buffers[bufferIndex];
+		fprintf(
+			file,
+			"%-8s %10zu %10zu %16.2f\n",
+			ccBufferString(bufferIndex),
+			pBuffer->used,
+			pBuffer->reserved,
+			pBuffer->used > 0 ? (double)pBuffer->reserved / (double)pBuffer->used : 0
+		);
+	}
+}
+
+void ccWriteTimeReportJson(const CcReport* const pReport, FILE* const file)
+{
+	assert(pReport != nullptr);
+	assert(file != nullptr);
+
+	const CcPhaseReport total = ccTotalReport(pReport);
+
+	fputs("{\n\t\"phases\": [\n", file);
+	for(size_t phaseIndex = 0; phaseIndex < CC_PHASE_COUNT; ++phaseIndex)
+	{
+		const CcPhaseReport* const pPhase = &pReport->phases[phaseIndex];
+		fprintf(
+			file,
+			"\t\t{\"name\": \"%s\", \"count\": %zu, \"wallSeconds\": %.9f, \"cpuSeconds\": %.9f}%s\n",
+			ccPhaseString(phaseIndex),
+			pPhase->count,
+			pPhase->wallTime,
+			pPhase->cpuTime,
+			phaseIndex + 1 < CC_PHASE_COUNT ? "," : ""
+		);
+	}
+	fprintf(file, "\t],\n\t\"total\": {\"count\": %zu, \"wallSeconds\": %.9f, \"cpuSeconds\": %.9f}\n}\n", total.count, pReport->elapsedTime, total.cpuTime);
+}
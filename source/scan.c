@@ -0,0 +1,338 @@
+#include "cece/scan.h"
+
+#include <assert.h>
+#include <stdint.h>
+#include <threads.h>
+
+#include "cece/character.h"
+
+#if defined(__x86_64__) || defined(_M_X64)
+// SSE2 is part of x86-64, AVX2 is checked at runtime.
+#define CC_SCAN_X86
+#include <immintrin.h>
+#endif
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define CC_SCAN_BLOCKS
+#define CC_SCAN_AVX2
+#else
+// Vector kernels read whole aligned blocks, which may extend past the end of the string but never past its page.
+// All of them share the attribute so that they can be inlined into each other.
+#define CC_SCAN_BLOCKS __attribute__((no_sanitize_address))
+#define CC_SCAN_AVX2 __attribute__((target("avx2")))
+#endif
+
+static size_t ccScanSpacesScalar(const char* const string)
+{
+	size_t length = 0;
+	while(ccCharacterClasses[(unsigned char)string[length]] & CC_CHARACTER_SPACE)
+	{
+		++length;
+	}
+
+	return length;
+}
+
+static size_t ccScanIdentifierScalar(const char* const string)
+{
+	size_t length = 0;
+	while(ccCharacterClasses[(unsigned char)string[length]] & CC_CHARACTER_IDENTIFIER)
+	{
+		++length;
+	}
+
+	return length;
+}
+
+#ifdef CC_SCAN_X86
+
+/*
+ * Get the index of the lowest set bit of a mask.
+ *
+ * Parameters:
+ * - mask: A mask, not 0.
+ *
+ * Returns:
+ * The index of the lowest set bit.
+ */
+static size_t ccLowestBit(const uint32_t mask)
+{
+	assert(mask != 0);
+
+#if defined(_MSC_VER) && !defined(__clang__)
+	unsigned long index;
+	_BitScanForward(&index, mask);
+	return index;
+#else
+	return (size_t)__builtin_ctz(mask);
+#endif
+}
+
+/*
+ * Classify 16 characters as white space.
+ * Comparisons are signed, so characters above 0x7F are never in range.
+ *
+ * Parameters:
+ * - block: The characters.
+ *
+ * Returns:
+ * A mask with a bit set for each white space character.
+ */
+CC_SCAN_BLOCKS
+static uint32_t ccSpaceMaskSse2(const __m128i block)
+{
+	const __m128i isBlank = _mm_cmpeq_epi8(block, _mm_set1_epi8(' '));
+	const __m128i isControl = _mm_and_si128(_mm_cmpgt_epi8(block, _mm_set1_epi8('\t' - 1)), _mm_cmplt_epi8(block, _mm_set1_epi8('\r' + 1)));
+
+	return (uint32_t)_mm_movemask_epi8(_mm_or_si128(isBlank, isControl));
+}
+
+/*
+ * Classify 16 characters as identifier characters.
+ *
+ * Parameters:
+ * - block: The characters.
+ *
+ * Returns:
+ * A mask with a bit set for each identifier character.
+ */
+CC_SCAN_BLOCKS
+static uint32_t ccIdentifierMaskSse2(const __m128i block)
+{
+	const __m128i lower = _mm_or_si128(block, _mm_set1_epi8(0x20));
+
+	const __m128i isDigit = _mm_and_si128(_mm_cmpgt_epi8(block, _mm_set1_epi8('0' - 1)), _mm_cmplt_epi8(block, _mm_set1_epi8('9' + 1)));
+	const __m128i isLetter = _mm_and_si128(_mm_cmpgt_epi8(lower, _mm_set1_epi8('a' - 1)), _mm_cmplt_epi8(lower, _mm_set1_epi8('z' + 1)));
+	const __m128i isUnderscore = _mm_cmpeq_epi8(block, _mm_set1_epi8('_'));
+
+	return (uint32_t)_mm_movemask_epi8(_mm_or_si128(_mm_or_si128(isDigit, isLetter), isUnderscore));
+}
+
+/*
+ * Count the characters at the start of a string matching a class, 16 at a time.
+ *
+ * Parameters:
+ * - string: A null-terminated string, the terminator not being in the class.
+ * - classify: The function classifying 16 characters.
+ *
+ * Returns:
+ * The number of characters at the start of the string matching the class.
+ */
+CC_SCAN_BLOCKS
+static inline size_t ccScanSse2(const char* const string, uint32_t (*const classify)(__m128i))
+{
+	// Start from the aligned block holding the first character, ignoring the characters before it.
+	const uintptr_t address = (uintptr_t)string;
+	const __m128i* pBlock = (const __m128i*)(address & ~(uintptr_t)15);
+	uint32_t ignored = ((uint32_t)1 << (address & 15)) - 1;
+
+	while(true)
+	{
+		const uint32_t stops = ~(classify(_mm_load_si128(pBlock)) | ignored) & 0xFFFF;
+		if(stops != 0)
+		{
+			return (uintptr_t)pBlock + ccLowestBit(stops) - address;
+		}
+
+		ignored = 0;
+		++pBlock;
+	}
+}
+
+CC_SCAN_BLOCKS
+static size_t ccScanSpacesSse2(const char* const string)
+{
+	return ccScanSse2(string, ccSpaceMaskSse2);
+}
+
+CC_SCAN_BLOCKS
+static size_t ccScanIdentifierSse2(const char* const string)
+{
+	return ccScanSse2(string, ccIdentifierMaskSse2);
+}
+
+/*
+ * Classify 32 characters as white space.
+ *
+ * Parameters:
+ * - block: The characters.
+ *
+ * Returns:
+ * A mask with a bit set for each white space character.
+ */
+CC_SCAN_BLOCKS CC_SCAN_AVX2
+static uint32_t ccSpaceMaskAvx2(const __m256i block)
+{
+	const __m256i isBlank = _mm256_cmpeq_epi8(block, _mm256_set1_epi8(' '));
+	const __m256i isControl = _mm256_and_si256(_mm256_cmpgt_epi8(block, _mm256_set1_epi8('\t' - 1)), _mm256_cmpgt_epi8(_mm256_set1_epi8('\r' + 1), block));
+
+	return (uint32_t)_mm256_movemask_epi8(_mm256_or_si256(isBlank, isControl));
+}
+
+/*
+ * Classify 32 characters as identifier characters.
+ *
+ * Parameters:
+ * - block: The characters.
+ *
+ * Returns:
+ * A mask with a bit set for each identifier character.
+ */
+CC_SCAN_BLOCKS CC_SCAN_AVX2
+static uint32_t ccIdentifierMaskAvx2(const __m256i block)
+{
+	const __m256i lower = _mm256_or_si256(block, _mm256_set1_epi8(0x20));
+
+	const __m256i isDigit = _mm256_and_si256(_mm256_cmpgt_epi8(block, _mm256_set1_epi8('0' - 1)), _mm256_cmpgt_epi8(_mm256_set1_epi8('9' + 1), block));
+	const __m256i isLetter = _mm256_and_si256(_mm256_cmpgt_epi8(lower, _mm256_set1_epi8('a' - 1)), _mm256_cmpgt_epi8(_mm256_set1_epi8('z' + 1), lower));
+	const __m256i isUnderscore = _mm256_cmpeq_epi8(block, _mm256_set1_epi8('_'));
+
+	return (uint32_t)_mm256_movemask_epi8(_mm256_or_si256(_mm256_or_si256(isDigit, isLetter), isUnderscore));
+}
+
+/*
+ * Count the characters at the start of a string matching a class, 32 at a time.
+ *
+ * Parameters:
+ * - string: A null-terminated string, the terminator not being in the class.
+ * - classify: The function classifying 32 characters.
+ *
+ * Returns:
+ * The number of characters at the start of the string matching the class.
+ */
+CC_SCAN_BLOCKS CC_SCAN_AVX2
+static inline size_t ccScanAvx2(const char* const string, uint32_t (*const classify)(__m256i))
+{
+	const uintptr_t address = (uintptr_t)string;
+	const __m256i* pBlock = (const __m256i*)(address & ~(uintptr_t)31);
+	uint32_t ignored = (uint32_t)(((uint64_t)1 << (address & 31)) - 1);
+
+	while(true)
+	{
+		const uint32_t stops = ~(classify(_mm256_load_si256(pBlock)) | ignored);
+		if(stops != 0)
+		{
+			return (uintptr_t)pBlock + ccLowestBit(stops) - address;
+		}
+
+		ignored = 0;
+		++pBlock;
+	}
+}
+
+CC_SCAN_BLOCKS CC_SCAN_AVX2
+static size_t ccScanSpacesAvx2(const char* const string)
+{
+	return ccScanAvx2(string, ccSpaceMaskAvx2);
+}
+
+CC_SCAN_BLOCKS CC_SCAN_AVX2
+static size_t ccScanIdentifierAvx2(const char* const string)
+{
+	return ccScanAvx2(string, ccIdentifierMaskAvx2);
+}
+
+/*
+ * Check if the processor and the operating system support AVX2.
+ *
+ * Returns:
+ * - true if AVX2 can be used.
+ * - false otherwise.
+ */
+static bool ccSupportsAvx2(void)
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+	int registers[4];
+
+	__cpuid(registers, 0);
+	if(registers[0] < 7)
+	{
+		return false;
+	}
+
+	// The operating system must save the AVX registers on context switches.
+	constexpr int osxsave = 1 << 27;
+	constexpr int avx = 1 << 28;
+	__cpuid(registers, 1);
+	if((registers[2] & (osxsave | avx)) != (osxsave | avx) || (_xgetbv(0) & 6) != 6)
+	{
+		return false;
+	}
+
+	constexpr int avx2 = 1 << 5;
+	__cpuidex(registers, 7, 0);
+	return registers[1] & avx2;
+#else
+	return __builtin_cpu_supports("avx2");
+#endif
+}
+
+#endif
+
+// Implementations of the scanning functions for each instruction set, empty for those the compiler does not target.
+static const CcScanKernels ccKernels[CC_SCAN_LEVEL_COUNT] = {
+	[CC_SCAN_LEVEL_SCALAR] = {ccScanSpacesScalar, ccScanIdentifierScalar},
+#ifdef CC_SCAN_X86
+	[CC_SCAN_LEVEL_SSE2] = {ccScanSpacesSse2, ccScanIdentifierSse2},
+	[CC_SCAN_LEVEL_AVX2] = {ccScanSpacesAvx2, ccScanIdentifierAvx2}
+#endif
+};
+
+// Implementations selected for the processor.
+static CcScanKernels ccSelectedKernels;
+static once_flag ccSelectOnce = ONCE_FLAG_INIT;
+
+bool ccGetScanKernels(const CcScanLevel level, CcScanKernels* const pKernels)
+{
+	assert(level >= 0 && level < CC_SCAN_LEVEL_COUNT);
+	assert(pKernels != nullptr);
+
+	if(!ccKernels[level].scanSpaces)
+	{
+		return false;
+	}
+
+#ifdef CC_SCAN_X86
+	if(level == CC_SCAN_LEVEL_AVX2 && !ccSupportsAvx2())
+	{
+		return false;
+	}
+#endif
+
+	*pKernels = ccKernels[level];
+
+	return true;
+}
+
+/*
+ * Select the fastest implementations supported by the processor.
+ */
+static void ccSelectKernels(void)
+{
+	for(size_t level = CC_SCAN_LEVEL_COUNT; level-- > 0;)
+	{
+		if(ccGetScanKernels(level, &ccSelectedKernels))
+		{
+			return;
+		}
+	}
+}
+
+size_t ccScanSpaces(const char* const string)
+{
+	assert(string != nullptr);
+
+	call_once(&ccSelectOnce, ccSelectKernels);
+
+	return ccSelectedKernels.scanSpaces(string);
+}
+
+size_t ccScanIdentifier(const char* const string)
+{
+	assert(string != nullptr);
+
+	call_once(&ccSelectOnce, ccSelectKernels);
+
+	return ccSelectedKernels.scanIdentifier(string);
+}
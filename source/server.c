@@ -0,0 +1,887 @@
+// Needed for sockets, sigaction, poll and open_memstream.
+#define _DEFAULT_SOURCE
+
+#include "cece/server.h"
+
+#include <assert.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef _WIN32
+#include <errno.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdatomic.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <threads.h>
+#include <unistd.h>
+#endif
+
+#include "cece/cece.h"
+
+#ifndef _WIN32
+
+// Limits protecting the server from malformed requests.
+static constexpr uint32_t ccMaxArgumentCount = 1 << 16;
+static constexpr uint32_t ccMaxArgumentLength = 1 << 16;
+
+// Seconds a client has to send its request or to take a response before it is dropped, so that it cannot hold a worker.
+static constexpr time_t ccClientTimeout = 10;
+
+// Number of accepted clients waiting for a worker, past which new clients are dropped.
+static constexpr size_t ccServerQueueSize = 64;
+
+// Writing to a socket whose peer left must fail rather than raise SIGPIPE, which would kill the whole process.
+#if defined(MSG_NOSIGNAL)
+static constexpr int ccSendFlags = MSG_NOSIGNAL;
+#else
+static constexpr int ccSendFlags = 0;
+#endif
+
+/*
+ * The kind of a frame sent by the server.
+ */
+typedef enum CcFrame
+{
+	CC_FRAME_EXIT,
+	CC_FRAME_OUTPUT,
+	CC_FRAME_DIAGNOSTICS
+} CcFrame;
+
+/*
+ * The clients accepted by a compile server, waiting for one of its workers.
+ *
+ * Fields:
+ * - mutex: The mutex protecting the queue.
+ * - condition: The condition signaled when a client is queued or the server stops.
+ * - clients: The queued clients, as a ring.
+ * - start: The index of the first queued client.
+ * - count: The number of queued clients.
+ * - stopping: Whether the server stops, in which case workers exit once the queue is empty.
+ */
+typedef struct CcClientQueue
+{
+	mtx_t mutex;
+	cnd_t condition;
+
+	int clients[ccServerQueueSize];
+	size_t start;
+	size_t count;
+
+	bool stopping;
+} CcClientQueue;
+
+// The end of the pipe written to stop the server, -1 when no server runs.
+static atomic_int ccStopDescriptor = -1;
+
+static void ccHandleStop([[maybe_unused]] const int signalNumber)
+{
+	ccStopServer();
+}
+
+/*
+ * Write a whole buffer to a socket.
+ *
+ * Parameters:
+ * - descriptor: The socket.
+ * - data: The data to write.
+ * - size: The size of the data.
+ *
+ * Returns:
+ * - true on success.
+ * - false otherwise.
+ */
+static bool ccWriteAll(const int descriptor, const void* const data, size_t size)
+{
+	const char* bytes = data;
+	while(size > 0)
+	{
+		const ssize_t written = send(descriptor, bytes, size, ccSendFlags);
+		if(written < 0 && errno == EINTR)
+		{
+			continue;
+		}
+		if(written <= 0)
+		{
+			return false;
+		}
+
+		bytes += written;
+		size -= (size_t)written;
+	}
+
+	return true;
+}
+
+/*
+ * Read a whole buffer from a socket.
+ *
+ * Parameters:
+ * - descriptor: The socket.
+ * - data: The buffer to fill.
+ * - size: The size of the buffer.
+ *
+ * Returns:
+ * - true on success.
+ * - false otherwise.
+ */
+static bool ccReadAll(const int descriptor, void* const data, size_t size)
+{
+	char* bytes = data;
+	while(size > 0)
+	{
+		const ssize_t count = read(descriptor, bytes, size);
+		if(count < 0 && errno == EINTR)
+		{
+			continue;
+		}
+		if(count <= 0)
+		{
+			return false;
+		}
+
+		bytes += count;
+		size -= (size_t)count;
+	}
+
+	return true;
+}
+
+/*
+ * Keep a socket from raising SIGPIPE where sending cannot be told not to, as on BSD and macOS.
+ *
+ * Parameters:
+ * - descriptor: The socket.
+ */
+static void ccPreventSignals([[maybe_unused]] const int descriptor)
+{
+#if !defined(MSG_NOSIGNAL) && defined(SO_NOSIGPIPE)
+	const int enabled = 1;
+	setsockopt(descriptor, SOL_SOCKET, SO_NOSIGPIPE, &enabled, sizeof(enabled));
+#endif
+}
+
+static bool ccWriteUint32(const int descriptor, const uint32_t value)
+{
+	const unsigned char bytes[4] = {value & 0xFF, (value >> 8) & 0xFF, (value >> 16) & 0xFF, value >> 24};
+
+	return ccWriteAll(descriptor, bytes, sizeof(bytes));
+}
+
+static bool ccReadUint32(const int descriptor, uint32_t* const pValue)
+{
+	unsigned char bytes[4];
+	if(!ccReadAll(descriptor, bytes, sizeof(bytes)))
+	{
+		return false;
+	}
+
+	*pValue = (uint32_t)bytes[0] | (uint32_t)bytes[1] << 8 | (uint32_t)bytes[2] << 16 | (uint32_t)bytes[3] << 24;
+
+	return true;
+}
+
+// Write a length-prefixed string to a socket.
+static bool ccWriteString(const int descriptor, const char* const string, const size_t length)
+{
+	if(length > UINT32_MAX)
+	{
+		return false;
+	}
+
+	return ccWriteUint32(descriptor, (uint32_t)length) && ccWriteAll(descriptor, string, length);
+}
+
+// Read a length-prefixed string from a socket, returning a null-terminated string to free or nullptr on failure.
+static char* ccReadString(const int descriptor)
+{
+	uint32_t length;
+	if(!ccReadUint32(descriptor, &length) || length > ccMaxArgumentLength)
+	{
+		return nullptr;
+	}
+
+	char* const string = malloc((size_t)length + 1);
+	if(!string)
+	{
+		return nullptr;
+	}
+
+	if(!ccReadAll(descriptor, string, length))
+	{
+		free(string);
+		return nullptr;
+	}
+	string[length] = '\0';
+
+	return string;
+}
+
+static bool ccWriteFrame(const int descriptor, const CcFrame frame, const char* const data, const size_t size)
+{
+	const unsigned char kind = (unsigned char)frame;
+
+	return ccWriteAll(descriptor, &kind, 1) && ccWriteString(descriptor, data, size);
+}
+
+/*
+ * Resolve a path against the directory of a client.
+ *
+ * Parameters:
+ * - directory: The directory of the client.
+ * - pPath: A pointer to the path, replaced by the resolved one if it is relative. Nothing is done if it is nullptr.
+ *
+ * Returns:
+ * - true on success.
+ * - false if memory allocation fails, in which case the path is left untouched.
+ */
+static bool ccResolvePath(const char* const directory, char** const pPath)
+{
+	if(!*pPath || (*pPath)[0] == '/')
+	{
+		return true;
+	}
+
+	const size_t directoryLength = strlen(directory);
+	const size_t pathLength = strlen(*pPath);
+	char* const path = malloc(directoryLength + 1 + pathLength + 1);
+	if(!path)
+	{
+		return false;
+	}
+
+	memcpy(path, directory, directoryLength);
+	path[directoryLength] = '/';
+	memcpy(path + directoryLength + 1, *pPath, pathLength + 1);
+
+	free(*pPath);
+	*pPath = path;
+
+	return true;
+}
+
+/*
+ * Resolve the paths of options against the directory of a client.
+ * Requests run concurrently, so the server cannot change its current directory to the one of a client.
+ *
+ * Parameters:
+ * - directory: The directory of the client.
+ * - pOptions: A pointer to the options.
+ *
+ * Returns:
+ * - CC_SUCCESS on success.
+ * - CC_ERROR_INVALID_ARGUMENT if an input is standard input, which belongs to the server.
+ * - CC_ERROR_OUT_OF_MEMORY if memory allocation fails.
+ */
+static CcResult ccResolveOptions(const char* const directory, CcOptions* const pOptions)
+{
+	bool resolved = ccResolvePath(directory, &pOptions->cacheDirectory) && ccResolvePath(directory, &pOptions->timeReportPath);
+	for(size_t inputIndex = 0; resolved && inputIndex < pOptions->inputCount; ++inputIndex)
+	{
+		if(strcmp(pOptions->inputs[inputIndex], "-") == 0)
+		{
+			ccDiagnose("Cannot compile standard input through the server.");
+			return CC_ERROR_INVALID_ARGUMENT;
+		}
+
+		resolved = ccResolvePath(directory, &pOptions->inputs[inputIndex]) && ccResolvePath(directory, &pOptions->outputs[inputIndex]);
+	}
+
+	if(!resolved)
+	{
+		ccDiagnose("Failed to allocate memory.");
+		return CC_ERROR_OUT_OF_MEMORY;
+	}
+
+	return CC_SUCCESS;
+}
+
+/*
+ * Run a command line the way main does.
+ *
+ * Parameters:
+ * - directory: The directory relative paths are resolved from.
+ * - argumentCount: The number of arguments.
+ * - arguments: The arguments.
+ * - output: The stream to write the usage to.
+ *
+ * Returns:
+ * The result of the command line.
+ */
+static CcResult ccRunCommand(const char* const directory, const size_t argumentCount, const char* const* const arguments, FILE* const output)
+{
+	if(argumentCount == 0)
+	{
+		ccPrintUsage(ccGetDiagnosticFile());
+		return CC_ERROR_INVALID_ARGUMENT;
+	}
+
+	CcOptions options;
+	CcResult result = ccParseArguments(argumentCount, arguments, &options);
+	if(result != CC_SUCCESS)
+	{
+		return result;
+	}
+
+	if(options.usage)
+	{
+		ccPrintUsage(output);
+		return CC_SUCCESS;
+	}
+
+	result = ccResolveOptions(directory, &options);
+	if(result == CC_SUCCESS)
+	{
+		result = ccCompile(&options);
+	}
+	ccFreeOptions(&options);
+
+	return result;
+}
+
+/*
+ * Serve a single client request.
+ *
+ * Parameters:
+ * - client: The socket of the client.
+ */
+static void ccServeClient(const int client)
+{
+	char* directory = nullptr;
+	char** arguments = nullptr;
+	uint32_t argumentCount = 0;
+
+	char* output = nullptr;
+	size_t outputSize = 0;
+	char* diagnostics = nullptr;
+	size_t diagnosticsSize = 0;
+
+	directory = ccReadString(client);
+	if(!directory || !ccReadUint32(client, &argumentCount) || argumentCount > ccMaxArgumentCount)
+	{
+		goto end;
+	}
+
+	arguments = calloc(argumentCount + 1, sizeof(arguments[0]));
+	if(!arguments)
+	{
+		goto end;
+	}
+
+	for(uint32_t argumentIndex = 0; argumentIndex < argumentCount; ++argumentIndex)
+	{
+		arguments[argumentIndex] = ccReadString(client);
+		if(!arguments[argumentIndex])
+		{
+			goto end;
+		}
+	}
+
+	FILE* const outputFile = open_memstream(&output, &outputSize);
+	FILE* const diagnosticFile = open_memstream(&diagnostics, &diagnosticsSize);
+	if(!outputFile || !diagnosticFile)
+	{
+		if(outputFile)
+		{
+			fclose(outputFile);
+		}
+		if(diagnosticFile)
+		{
+			fclose(diagnosticFile);
+		}
+
+		goto end;
+	}
+
+	ccSetDiagnosticFile(diagnosticFile);
+
+	const CcResult result = ccRunCommand(directory, argumentCount, (const char* const*)arguments, outputFile);
+
+	ccSetDiagnosticFile(nullptr);
+
+	fclose(outputFile);
+	fclose(diagnosticFile);
+
+	if(ccWriteFrame(client, CC_FRAME_OUTPUT, output, outputSize) && ccWriteFrame(client, CC_FRAME_DIAGNOSTICS, diagnostics, diagnosticsSize))
+	{
+		const unsigned char code = (unsigned char)result;
+		ccWriteFrame(client, CC_FRAME_EXIT, (const char*)&code, 1);
+	}
+
+	end:
+	free(diagnostics);
+	free(output);
+
+	if(arguments)
+	{
+		for(uint32_t argumentIndex = 0; argumentIndex < argumentCount; ++argumentIndex)
+		{
+			free(arguments[argumentIndex]);
+		}
+		free(arguments);
+	}
+
+	free(directory);
+}
+
+/*
+ * Queue an accepted client for the workers.
+ *
+ * Parameters:
+ * - pQueue: A pointer to the queue.
+ * - client: The socket of the client.
+ *
+ * Returns:
+ * - true if the client is queued.
+ * - false if the queue is full.
+ */
+static bool ccQueueClient(CcClientQueue* const pQueue, const int client)
+{
+	mtx_lock(&pQueue->mutex);
+
+	const bool queued = pQueue->count < ccServerQueueSize;
+	if(queued)
+	{
+		pQueue->clients[(pQueue->start + pQueue->count) % ccServerQueueSize] = client;
+		++pQueue->count;
+		cnd_signal(&pQueue->condition);
+	}
+
+	mtx_unlock(&pQueue->mutex);
+
+	return queued;
+}
+
+/*
+ * Serve queued clients until the server stops.
+ * Each worker keeps a workspace for as long as the server runs, so that the tokens, symbols, tree and diagnostic records of a request reuse the storage of the previous ones.
+ * Files compiled by the extra jobs of a request are not in a worker thread, and use their own storage.
+ *
+ * Parameters:
+ * - pQueueVoid: A pointer to the queue of clients.
+ *
+ * Returns:
+ * Always 0.
+ */
+static int ccRunServerWorker(void* const pQueueVoid)
+{
+	CcClientQueue* const pQueue = pQueueVoid;
+
+	CcWorkspace workspace = {};
+	ccSetWorkspace(&workspace);
+
+	while(true)
+	{
+		mtx_lock(&pQueue->mutex);
+		while(pQueue->count == 0 && !pQueue->stopping)
+		{
+			cnd_wait(&pQueue->condition, &pQueue->mutex);
+		}
+
+		// Clients queued before the server stopped are still served.
+		if(pQueue->count == 0)
+		{
+			mtx_unlock(&pQueue->mutex);
+			break;
+		}
+
+		const int client = pQueue->clients[pQueue->start];
+		pQueue->start = (pQueue->start + 1) % ccServerQueueSize;
+		--pQueue->count;
+
+		mtx_unlock(&pQueue->mutex);
+
+		ccServeClient(client);
+		close(client);
+	}
+
+	ccSetWorkspace(nullptr);
+	ccFreeWorkspace(&workspace);
+
+	return 0;
+}
+
+/*
+ * Accept clients on a listening socket until the server is asked to stop.
+ *
+ * Parameters:
+ * - server: The listening socket.
+ * - stopDescriptor: The end of the pipe which becomes readable when the server is asked to stop.
+ * - pQueue: A pointer to the queue of clients.
+ */
+static void ccAcceptClients(const int server, const int stopDescriptor, CcClientQueue* const pQueue)
+{
+	// A client has to send its request and take its response in time, so that a silent one cannot hold a worker.
+	const struct timeval timeout = {.tv_sec = ccClientTimeout};
+
+	while(true)
+	{
+		struct pollfd descriptors[] = {
+			{.fd = server, .events = POLLIN},
+			{.fd = stopDescriptor, .events = POLLIN}
+		};
+		if(poll(descriptors, CC_LEN(descriptors), -1) == -1)
+		{
+			if(errno == EINTR)
+			{
+				continue;
+			}
+
+			ccDiagnose("Failed to wait for clients.");
+			return;
+		}
+
+		if(descriptors[1].revents != 0)
+		{
+			return;
+		}
+
+		if(!(descriptors[0].revents & POLLIN))
+		{
+			continue;
+		}
+
+		const int client = accept(server, nullptr, nullptr);
+		if(client == -1)
+		{
+			continue;
+		}
+
+		setsockopt(client, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+		setsockopt(client, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+		ccPreventSignals(client);
+
+		if(!ccQueueClient(pQueue, client))
+		{
+			close(client);
+		}
+	}
+}
+
+// Fill a socket address from a path, failing if the path is too long.
+static bool ccSocketAddress(const char* const path, struct sockaddr_un* const pAddress)
+{
+	*pAddress = (struct sockaddr_un){.sun_family = AF_UNIX};
+
+	const size_t length = strlen(path);
+	if(length >= sizeof(pAddress->sun_path))
+	{
+		ccDiagnose("Socket path too long.");
+		return false;
+	}
+
+	memcpy(pAddress->sun_path, path, length + 1);
+
+	return true;
+}
+
+/*
+ * Serve the clients of a listening socket with a pool of workers until the server is asked to stop.
+ *
+ * Parameters:
+ * - server: The listening socket.
+ * - workerCount: The number of workers.
+ *
+ * Returns:
+ * The same values as ccRunServer.
+ */
+static CcResult ccServe(const int server, const size_t workerCount)
+{
+	CcResult result = CC_SUCCESS;
+
+	CcClientQueue queue = {};
+	thrd_t* workers = nullptr;
+	size_t startedCount = 0;
+
+	int stopPipe[2];
+	if(pipe(stopPipe) != 0)
+	{
+		ccDiagnose("Failed to create pipe.");
+		return CC_ERROR_UNKNOWN;
+	}
+	atomic_store(&ccStopDescriptor, stopPipe[1]);
+
+	if(mtx_init(&queue.mutex, mtx_plain) != thrd_success)
+	{
+		ccDiagnose("Failed to create mutex.");
+		result = CC_ERROR_UNKNOWN;
+		goto end;
+	}
+
+	if(cnd_init(&queue.condition) != thrd_success)
+	{
+		ccDiagnose("Failed to create condition.");
+		result = CC_ERROR_UNKNOWN;
+		goto mutex;
+	}
+
+	workers = malloc(workerCount * sizeof(workers[0]));
+	if(!workers)
+	{
+		ccDiagnose("Out of memory.");
+		result = CC_ERROR_OUT_OF_MEMORY;
+		goto condition;
+	}
+
+	// The server runs with the workers that could start.
+	while(startedCount < workerCount && thrd_create(&workers[startedCount], ccRunServerWorker, &queue) == thrd_success)
+	{
+		++startedCount;
+	}
+	if(startedCount == 0)
+	{
+		ccDiagnose("Failed to start workers.");
+		result = CC_ERROR_UNKNOWN;
+		goto workers;
+	}
+
+	ccAcceptClients(server, stopPipe[0], &queue);
+
+	mtx_lock(&queue.mutex);
+	queue.stopping = true;
+	cnd_broadcast(&queue.condition);
+	mtx_unlock(&queue.mutex);
+
+	for(size_t workerIndex = 0; workerIndex < startedCount; ++workerIndex)
+	{
+		thrd_join(workers[workerIndex], nullptr);
+	}
+
+	workers:
+	free(workers);
+
+	condition:
+	cnd_destroy(&queue.condition);
+
+	mutex:
+	mtx_destroy(&queue.mutex);
+
+	end:
+	atomic_store(&ccStopDescriptor, -1);
+	close(stopPipe[0]);
+	close(stopPipe[1]);
+
+	return result;
+}
+
+#endif
+
+CcResult ccRunServer(const char* const path, size_t workerCount)
+{
+	assert(path != nullptr);
+
+#ifdef _WIN32
+	(void)workerCount;
+
+	ccDiagnose("The compile server is not supported on this platform.");
+	return CC_ERROR_UNKNOWN;
+#else
+	struct sockaddr_un address;
+	if(!ccSocketAddress(path, &address))
+	{
+		return CC_ERROR_INVALID_ARGUMENT;
+	}
+
+	if(workerCount == 0)
+	{
+		const long processorCount = sysconf(_SC_NPROCESSORS_ONLN);
+		workerCount = processorCount > 0 ? (size_t)processorCount : 1;
+	}
+
+	// Replace a socket left behind by a previous server, but nothing else.
+	struct stat status;
+	if(lstat(path, &status) == 0)
+	{
+		if(!S_ISSOCK(status.st_mode))
+		{
+			ccDiagnose("\"%s\" exists and is not a socket.", path);
+			return CC_ERROR_INVALID_ARGUMENT;
+		}
+
+		unlink(path);
+	}
+
+	const int server = socket(AF_UNIX, SOCK_STREAM, 0);
+	if(server == -1)
+	{
+		ccDiagnose("Failed to create socket.");
+		return CC_ERROR_UNKNOWN;
+	}
+
+	CcResult result = CC_SUCCESS;
+
+	if(bind(server, (const struct sockaddr*)&address, sizeof(address)) != 0 || listen(server, SOMAXCONN) != 0)
+	{
+		ccDiagnose("Failed to listen on \"%s\".", path);
+		result = CC_ERROR_UNKNOWN;
+		goto end;
+	}
+
+	// The signals stop the server the way ccStopServer does, their previous handlers are restored once it is stopped.
+	struct sigaction action = {.sa_handler = ccHandleStop};
+	sigemptyset(&action.sa_mask);
+	struct sigaction previousInterrupt;
+	struct sigaction previousTermination;
+	sigaction(SIGINT, &action, &previousInterrupt);
+	sigaction(SIGTERM, &action, &previousTermination);
+
+	// Without a way to keep sockets from raising SIGPIPE, it is ignored while serving, so that a client disconnecting early does not kill the server.
+#if !defined(MSG_NOSIGNAL) && !defined(SO_NOSIGPIPE)
+	const struct sigaction ignore = {.sa_handler = SIG_IGN};
+	struct sigaction previousPipe;
+	sigaction(SIGPIPE, &ignore, &previousPipe);
+#endif
+
+	result = ccServe(server, workerCount);
+
+#if !defined(MSG_NOSIGNAL) && !defined(SO_NOSIGPIPE)
+	sigaction(SIGPIPE, &previousPipe, nullptr);
+#endif
+	sigaction(SIGINT, &previousInterrupt, nullptr);
+	sigaction(SIGTERM, &previousTermination, nullptr);
+
+	unlink(path);
+
+	end:
+	close(server);
+
+	return result;
+#endif
+}
+
+void ccStopServer(void)
+{
+#ifndef _WIN32
+	// Only writing to the pipe, which is safe in a signal handler.
+	const int descriptor = atomic_load(&ccStopDescriptor);
+	if(descriptor != -1)
+	{
+		const char byte = 0;
+		[[maybe_unused]] const ssize_t written = write(descriptor, &byte, 1);
+	}
+#endif
+}
+
+CcResult ccRunClient(const char* const path, const size_t argumentCount, const char* const* const arguments)
+{
+	assert(path != nullptr);
+	assert(argumentCount == 0 || arguments != nullptr);
+
+#ifdef _WIN32
+	(void)argumentCount;
+	(void)arguments;
+
+	ccDiagnose("The compile server is not supported on this platform.");
+	return CC_ERROR_UNKNOWN;
+#else
+	struct sockaddr_un address;
+	if(!ccSocketAddress(path, &address))
+	{
+		return CC_ERROR_INVALID_ARGUMENT;
+	}
+
+	if(argumentCount > ccMaxArgumentCount)
+	{
+		ccDiagnose("Too many arguments.");
+		return CC_ERROR_INVALID_ARGUMENT;
+	}
+
+	const int server = socket(AF_UNIX, SOCK_STREAM, 0);
+	if(server == -1)
+	{
+		ccDiagnose("Failed to create socket.");
+		return CC_ERROR_UNKNOWN;
+	}
+	ccPreventSignals(server);
+
+	CcResult result = CC_ERROR_UNKNOWN;
+	char* directory = nullptr;
+	char* data = nullptr;
+
+	if(connect(server, (const struct sockaddr*)&address, sizeof(address)) != 0)
+	{
+		ccDiagnose("Failed to connect to server \"%s\".", path);
+		result = CC_ERROR_FILE_NOT_FOUND;
+		goto end;
+	}
+
+	directory = getcwd(nullptr, 0);
+	if(!directory)
+	{
+		ccDiagnose("Failed to get current directory.");
+		goto end;
+	}
+
+	// Send request.
+	if(!ccWriteString(server, directory, strlen(directory)) || !ccWriteUint32(server, (uint32_t)argumentCount))
+	{
+		goto connection;
+	}
+	for(size_t argumentIndex = 0; argumentIndex < argumentCount; ++argumentIndex)
+	{
+		if(!ccWriteString(server, arguments[argumentIndex], strlen(arguments[argumentIndex])))
+		{
+			goto connection;
+		}
+	}
+
+	// Forward frames until the exit code arrives.
+	while(true)
+	{
+		unsigned char kind;
+		uint32_t size;
+		if(!ccReadAll(server, &kind, 1) || !ccReadUint32(server, &size))
+		{
+			goto connection;
+		}
+
+		data = malloc(size > 0 ? size : 1);
+		if(!data)
+		{
+			ccDiagnose("Out of memory.");
+			result = CC_ERROR_OUT_OF_MEMORY;
+			goto end;
+		}
+		if(!ccReadAll(server, data, size))
+		{
+			goto connection;
+		}
+
+		switch(kind)
+		{
+			case CC_FRAME_OUTPUT:
+				fwrite(data, 1, size, stdout);
+				break;
+
+			case CC_FRAME_DIAGNOSTICS:
+				fwrite(data, 1, size, ccGetDiagnosticFile());
+				break;
+
+			case CC_FRAME_EXIT:
+				result = size == 1 ? (CcResult)(unsigned char)data[0] : CC_ERROR_UNKNOWN;
+				goto end;
+
+			default:
+				goto connection;
+		}
+
+		CC_FREE(data);
+	}
+
+	connection:
+	ccDiagnose("Lost connection to server.");
+	result = CC_ERROR_UNKNOWN;
+
+	end:
+	free(data);
+	free(directory);
+	close(server);
+
+	return result;
+#endif
+}
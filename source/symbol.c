@@ -0,0 +1,256 @@
+#include "cece/symbol.h"
+
+#include <assert.h>
+#include <string.h>
+
+// Seed of the hashes of names.
+static constexpr uint64_t ccSymbolSeed = 0x9E3779B97F4A7C15;
+
+// Number of slots of a symbol table once it holds a symbol, a power of two.
+static constexpr size_t ccMinimumSymbolSlots = 64;
+
+// Capacity of the symbols of a symbol table once it holds a symbol.
+static constexpr size_t ccMinimumSymbolCapacity = 32;
+
+/*
+ * Hash a name.
+ *
+ * Parameters:
+ * - name: The characters of the name.
+ * - length: The length of the name.
+ *
+ * Returns:
+ * The hash of the name.
+ */
+static uint32_t ccHashSymbol(const char* const name, const size_t length)
+{
+	const uint64_t hash = ccHash(name, length, ccSymbolSeed);
+
+	return (uint32_t)(hash ^ (hash >> 32));
+}
+
+/*
+ * Find the slot of a name in a symbol table with slots.
+ *
+ * Parameters:
+ * - pTable: A pointer to a symbol table.
+ * - name: The characters of the name.
+ * - length: The length of the name.
+ * - hash: The hash of the name.
+ * - pProbeLength: A pointer to store the number of slots inspected.
+ *
+ * Returns:
+ * The slot holding the name if it is in the table, the empty slot it would go to otherwise.
+ */
+static size_t ccProbeSymbol(const CcSymbolTable* const pTable, const char* const name, const size_t length, const uint32_t hash, size_t* const pProbeLength)
+{
+	const size_t mask = pTable->slotCount - 1;
+
+	size_t slotIndex = hash & mask;
+	size_t probeLength = 1;
+	while(pTable->slots[slotIndex] != 0)
+	{
+		const CcSymbol* const pSymbol = &pTable->symbols[pTable->slots[slotIndex] - 1];
+		if(pSymbol->hash == hash && pSymbol->length == length && memcmp(pSymbol->name, name, length) == 0)
+		{
+			break;
+		}
+
+		slotIndex = (slotIndex + 1) & mask;
+		++probeLength;
+	}
+
+	*pProbeLength = probeLength;
+
+	return slotIndex;
+}
+
+/*
+ * Double the number of slots of a symbol table.
+ * Symbols are placed again from their stored hash, names are not hashed again.
+ *
+ * Parameters:
+ * - pTable: A pointer to a symbol table.
+ *
+ * Returns:
+ * - true on success.
+ * - false if memory allocation fails, in which case the table is left untouched.
+ */
+static bool ccGrowSymbolSlots(CcSymbolTable* const pTable)
+{
+	if(pTable->slotCount > ccSizeMax / sizeof(pTable->slots[0]) / 2)
+	{
+		return false;
+	}
+
+	const size_t slotCount = pTable->slotCount > 0 ? pTable->slotCount * 2 : ccMinimumSymbolSlots;
+	uint32_t* const slots = ccMalloc(slotCount * sizeof(slots[0]));
+	if(!slots)
+	{
+		return false;
+	}
+	memset(slots, 0, slotCount * sizeof(slots[0]));
+
+	const size_t mask = slotCount - 1;
+	for(size_t symbolIndex = 0; symbolIndex < pTable->count; ++symbolIndex)
+	{
+		size_t slotIndex = pTable->symbols[symbolIndex].hash & mask;
+		while(slots[slotIndex] != 0)
+		{
+			slotIndex = (slotIndex + 1) & mask;
+		}
+		slots[slotIndex] = symbolIndex + 1;
+	}
+
+	ccFree(pTable->slots, pTable->slotCount * sizeof(pTable->slots[0]));
+	pTable->slots = slots;
+	pTable->slotCount = slotCount;
+
+	return true;
+}
+
+CcResult ccInternSymbol(CcSymbolTable* const pTable, const char* const name, const size_t length, uint32_t* const pSymbol)
+{
+	assert(pTable != nullptr);
+	assert(name != nullptr || length == 0);
+	assert(pSymbol != nullptr);
+
+	if(length > UINT32_MAX)
+	{
+		return CC_ERROR_INVALID_ARGUMENT;
+	}
+
+	const uint32_t hash = ccHashSymbol(name, length);
+
+	size_t slotIndex = 0;
+	size_t probeLength = 0;
+	if(pTable->slotCount > 0)
+	{
+		slotIndex = ccProbeSymbol(pTable, name, length, hash, &probeLength);
+		if(pTable->slots[slotIndex] != 0)
+		{
+			*pSymbol = pTable->slots[slotIndex] - 1;
+			goto end;
+		}
+	}
+
+	// Slots hold symbol + 1.
+	if(pTable->count >= UINT32_MAX)
+	{
+		return CC_ERROR_INVALID_ARGUMENT;
+	}
+
+	if(pTable->count == pTable->capacity)
+	{
+		if(pTable->capacity > ccSizeMax / sizeof(pTable->symbols[0]) / 2)
+		{
+			return CC_ERROR_OUT_OF_MEMORY;
+		}
+
+		const size_t capacity = pTable->capacity > 0 ? pTable->capacity * 2 : ccMinimumSymbolCapacity;
+		CcSymbol* const symbols = ccRealloc(pTable->symbols, pTable->capacity * sizeof(pTable->symbols[0]), capacity * sizeof(pTable->symbols[0]));
+		if(!symbols)
+		{
+			return CC_ERROR_OUT_OF_MEMORY;
+		}
+		pTable->symbols = symbols;
+		pTable->capacity = capacity;
+	}
+
+	// The table stays at most half full to keep probe sequences short.
+	if((pTable->count + 1) * 2 > pTable->slotCount)
+	{
+		if(!ccGrowSymbolSlots(pTable))
+		{
+			return CC_ERROR_OUT_OF_MEMORY;
+		}
+
+		slotIndex = ccProbeSymbol(pTable, name, length, hash, &probeLength);
+	}
+
+	char* const copy = ccArenaAllocate(&pTable->names, CC_MAX(length, 1), 1);
+	if(!copy)
+	{
+		return CC_ERROR_OUT_OF_MEMORY;
+	}
+	if(length > 0)
+	{
+		memcpy(copy, name, length);
+	}
+
+	*pSymbol = pTable->count;
+	pTable->symbols[pTable->count] = (CcSymbol){copy, length, hash};
+	++pTable->count;
+	pTable->slots[slotIndex] = pTable->count;
+
+	end:
+	++pTable->lookupCount;
+	pTable->probeCount += probeLength;
+	pTable->maximumProbeLength = CC_MAX(pTable->maximumProbeLength, probeLength);
+
+	return CC_SUCCESS;
+}
+
+bool ccFindSymbol(const CcSymbolTable* const pTable, const char* const name, const size_t length, uint32_t* const pSymbol)
+{
+	assert(pTable != nullptr);
+	assert(name != nullptr || length == 0);
+	assert(pSymbol != nullptr);
+
+	if(pTable->slotCount == 0 || length > UINT32_MAX)
+	{
+		return false;
+	}
+
+	size_t probeLength;
+	const size_t slotIndex = ccProbeSymbol(pTable, name, length, ccHashSymbol(name, length), &probeLength);
+	if(pTable->slots[slotIndex] == 0)
+	{
+		return false;
+	}
+
+	*pSymbol = pTable->slots[slotIndex] - 1;
+
+	return true;
+}
+
+CcSymbolStatistics ccGetSymbolStatistics(const CcSymbolTable* const pTable)
+{
+	assert(pTable != nullptr);
+
+	return (CcSymbolStatistics){
+		.symbolCount = pTable->count,
+		.slotCount = pTable->slotCount,
+		.loadFactor = pTable->slotCount > 0 ? (double)pTable->count / pTable->slotCount : 0.0,
+		.lookupCount = pTable->lookupCount,
+		.averageProbeLength = pTable->lookupCount > 0 ? (double)pTable->probeCount / pTable->lookupCount : 0.0,
+		.maximumProbeLength = pTable->maximumProbeLength
+	};
+}
+
+void ccClearSymbolTable(CcSymbolTable* const pTable)
+{
+	assert(pTable != nullptr);
+
+	if(pTable->slotCount > 0)
+	{
+		memset(pTable->slots, 0, pTable->slotCount * sizeof(pTable->slots[0]));
+	}
+	ccResetArena(&pTable->names);
+
+	pTable->count = 0;
+	pTable->lookupCount = 0;
+	pTable->probeCount = 0;
+	pTable->maximumProbeLength = 0;
+}
+
+void ccFreeSymbolTable(CcSymbolTable* const pTable)
+{
+	assert(pTable != nullptr);
+
+	ccFree(pTable->slots, pTable->slotCount * sizeof(pTable->slots[0]));
+	ccFree(pTable->symbols, pTable->capacity * sizeof(pTable->symbols[0]));
+	ccFreeArena(&pTable->names);
+
+	*pTable = (CcSymbolTable){};
+}
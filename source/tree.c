@@ -4,7 +4,9 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include "cece/diagnostic.h"
 #include "cece/memory.h"
+#include "cece/report.h"
 
 #ifndef NDEBUG
 static bool ccAssertBuilder(const CcTreeBuilder* const pBuilder)
@@ -12,373 +14,514 @@ static bool ccAssertBuilder(const CcTreeBuilder* const pBuilder)
 	assert(pBuilder != nullptr);
 
 	assert(pBuilder->pTree != nullptr);
-	assert(pBuilder->pTree->nodes != nullptr);
+	assert(pBuilder->pTree->types != nullptr);
+	assert(pBuilder->pTree->payloads != nullptr);
 	assert(pBuilder->pTree->children != nullptr);
 
 	assert(pBuilder->tokens != nullptr);
-	assert(pBuilder->tokens->tokens != nullptr);
+	assert(pBuilder->tokens->pTokenList != nullptr);
 	// assert(pBuilder->tokens->count > 0);
 
 	return true;
 }
 #endif
 
+/*
+ * Add a node to a tree with room for it.
+ *
+ * Parameters:
+ * - pTree: A pointer to the tree.
+ * - type: The type of the node.
+ * - payload: The payload of the node.
+ */
+static void ccAddNode(CcTree* const pTree, const CcNodeType type, const uint32_t payload)
+{
+	assert(pTree->count < pTree->nodeCapacity);
+
+	pTree->types[pTree->count] = type;
+	pTree->payloads[pTree->count] = payload;
+	++pTree->count;
+}
+
+/*
+ * Add a constant node to a tree with room for it.
+ *
+ * Parameters:
+ * - pTree: A pointer to the tree.
+ * - constant: The constant.
+ */
+static void ccAddConstant(CcTree* const pTree, const CcConstant constant)
+{
+	assert(pTree->constantCount < pTree->constantCapacity);
+
+	pTree->constants[pTree->constantCount] = constant;
+	ccAddNode(pTree, CC_NODE_CONSTANT, pTree->constantCount);
+	++pTree->constantCount;
+}
+
+/*
+ * Add a binary operator node to a tree with room for it.
+ *
+ * Parameters:
+ * - pTree: A pointer to the tree.
+ * - binOpNode: The operator and its operands.
+ */
+static void ccAddBinOp(CcTree* const pTree, const CcBinOpNode binOpNode)
+{
+	assert(pTree->binOpCount < pTree->binOpCapacity);
+
+	pTree->binOps[pTree->binOpCount] = binOpNode;
+	ccAddNode(pTree, CC_NODE_BIN_OP, pTree->binOpCount);
+	++pTree->binOpCount;
+}
+
+/*
+ * Add a function node to a tree with room for it.
+ *
+ * Parameters:
+ * - pTree: A pointer to the tree.
+ * - function: The name and statements of the function.
+ */
+static void ccAddFunction(CcTree* const pTree, const CcFunctionNode function)
+{
+	assert(pTree->functionCount < pTree->functionCapacity);
+
+	pTree->functions[pTree->functionCount] = function;
+	ccAddNode(pTree, CC_NODE_FUNCTION, pTree->functionCount);
+	++pTree->functionCount;
+}
+
+CcNode ccGetNode(const CcTree* const pTree, const size_t nodeIndex)
+{
+	assert(pTree != nullptr);
+	assert(nodeIndex < pTree->count);
+
+	CcNode node = {.type = pTree->types[nodeIndex]};
+	const uint32_t payload = pTree->payloads[nodeIndex];
+	switch(node.type)
+	{
+		case CC_NODE_PROGRAM:
+			node.program = pTree->programs[payload];
+			break;
+
+		case CC_NODE_FUNCTION:
+			node.function = pTree->functions[payload];
+			break;
+
+		case CC_NODE_RETURN:
+			node.returnNode = payload;
+			break;
+
+		case CC_NODE_BIN_OP:
+			node.binOpNode = pTree->binOps[payload];
+			break;
+
+		case CC_NODE_CONSTANT:
+			node.constant = pTree->constants[payload];
+			break;
+	}
+
+	return node;
+}
+
 bool ccSkipParentheses(size_t* const pTokenIndex, const CcConstTokenList* const tokens, const CcDirection direction)
 {
 	assert(pTokenIndex != nullptr);
 
 	assert(tokens != nullptr);
-	assert(tokens->tokens != nullptr);
 	assert(tokens->count > 0);
 
 	assert(*pTokenIndex < tokens->count);
 
 	assert(direction == CC_DIRECTION_FORWARD || direction == CC_DIRECTION_BACKWARD);
 
-	const CcTokenType type = tokens->tokens[*pTokenIndex].type;
-
+	const CcTokenType type = ccGetTokenTypes(tokens)[*pTokenIndex];
 	if(type != CC_TOKEN_OPEN_PARENTHESIS && type != CC_TOKEN_CLOSE_PARENTHESIS)
 	{
 		return true;
 	}
 
-	if(direction == CC_DIRECTION_FORWARD && type == CC_TOKEN_CLOSE_PARENTHESIS)
+	if(direction == CC_DIRECTION_FORWARD ? type != CC_TOKEN_OPEN_PARENTHESIS : type != CC_TOKEN_CLOSE_PARENTHESIS)
 	{
 		return false;
 	}
-	if(direction == CC_DIRECTION_BACKWARD && type == CC_TOKEN_OPEN_PARENTHESIS)
+
+	// Brackets are matched by the lexer.
+	const size_t partner = ccGetTokenPartner(tokens, *pTokenIndex);
+	if(partner == SIZE_MAX)
 	{
 		return false;
 	}
 
-	const CcTokenType plusType = type;
-	const CcTokenType minusType = direction == CC_DIRECTION_FORWARD ? CC_TOKEN_CLOSE_PARENTHESIS : CC_TOKEN_OPEN_PARENTHESIS;
-
-	size_t parenthesisCount = 1;
-	while(direction == CC_DIRECTION_FORWARD ? *pTokenIndex < tokens->count - 1 : *pTokenIndex > 0)
-	{
-		*pTokenIndex += direction;
-
-		const CcTokenType currentType = tokens->tokens[*pTokenIndex].type;
+	*pTokenIndex = partner;
 
-		parenthesisCount += currentType == plusType;
-		parenthesisCount -= currentType == minusType;
+	return true;
+}
 
-		if(parenthesisCount == 0)
-		{
-			return true;
-		}
+/*
+ * Report the first unmatched bracket of a range of tokens.
+ *
+ * Parameters:
+ * - tokens: A pointer to a range of tokens whose brackets are matched.
+ *
+ * Returns:
+ * - true if the range holds an unmatched bracket, which is reported.
+ * - false otherwise.
+ */
+static bool ccReportUnmatchedBracket(const CcConstTokenList* const tokens)
+{
+	const CcTokenList* const pTokenList = tokens->pTokenList;
+	if(pTokenList->unmatchedIndex == SIZE_MAX || pTokenList->unmatchedIndex < tokens->start || pTokenList->unmatchedIndex - tokens->start >= tokens->count)
+	{
+		return false;
 	}
 
-	return false;
+	ccReportDiagnostic(CC_DIAGNOSTIC_UNMATCHED_BRACKET, pTokenList->source + pTokenList->offsets[pTokenList->unmatchedIndex]);
+
+	return true;
 }
 
-typedef enum CcParseResult
+/*
+ * Get the binary operator of a token type.
+ * Precedences go from 1 for || to 10 for multiplicative operators, all of them being left-associative.
+ *
+ * Parameters:
+ * - type: A token type.
+ * - pBinOp: A pointer to store the operator.
+ *
+ * Returns:
+ * The precedence of the operator, 0 if the token is not a binary operator.
+ */
+static unsigned int ccGetBinaryOperator(const CcTokenType type, CcBinOp* const pBinOp)
 {
-	CC_PARSE_INVALID,
-	CC_PARSE_MATCH,
-	CC_PARSE_NO_MATCH
-} CcParseResult;
+	switch(type)
+	{
+		case CC_TOKEN_BAR_BAR:
+			*pBinOp = CC_BIN_OP_LOR;
+			return 1;
 
-static CcParseResult ccParseBinaryOperator(CcTreeBuilder* const pBuilder, const CcTokenType* const tokens, const CcBinOp* const binOps, const size_t count)
-{
-	assert(ccAssertBuilder(pBuilder));
+		case CC_TOKEN_AMPERSAND_AMPERSAND:
+			*pBinOp = CC_BIN_OP_LAND;
+			return 2;
 
-	size_t tokenIndex = pBuilder->tokens->count - 1;
-	while(tokenIndex > 0)
-	{
-		if(!ccSkipParentheses(&tokenIndex, pBuilder->tokens, CC_DIRECTION_BACKWARD))
-		{
-			return CC_PARSE_INVALID;
-		}
-		--tokenIndex;
+		case CC_TOKEN_BAR:
+			*pBinOp = CC_BIN_OP_OR;
+			return 3;
 
-		size_t matchIndex;
-		for(matchIndex = 0; matchIndex < count; ++matchIndex)
-		{
-			if(pBuilder->tokens->tokens[tokenIndex].type == tokens[matchIndex])
-			{
-				goto parse;
-			}
-		}
-		continue;
+		case CC_TOKEN_CARET:
+			*pBinOp = CC_BIN_OP_XOR;
+			return 4;
 
-		parse:
-		if(tokenIndex == 0 || tokenIndex == pBuilder->tokens->count - 1)
-		{
-			return false;
-		}
+		case CC_TOKEN_AMPERSAND:
+			*pBinOp = CC_BIN_OP_AND;
+			return 5;
 
-		if(!ccParseExpression(&(CcTreeBuilder){
-			.pTree = pBuilder->pTree,
-			.tokens = &(CcConstTokenList){
-				pBuilder->tokens->tokens,
-				tokenIndex
-			}
-		}))
-		{
-			return CC_PARSE_INVALID;
-		}
+		case CC_TOKEN_EQUAL_EQUAL:
+			*pBinOp = CC_BIN_OP_EQ;
+			return 6;
 
-		const size_t leftNodeIndex = pBuilder->pTree->count - 1;
+		case CC_TOKEN_NOT_EQUAL:
+			*pBinOp = CC_BIN_OP_NEQ;
+			return 6;
 
-		if(!ccParseExpression(&(CcTreeBuilder){
-			.pTree = pBuilder->pTree,
-			.tokens = &(CcConstTokenList){
-				pBuilder->tokens->tokens + tokenIndex + 1,
-				pBuilder->tokens->count - tokenIndex - 1
-			}
-		}))
-		{
-			return CC_PARSE_INVALID;
-		}
+		case CC_TOKEN_LESS:
+			*pBinOp = CC_BIN_OP_LE;
+			return 7;
 
-		pBuilder->pTree->nodes[pBuilder->pTree->count].type = CC_NODE_BIN_OP;
-		pBuilder->pTree->nodes[pBuilder->pTree->count].binOpNode.op = binOps[matchIndex];
+		case CC_TOKEN_LESS_EQUAL:
+			*pBinOp = CC_BIN_OP_LEQ;
+			return 7;
 
-		pBuilder->pTree->nodes[pBuilder->pTree->count].binOpNode.leftNode = leftNodeIndex;
-		pBuilder->pTree->nodes[pBuilder->pTree->count].binOpNode.rightNode = pBuilder->pTree->count - 1;
+		case CC_TOKEN_GREATER:
+			*pBinOp = CC_BIN_OP_GE;
+			return 7;
 
-		++pBuilder->pTree->count;
+		case CC_TOKEN_GREATER_EQUAL:
+			*pBinOp = CC_BIN_OP_GEQ;
+			return 7;
 
-		return CC_PARSE_MATCH;
-	}
+		case CC_TOKEN_LEFT_SHIFT:
+			*pBinOp = CC_BIN_OP_LS;
+			return 8;
 
-	return CC_PARSE_NO_MATCH;
-}
+		case CC_TOKEN_RIGHT_SHIFT:
+			*pBinOp = CC_BIN_OP_RS;
+			return 8;
 
-bool ccParseExpression(CcTreeBuilder* const pBuilder)
-{
-	assert(ccAssertBuilder(pBuilder));
+		case CC_TOKEN_PLUS:
+			*pBinOp = CC_BIN_OP_SUM;
+			return 9;
 
-	// Remove potential outer parentheses.
-	size_t tokenIndex = 0;
-	if(!ccSkipParentheses(&tokenIndex, pBuilder->tokens, CC_DIRECTION_FORWARD))
-	{
-		return false;
-	}
-	if(pBuilder->tokens->tokens[tokenIndex].type == CC_TOKEN_CLOSE_PARENTHESIS && tokenIndex == pBuilder->tokens->count - 1)
-	{
-		if(pBuilder->tokens->count < 3)
-		{
-			return false;
-		}
+		case CC_TOKEN_MINUS:
+			*pBinOp = CC_BIN_OP_DIF;
+			return 9;
 
-		return ccParseExpression(&(CcTreeBuilder){
-			.pTree = pBuilder->pTree,
-			.tokens = &(CcConstTokenList){
-				.tokens = pBuilder->tokens->tokens + 1,
-				.count = pBuilder->tokens->count - 2
-			}
-		});
-	}
+		case CC_TOKEN_STAR:
+			*pBinOp = CC_BIN_OP_MUL;
+			return 10;
 
-	{
-		constexpr CcTokenType tokens[] = {CC_TOKEN_BAR_BAR};
-		constexpr CcBinOp binOps[] = {CC_BIN_OP_LOR};
-		constexpr size_t count = CC_LEN(tokens);
-		static_assert(CC_LEN(binOps) == count);
+		case CC_TOKEN_SLASH:
+			*pBinOp = CC_BIN_OP_DIV;
+			return 10;
 
-		const CcParseResult result = ccParseBinaryOperator(pBuilder, tokens, binOps, count);
-		if(result == CC_PARSE_INVALID)
-		{
-			return false;
-		}
-		if(result == CC_PARSE_MATCH)
-		{
-			return true;
-		}
+		case CC_TOKEN_PERCENT:
+			*pBinOp = CC_BIN_OP_MOD;
+			return 10;
+
+		default:
+			return 0;
 	}
+}
 
-	{
-		constexpr CcTokenType tokens[] = {CC_TOKEN_AMPERSAND_AMPERSAND};
-		constexpr CcBinOp binOps[] = {CC_BIN_OP_LAND};
-		constexpr size_t count = CC_LEN(tokens);
-		static_assert(CC_LEN(binOps) == count);
+// Default highest number of nested parentheses in an expression.
+static constexpr size_t ccDefaultNestingLimit = 1 << 16;
 
-		const CcParseResult result = ccParseBinaryOperator(pBuilder, tokens, binOps, count);
-		if(result == CC_PARSE_INVALID)
-		{
-			return false;
-		}
-		if(result == CC_PARSE_MATCH)
-		{
-			return true;
-		}
-	}
+// Highest number of nested parentheses in an expression on each thread, 0 for the default.
+static thread_local size_t ccNestingLimit = 0;
 
-	{
-		constexpr CcTokenType tokens[] = {CC_TOKEN_BAR};
-		constexpr CcBinOp binOps[] = {CC_BIN_OP_OR};
-		constexpr size_t count = CC_LEN(tokens);
-		static_assert(CC_LEN(binOps) == count);
+// Number of operators an expression can hold pending before its stack is moved to the heap.
+static constexpr size_t ccLocalOperatorCount = 64;
 
-		const CcParseResult result = ccParseBinaryOperator(pBuilder, tokens, binOps, count);
-		if(result == CC_PARSE_INVALID)
+/*
+ * An operator waiting for its right operand while parsing an expression.
+ *
+ * Fields:
+ * - leftNode: The index of the node of the left operand.
+ * - binOp: The operator.
+ * - precedence: The precedence of the operator, 0 for an open parenthesis.
+ */
+typedef struct CcPendingOperator
+{
+	uint32_t leftNode;
+	CcBinOp binOp;
+	unsigned int precedence;
+} CcPendingOperator;
+
+/*
+ * The stack of the operators of an expression.
+ * It starts in a local array and moves to the heap when it outgrows it.
+ *
+ * Fields:
+ * - operators: The operators, the last one being the top of the stack.
+ * - count: The number of operators.
+ * - capacity: The number of operators allocated.
+ * - local: The initial storage of the operators.
+ */
+typedef struct CcOperatorStack
+{
+	CcPendingOperator* operators;
+	size_t count;
+	size_t capacity;
+
+	CcPendingOperator local[ccLocalOperatorCount];
+} CcOperatorStack;
+
+/*
+ * Push an operator on an operator stack.
+ *
+ * Parameters:
+ * - pStack: A pointer to the stack.
+ * - pOperator: A pointer to the operator.
+ *
+ * Returns:
+ * - true on success.
+ * - false if memory allocation fails.
+ */
+static bool ccPushOperator(CcOperatorStack* const pStack, const CcPendingOperator* const pOperator)
+{
+	if(pStack->count == pStack->capacity)
+	{
+		if(pStack->capacity > ccSizeMax / sizeof(pStack->operators[0]) / 2)
 		{
 			return false;
 		}
-		if(result == CC_PARSE_MATCH)
-		{
-			return true;
-		}
-	}
-
-	{
-		constexpr CcTokenType tokens[] = {CC_TOKEN_CARET};
-		constexpr CcBinOp binOps[] = {CC_BIN_OP_XOR};
-		constexpr size_t count = CC_LEN(tokens);
-		static_assert(CC_LEN(binOps) == count);
 
-		const CcParseResult result = ccParseBinaryOperator(pBuilder, tokens, binOps, count);
-		if(result == CC_PARSE_INVALID)
+		const size_t capacity = pStack->capacity * 2;
+		CcPendingOperator* operators;
+		if(pStack->operators == pStack->local)
 		{
-			return false;
+			operators = ccMalloc(capacity * sizeof(operators[0]));
+			if(operators)
+			{
+				memcpy(operators, pStack->local, sizeof(pStack->local));
+			}
 		}
-		if(result == CC_PARSE_MATCH)
+		else
 		{
-			return true;
+			operators = ccRealloc(pStack->operators, pStack->capacity * sizeof(operators[0]), capacity * sizeof(operators[0]));
 		}
-	}
-
-	{
-		constexpr CcTokenType tokens[] = {CC_TOKEN_AMPERSAND};
-		constexpr CcBinOp binOps[] = {CC_BIN_OP_AND};
-		constexpr size_t count = CC_LEN(tokens);
-		static_assert(CC_LEN(binOps) == count);
-
-		const CcParseResult result = ccParseBinaryOperator(pBuilder, tokens, binOps, count);
-		if(result == CC_PARSE_INVALID)
+		if(!operators)
 		{
 			return false;
 		}
-		if(result == CC_PARSE_MATCH)
-		{
-			return true;
-		}
+
+		pStack->operators = operators;
+		pStack->capacity = capacity;
 	}
 
+	pStack->operators[pStack->count] = *pOperator;
+	++pStack->count;
+
+	return true;
+}
+
+/*
+ * Pop the operators at the top of an operator stack whose precedence is at least a given one, adding their nodes.
+ *
+ * Parameters:
+ * - pBuilder: A pointer to the tree builder.
+ * - pStack: A pointer to the stack.
+ * - minimumPrecedence: The lowest precedence of the operators to pop, at least 1 so open parentheses stay.
+ */
+static void ccPopOperators(CcTreeBuilder* const pBuilder, CcOperatorStack* const pStack, const unsigned int minimumPrecedence)
+{
+	while(pStack->count > 0 && pStack->operators[pStack->count - 1].precedence >= minimumPrecedence)
 	{
-		constexpr CcTokenType tokens[] = {CC_TOKEN_EQUAL_EQUAL, CC_TOKEN_NOT_EQUAL};
-		constexpr CcBinOp binOps[] = {CC_BIN_OP_EQ, CC_BIN_OP_NEQ};
-		constexpr size_t count = CC_LEN(tokens);
-		static_assert(CC_LEN(binOps) == count);
+		const CcPendingOperator* const pOperator = &pStack->operators[pStack->count - 1];
 
-		const CcParseResult result = ccParseBinaryOperator(pBuilder, tokens, binOps, count);
-		if(result == CC_PARSE_INVALID)
-		{
-			return false;
-		}
-		if(result == CC_PARSE_MATCH)
-		{
-			return true;
-		}
+		// The right operand is the last node added.
+		ccAddBinOp(pBuilder->pTree, (CcBinOpNode){pOperator->binOp, pOperator->leftNode, pBuilder->pTree->count - 1});
+
+		--pStack->count;
 	}
+}
 
-	{
-		constexpr CcTokenType tokens[] = {CC_TOKEN_LESS, CC_TOKEN_LESS_EQUAL, CC_TOKEN_GREATER, CC_TOKEN_GREATER_EQUAL};
-		constexpr CcBinOp binOps[] = {CC_BIN_OP_LE, CC_BIN_OP_LEQ, CC_BIN_OP_GE, CC_BIN_OP_GEQ};
-		constexpr size_t count = CC_LEN(tokens);
-		static_assert(CC_LEN(binOps) == count);
+void ccSetNestingLimit(const size_t limit)
+{
+	ccNestingLimit = limit;
+}
 
-		const CcParseResult result = ccParseBinaryOperator(pBuilder, tokens, binOps, count);
-		if(result == CC_PARSE_INVALID)
+bool ccParseExpression(CcTreeBuilder* const pBuilder)
+{
+	assert(ccAssertBuilder(pBuilder));
+
+	const uint8_t* const types = ccGetTokenTypes(pBuilder->tokens);
+	const size_t nestingLimit = ccNestingLimit > 0 ? ccNestingLimit : ccDefaultNestingLimit;
+
+	CcOperatorStack stack;
+	stack.operators = stack.local;
+	stack.count = 0;
+	stack.capacity = ccLocalOperatorCount;
+
+	// Operators wait on the stack until one of lower precedence comes, making operators of the same precedence left-associative.
+	// Nodes come in the order of a post-order traversal, operators after their operands.
+	bool result = false;
+	size_t nestingCount = 0;
+	size_t tokenIndex = 0;
+	while(true)
+	{
+		// Operand.
+		if(tokenIndex >= pBuilder->tokens->count)
 		{
-			return false;
+			goto end;
 		}
-		if(result == CC_PARSE_MATCH)
+
+		if(types[tokenIndex] == CC_TOKEN_OPEN_PARENTHESIS)
 		{
-			return true;
-		}
-	}
+			if(nestingCount == nestingLimit)
+			{
+				const CcTokenList* const pTokenList = pBuilder->tokens->pTokenList;
+				ccReportDiagnostic(CC_DIAGNOSTIC_NESTING_TOO_DEEP, pTokenList->source + pTokenList->offsets[pBuilder->tokens->start + tokenIndex]);
+				goto end;
+			}
 
-	{
-		constexpr CcTokenType tokens[] = {CC_TOKEN_LEFT_SHIFT, CC_TOKEN_RIGHT_SHIFT};
-		constexpr CcBinOp binOps[] = {CC_BIN_OP_LS, CC_BIN_OP_RS};
-		constexpr size_t count = CC_LEN(tokens);
-		static_assert(CC_LEN(binOps) == count);
+			if(!ccPushOperator(&stack, &(const CcPendingOperator){}))
+			{
+				ccDiagnose("Failed to allocate memory.");
+				goto end;
+			}
+			++nestingCount;
 
-		const CcParseResult result = ccParseBinaryOperator(pBuilder, tokens, binOps, count);
-		if(result == CC_PARSE_INVALID)
-		{
-			return false;
+			++tokenIndex;
+			continue;
 		}
-		if(result == CC_PARSE_MATCH)
+
+		if(types[tokenIndex] != CC_TOKEN_CONSTANT)
 		{
-			return true;
+			goto end;
 		}
-	}
 
-	{
-		constexpr CcTokenType tokens[] = {CC_TOKEN_PLUS, CC_TOKEN_MINUS};
-		constexpr CcBinOp binOps[] = {CC_BIN_OP_SUM, CC_BIN_OP_DIF};
-		constexpr size_t count = CC_LEN(tokens);
-		static_assert(CC_LEN(binOps) == count);
+		ccAddConstant(pBuilder->pTree, ccGetTokenConstant(pBuilder->tokens, tokenIndex));
+		++tokenIndex;
 
-		const CcParseResult result = ccParseBinaryOperator(pBuilder, tokens, binOps, count);
-		if(result == CC_PARSE_INVALID)
+		// Operators and closing parentheses following the operand.
+		while(tokenIndex < pBuilder->tokens->count && types[tokenIndex] == CC_TOKEN_CLOSE_PARENTHESIS)
 		{
-			return false;
+			if(nestingCount == 0)
+			{
+				goto end;
+			}
+
+			ccPopOperators(pBuilder, &stack, 1);
+			--stack.count;
+			--nestingCount;
+
+			++tokenIndex;
 		}
-		if(result == CC_PARSE_MATCH)
+
+		if(tokenIndex == pBuilder->tokens->count)
 		{
-			return true;
+			// The expression must span all the tokens.
+			if(nestingCount == 0)
+			{
+				ccPopOperators(pBuilder, &stack, 1);
+				result = true;
+			}
+			goto end;
 		}
-	}
-
-	{
-		constexpr CcTokenType tokens[] = {CC_TOKEN_STAR, CC_TOKEN_SLASH, CC_TOKEN_PERCENT};
-		constexpr CcBinOp binOps[] = {CC_BIN_OP_MUL, CC_BIN_OP_DIV, CC_BIN_OP_MOD};
-		constexpr size_t count = CC_LEN(tokens);
-		static_assert(CC_LEN(binOps) == count);
 
-		const CcParseResult result = ccParseBinaryOperator(pBuilder, tokens, binOps, count);
-		if(result == CC_PARSE_INVALID)
+		CcBinOp binOp;
+		const unsigned int precedence = ccGetBinaryOperator(types[tokenIndex], &binOp);
+		if(precedence == 0)
 		{
-			return false;
+			goto end;
 		}
-		if(result == CC_PARSE_MATCH)
+
+		ccPopOperators(pBuilder, &stack, precedence);
+		if(!ccPushOperator(&stack, &(const CcPendingOperator){pBuilder->pTree->count - 1, binOp, precedence}))
 		{
-			return true;
+			ccDiagnose("Failed to allocate memory.");
+			goto end;
 		}
+
+		++tokenIndex;
 	}
 
-	if(pBuilder->tokens->count == 1 && pBuilder->tokens->tokens[0].type == CC_TOKEN_CONSTANT)
+	end:
+	if(stack.operators != stack.local)
 	{
-		pBuilder->pTree->nodes[pBuilder->pTree->count].type = CC_NODE_CONSTANT;
-		pBuilder->pTree->nodes[pBuilder->pTree->count].constant = pBuilder->tokens->tokens[0].constant;
-
-		++pBuilder->pTree->count;
-
-		return true;
+		ccFree(stack.operators, stack.capacity * sizeof(stack.operators[0]));
 	}
 
-	return false;
+	return result;
 }
 
 bool ccParseStatement(CcTreeBuilder* const pBuilder)
 {
 	assert(ccAssertBuilder(pBuilder));
 
-	if(pBuilder->tokens->tokens[0].type != CC_TOKEN_RETURN)
+	const uint8_t* const types = ccGetTokenTypes(pBuilder->tokens);
+
+	if(types[0] != CC_TOKEN_RETURN)
 	{
 		return false;
 	}
 
-	const CcToken* pToken = pBuilder->tokens->tokens + 1;
-	while(pToken < pBuilder->tokens->tokens + pBuilder->tokens->count)
+	size_t tokenIndex = 1;
+	while(tokenIndex < pBuilder->tokens->count)
 	{
-		if(pToken->type == CC_TOKEN_SEMICOLON)
+		if(types[tokenIndex] == CC_TOKEN_SEMICOLON)
 		{
-			const bool empty = pToken == pBuilder->tokens->tokens + 1;
+			const bool empty = tokenIndex == 1;
 
 			if(!empty)
 			{
 				if(!ccParseExpression(&(CcTreeBuilder){
 					.pTree = pBuilder->pTree,
 					.tokens = &(CcConstTokenList){
-						pBuilder->tokens->tokens + 1,
-						pToken - pBuilder->tokens->tokens - 1
+						pBuilder->tokens->pTokenList,
+						pBuilder->tokens->start + 1,
+						tokenIndex - 1
 					}
 				}))
 				{
@@ -386,16 +529,15 @@ bool ccParseStatement(CcTreeBuilder* const pBuilder)
 				}
 			}
 
-			pBuilder->pTree->nodes[pBuilder->pTree->count] = (CcNode){.type = CC_NODE_RETURN, .returnNode = empty ? SIZE_MAX : pBuilder->pTree->count - 1};
-			++pBuilder->pTree->count;
+			ccAddNode(pBuilder->pTree, CC_NODE_RETURN, empty ? UINT32_MAX : pBuilder->pTree->count - 1);
 
-			pBuilder->tokens->count -= pToken - pBuilder->tokens->tokens + 1;
-			pBuilder->tokens->tokens = pToken + 1;
+			pBuilder->tokens->start += tokenIndex + 1;
+			pBuilder->tokens->count -= tokenIndex + 1;
 
 			return true;
 		}
 
-		++pToken;
+		++tokenIndex;
 	}
 
 	return false;
@@ -415,54 +557,65 @@ static void ccCommitChildren(CcTreeBuilder* const pBuilder, const size_t childCo
 	assert(ccAssertBuilder(pBuilder));
 	assert(childCount > 0);
 
-	memmove(pBuilder->pTree->children + pBuilder->childCount, pBuilder->pTree->children + pBuilder->lastIndex, childCount * sizeof(pBuilder->pTree->children));
+	memmove(pBuilder->pTree->children + pBuilder->childCount, pBuilder->pTree->children + pBuilder->lastIndex, childCount * sizeof(pBuilder->pTree->children[0]));
 	pBuilder->childCount += childCount;
 	pBuilder->lastIndex += childCount;
 }
 
 bool ccParseFunction(CcTreeBuilder* const pBuilder)
 {
-	if(pBuilder->tokens->tokens[0].type != CC_TOKEN_INT)
+	if(ccGetTokenTypes(pBuilder->tokens)[0] != CC_TOKEN_INT)
 	{
 		return false;
 	}
 
-	++pBuilder->tokens->tokens;
+	++pBuilder->tokens->start;
 	--pBuilder->tokens->count;
 	if(pBuilder->tokens->count == 0)
 	{
 		return false;
 	}
 
-	if(pBuilder->tokens->tokens[0].type != CC_TOKEN_IDENTIFIER)
+	if(ccGetTokenTypes(pBuilder->tokens)[0] != CC_TOKEN_IDENTIFIER)
 	{
 		return false;
 	}
 
-	const CcToken* const pNameToken = pBuilder->tokens->tokens;
+	// The tree interns the names of its functions, so that it can name them once its tokens are freed.
+	const CcStringView name = ccGetTokenString(pBuilder->tokens, 0);
+	uint32_t symbol;
+	const CcResult result = ccInternSymbol(&pBuilder->pTree->symbols, name.string, name.length, &symbol);
+	if(result != CC_SUCCESS)
+	{
+		if(result == CC_ERROR_OUT_OF_MEMORY)
+		{
+			ccDiagnose("Failed to allocate memory.");
+		}
+		return false;
+	}
 
-	++pBuilder->tokens->tokens;
+	++pBuilder->tokens->start;
 	--pBuilder->tokens->count;
 	if(pBuilder->tokens->count == 0)
 	{
 		return false;
 	}
 
-	if(pBuilder->tokens->tokens[0].type != CC_TOKEN_OPEN_PARENTHESIS)
+	if(ccGetTokenTypes(pBuilder->tokens)[0] != CC_TOKEN_OPEN_PARENTHESIS)
 	{
 		return false;
 	}
 
-	++pBuilder->tokens->tokens;
+	++pBuilder->tokens->start;
 	--pBuilder->tokens->count;
 	if(pBuilder->tokens->count == 0)
 	{
 		return false;
 	}
 
-	if(pBuilder->tokens->tokens[0].type == CC_TOKEN_VOID)
+	if(ccGetTokenTypes(pBuilder->tokens)[0] == CC_TOKEN_VOID)
 	{
-		++pBuilder->tokens->tokens;
+		++pBuilder->tokens->start;
 		--pBuilder->tokens->count;
 		if(pBuilder->tokens->count == 0)
 		{
@@ -470,129 +623,424 @@ bool ccParseFunction(CcTreeBuilder* const pBuilder)
 		}
 	}
 
-	if(pBuilder->tokens->tokens[0].type != CC_TOKEN_CLOSE_PARENTHESIS)
+	if(ccGetTokenTypes(pBuilder->tokens)[0] != CC_TOKEN_CLOSE_PARENTHESIS)
 	{
 		return false;
 	}
 
-	++pBuilder->tokens->tokens;
+	++pBuilder->tokens->start;
 	--pBuilder->tokens->count;
 	if(pBuilder->tokens->count == 0)
 	{
 		return false;
 	}
 
-	if(pBuilder->tokens->tokens[0].type != CC_TOKEN_OPEN_BRACE)
+	if(ccGetTokenTypes(pBuilder->tokens)[0] != CC_TOKEN_OPEN_BRACE)
 	{
 		return false;
 	}
 
-	++pBuilder->tokens->tokens;
-	--pBuilder->tokens->count;
-	if(pBuilder->tokens->count == 0)
+	// The body ends at the matching brace.
+	const size_t closeIndex = ccGetTokenPartner(pBuilder->tokens, 0);
+	if(closeIndex == SIZE_MAX)
 	{
 		return false;
 	}
+	const size_t tokenCount = closeIndex - 1;
+
+	++pBuilder->tokens->start;
+	--pBuilder->tokens->count;
 
-	size_t braceCount = 1;
-	const CcToken* pToken = pBuilder->tokens->tokens;
-	while(pToken < pBuilder->tokens->tokens + pBuilder->tokens->count)
+	if(tokenCount == 0)
 	{
-		braceCount += pToken->type == CC_TOKEN_OPEN_BRACE;
-		braceCount -= pToken->type == CC_TOKEN_CLOSE_BRACE;
+		ccAddFunction(pBuilder->pTree, (CcFunctionNode){.symbol = symbol});
 
-		if(braceCount == 0)
+		++pBuilder->tokens->start;
+		--pBuilder->tokens->count;
+
+		return true;
+	}
+
+	CcTreeBuilder builder = {
+		.pTree = pBuilder->pTree,
+		.tokens = &(CcConstTokenList){
+			pBuilder->tokens->pTokenList,
+			pBuilder->tokens->start,
+			tokenCount
+		}
+	};
+
+	size_t statementCount = 0;
+	while(builder.tokens->count > 0)
+	{
+		if(!ccParseStatement(&builder))
 		{
-			if(pToken == pBuilder->tokens->tokens)
-			{
-				pBuilder->pTree->nodes[pBuilder->pTree->count].type = CC_NODE_FUNCTION;
-				pBuilder->pTree->nodes[pBuilder->pTree->count].function.name = pNameToken->string;
-				pBuilder->pTree->nodes[pBuilder->pTree->count].function.statementsCount = 0;
+			return false;
+		}
 
-				++pBuilder->pTree->count;
+		ccStoreChild(pBuilder);
 
-				++pBuilder->tokens->tokens;
-				--pBuilder->tokens->count;
+		++statementCount;
+	}
 
-				return true;
-			}
+	if(statementCount > 0)
+	{
+		ccCommitChildren(pBuilder, statementCount);
+	}
 
-			const size_t tokenCount = pToken - pBuilder->tokens->tokens;
+	ccAddFunction(pBuilder->pTree, (CcFunctionNode){symbol, pBuilder->childCount - 1, statementCount});
 
-			CcTreeBuilder builder = {
-				.pTree = pBuilder->pTree,
-				.tokens = &(CcConstTokenList){
-					pBuilder->tokens->tokens,
-					tokenCount
-				}
-			};
+	pBuilder->tokens->start += tokenCount + 1;
+	pBuilder->tokens->count -= tokenCount + 1;
 
-			size_t statementCount = 0;
-			while(builder.tokens->count > 0)
-			{
-				if(!ccParseStatement(&builder))
-				{
-					return false;
-				}
+	return true;
+}
+
+/*
+ * Add the program node, whose children are the last ones stored.
+ *
+ * Parameters:
+ * - pBuilder: A pointer to the tree builder.
+ * - childCount: The number of children stored.
+ */
+static void ccAddProgram(CcTreeBuilder* const pBuilder, const size_t childCount)
+{
+	if(childCount > 0)
+	{
+		ccCommitChildren(pBuilder, childCount);
+	}
 
-				ccStoreChild(pBuilder);
+	CcTree* const pTree = pBuilder->pTree;
+	assert(pTree->programCount < pTree->programCapacity);
 
-				++statementCount;
-			}
+	pTree->programs[pTree->programCount] = (CcProgramNode){pBuilder->childCount - 1, childCount};
+	ccAddNode(pTree, CC_NODE_PROGRAM, pTree->programCount);
+	++pTree->programCount;
+}
+
+bool ccParseProgram(CcTreeBuilder* const pBuilder)
+{
+	assert(ccAssertBuilder(pBuilder));
+
+	size_t childCount = 0;
+	while(pBuilder->tokens->count > 0)
+	{
+		if(!ccParseFunction(pBuilder))
+		{
+			return false;
+		}
+
+		ccStoreChild(pBuilder);
+
+		++childCount;
+	}
+
+	ccAddProgram(pBuilder, childCount);
+
+	return pBuilder->tokens->count == 0;
+}
+
+/*
+ * Change the capacity of an array of a tree.
+ *
+ * Parameters:
+ * - pArray: A pointer to the array, freed if the new capacity is 0.
+ * - elementSize: The size of an element of the array.
+ * - capacity: The capacity of the array.
+ * - newCapacity: The new capacity.
+ *
+ * Returns:
+ * - true on success.
+ * - false if memory allocation fails, in which case the array is left untouched.
+ */
+static bool ccResizeTreeArray(void** const pArray, const size_t elementSize, const size_t capacity, const size_t newCapacity)
+{
+	if(newCapacity == 0)
+	{
+		ccFree(*pArray, capacity * elementSize);
+		*pArray = nullptr;
+		return true;
+	}
+
+	void* const array = ccRealloc(*pArray, capacity * elementSize, newCapacity * elementSize);
+	if(!array)
+	{
+		return false;
+	}
+	*pArray = array;
+
+	return true;
+}
+
+// Bytes per node of the arrays of a tree, which share one block holding the payloads and types in that order.
+static constexpr size_t ccNodeSize = sizeof(uint32_t) + sizeof(uint8_t);
+
+/*
+ * Change the node capacity of a tree.
+ * The payloads and types share one block, so that they are resized together: either both get the new capacity, or none does.
+ * The types are packed against the payloads before the block shrinks and spread once it has grown.
+ *
+ * Parameters:
+ * - pTree: A pointer to the tree.
+ * - capacity: The new capacity, at least the number of nodes. The arrays are freed if it is 0.
+ *
+ * Returns:
+ * - true on success.
+ * - false if memory allocation fails, in which case the tree is left untouched.
+ */
+static bool ccResizeTreeNodes(CcTree* const pTree, const size_t capacity)
+{
+	assert(pTree != nullptr);
+	assert(capacity >= pTree->count);
 
-			if(statementCount > 0)
+	const size_t oldCapacity = pTree->nodeCapacity;
+	const size_t count = pTree->count;
+	char* const block = (char*)pTree->payloads;
+
+	char* newBlock = nullptr;
+	if(capacity == 0)
+	{
+		ccFree(block, oldCapacity * ccNodeSize);
+	}
+	else
+	{
+		if(capacity < oldCapacity)
+		{
+			memmove(block + sizeof(uint32_t) * capacity, pTree->types, count);
+		}
+
+		newBlock = ccRealloc(block, oldCapacity * ccNodeSize, capacity * ccNodeSize);
+		if(!newBlock)
+		{
+			if(capacity < oldCapacity)
 			{
-				ccCommitChildren(pBuilder, statementCount);
+				memmove(pTree->types, block + sizeof(uint32_t) * capacity, count);
 			}
 
-			pBuilder->pTree->nodes[pBuilder->pTree->count].type = CC_NODE_FUNCTION;
-			pBuilder->pTree->nodes[pBuilder->pTree->count].function.name = pNameToken->string;
-			pBuilder->pTree->nodes[pBuilder->pTree->count].function.statementsStart = pBuilder->childCount - 1;
-			pBuilder->pTree->nodes[pBuilder->pTree->count].function.statementsCount = statementCount;
+			return false;
+		}
+
+		if(capacity > oldCapacity)
+		{
+			memmove(newBlock + sizeof(uint32_t) * capacity, newBlock + sizeof(uint32_t) * oldCapacity, count);
+		}
+	}
+
+	pTree->payloads = (uint32_t*)newBlock;
+	pTree->types = newBlock ? (uint8_t*)(newBlock + sizeof(uint32_t) * capacity) : nullptr;
+	pTree->nodeCapacity = capacity;
 
-			++pBuilder->pTree->count;
+	return true;
+}
 
-			pBuilder->tokens->count -= tokenCount + 1;
-			pBuilder->tokens->tokens = pToken + 1;
+/*
+ * Report the buffers of a built tree and shrink them to their content.
+ * Buffers are reported before shrinking, so that reports show how much growing reserved.
+ *
+ * Parameters:
+ * - pBuilder: A pointer to the tree builder, whose children are all committed.
+ */
+static void ccFinishTree(CcTreeBuilder* const pBuilder)
+{
+	CcTree* const pTree = pBuilder->pTree;
 
-			return true;
+	assert(pBuilder->lastIndex == pTree->childCapacity);
+
+	ccReportBuffer(CC_BUFFER_NODES, pTree->count, pTree->nodeCapacity);
+	ccReportBuffer(CC_BUFFER_CHILDREN, pBuilder->childCount, pTree->childCapacity);
+
+	// Reused storage is kept for the next parse.
+	if(pBuilder->keepStorage)
+	{
+		return;
+	}
+
+	// Arrays are still valid if they cannot shrink.
+	ccResizeTreeNodes(pTree, pTree->count);
+
+	void* arrays[] = {pTree->constants, pTree->binOps, pTree->functions, pTree->programs, pTree->children};
+	const size_t elementSizes[] = {sizeof(pTree->constants[0]), sizeof(pTree->binOps[0]), sizeof(pTree->functions[0]), sizeof(pTree->programs[0]), sizeof(pTree->children[0])};
+	const size_t counts[] = {pTree->constantCount, pTree->binOpCount, pTree->functionCount, pTree->programCount, pBuilder->childCount};
+	size_t* const pCapacities[] = {&pTree->constantCapacity, &pTree->binOpCapacity, &pTree->functionCapacity, &pTree->programCapacity, &pTree->childCapacity};
+	for(size_t arrayIndex = 0; arrayIndex < CC_LEN(arrays); ++arrayIndex)
+	{
+		if(ccResizeTreeArray(&arrays[arrayIndex], elementSizes[arrayIndex], *pCapacities[arrayIndex], counts[arrayIndex]))
+		{
+			*pCapacities[arrayIndex] = counts[arrayIndex];
 		}
+	}
 
-		++pToken;
+	pTree->constants = arrays[0];
+	pTree->binOps = arrays[1];
+	pTree->functions = arrays[2];
+	pTree->programs = arrays[3];
+	pTree->children = arrays[4];
+
+	pBuilder->lastIndex = pTree->childCapacity;
+}
+
+// Lowest number of entries an array of a tree grows to.
+static constexpr size_t ccMinimumTreeCapacity = 256;
+
+/*
+ * Get the capacity an array of a tree grows to.
+ * Arrays grow by half their capacity, which keeps the number of reallocations logarithmic with less room left unused than doubling.
+ *
+ * Parameters:
+ * - capacity: The capacity of the array.
+ * - count: The number of entries used.
+ * - reserveCount: The number of entries to make room for.
+ *
+ * Returns:
+ * The new capacity, or capacity if there is already room.
+ */
+static size_t ccGrowTreeCapacity(const size_t capacity, const size_t count, const size_t reserveCount)
+{
+	if(capacity - count >= reserveCount)
+	{
+		return capacity;
 	}
 
-	return false;
+	return CC_MAX(CC_MAX(capacity + capacity / 2, ccMinimumTreeCapacity), count + reserveCount);
 }
 
-bool ccParseProgram(CcTreeBuilder* const pBuilder)
+/*
+ * Make room in a tree for the nodes and children parsed from a number of tokens.
+ * Each token gives at most one node and one child, each constant at most one constant and one binary operator,
+ * and there is room for a function and a program.
+ * Nodes are referred to by index, so moving them does not invalidate the tree.
+ * Children stored at the end of the children buffer stay at its end.
+ *
+ * Parameters:
+ * - pBuilder: A pointer to the tree builder.
+ * - tokenCount: The number of tokens.
+ * - constantCount: The number of constant tokens among them.
+ *
+ * Returns:
+ * - true on success.
+ * - false if memory allocation fails or the tree would hold more than UINT32_MAX nodes.
+ */
+static bool ccReserveTree(CcTreeBuilder* const pBuilder, const size_t tokenCount, const size_t constantCount)
 {
-	assert(ccAssertBuilder(pBuilder));
+	CcTree* const pTree = pBuilder->pTree;
 
-	size_t childCount = 0;
-	while(pBuilder->tokens->count > 0)
+	// Node indices are 32-bit, there are no more children than nodes and the bound keeps capacities far from overflowing.
+	if(tokenCount >= UINT32_MAX - pTree->count)
 	{
-		if(!ccParseFunction(pBuilder))
+		return false;
+	}
+
+	const size_t nodeCapacity = ccGrowTreeCapacity(pTree->nodeCapacity, pTree->count, tokenCount + 1);
+	if(nodeCapacity != pTree->nodeCapacity)
+	{
+		if(!ccResizeTreeNodes(pTree, nodeCapacity))
 		{
 			return false;
 		}
+	}
 
-		ccStoreChild(pBuilder);
+	void* arrays[] = {pTree->constants, pTree->binOps, pTree->functions, pTree->programs};
+	const size_t elementSizes[] = {sizeof(pTree->constants[0]), sizeof(pTree->binOps[0]), sizeof(pTree->functions[0]), sizeof(pTree->programs[0])};
+	const size_t counts[] = {pTree->constantCount, pTree->binOpCount, pTree->functionCount, pTree->programCount};
+	const size_t reserveCounts[] = {constantCount, constantCount, 1, 1};
+	size_t* const pCapacities[] = {&pTree->constantCapacity, &pTree->binOpCapacity, &pTree->functionCapacity, &pTree->programCapacity};
+	bool resized = true;
+	for(size_t arrayIndex = 0; resized && arrayIndex < CC_LEN(arrays); ++arrayIndex)
+	{
+		const size_t capacity = ccGrowTreeCapacity(*pCapacities[arrayIndex], counts[arrayIndex], reserveCounts[arrayIndex]);
+		if(capacity == *pCapacities[arrayIndex])
+		{
+			continue;
+		}
 
-		++childCount;
+		resized = ccResizeTreeArray(&arrays[arrayIndex], elementSizes[arrayIndex], *pCapacities[arrayIndex], capacity);
+		if(resized)
+		{
+			*pCapacities[arrayIndex] = capacity;
+		}
 	}
 
-	if(childCount > 0)
+	pTree->constants = arrays[0];
+	pTree->binOps = arrays[1];
+	pTree->functions = arrays[2];
+	pTree->programs = arrays[3];
+
+	if(!resized)
 	{
-		ccCommitChildren(pBuilder, childCount);
+		return false;
 	}
 
-	pBuilder->pTree->nodes[pBuilder->pTree->count].type = CC_NODE_PROGRAM;
-	pBuilder->pTree->nodes[pBuilder->pTree->count].program.childrenStart = pBuilder->childCount - 1;
-	pBuilder->pTree->nodes[pBuilder->pTree->count].program.childrenCount = childCount;
+	if(pBuilder->lastIndex - pBuilder->childCount < tokenCount)
+	{
+		const size_t storedCount = pTree->childCapacity - pBuilder->lastIndex;
+		const size_t capacity = ccGrowTreeCapacity(pTree->childCapacity, pBuilder->childCount + storedCount, tokenCount);
+		uint32_t* const children = ccRealloc(pTree->children, pTree->childCapacity * sizeof(pTree->children[0]), capacity * sizeof(pTree->children[0]));
+		if(!children)
+		{
+			return false;
+		}
 
-	++pBuilder->pTree->count;
-	
-	return pBuilder->tokens->count == 0;
+		memmove(children + capacity - storedCount, children + pBuilder->lastIndex, storedCount * sizeof(children[0]));
+		pTree->children = children;
+		pTree->childCapacity = capacity;
+		pBuilder->lastIndex = capacity - storedCount;
+	}
+
+	return true;
+}
+
+/*
+ * Parse the top-level functions of the tokens of a tree builder, making room in the tree for each one before parsing it.
+ *
+ * Parameters:
+ * - pBuilder: A pointer to the tree builder, whose tokens have their brackets matched.
+ * - pChildCount: A pointer to the number of children stored, incremented for each function.
+ *
+ * Returns:
+ * - CC_SUCCESS if all the tokens are parsed.
+ * - CC_ERROR_INVALID_ARGUMENT if the tokens do not form functions.
+ * - CC_ERROR_OUT_OF_MEMORY if memory allocation fails.
+ */
+static CcResult ccParseFunctions(CcTreeBuilder* const pBuilder, size_t* const pChildCount)
+{
+	CcConstTokenList* const tokens = pBuilder->tokens;
+	while(tokens->count > 0)
+	{
+		// A function ends at the brace matching its first one, the tree only grows by what its tokens can give.
+		const uint8_t* const types = ccGetTokenTypes(tokens);
+		const uint8_t* const openBrace = memchr(types, CC_TOKEN_OPEN_BRACE, tokens->count);
+		size_t tokenCount = tokens->count;
+		if(openBrace)
+		{
+			const size_t closeIndex = ccGetTokenPartner(tokens, (size_t)(openBrace - types));
+			if(closeIndex != SIZE_MAX)
+			{
+				tokenCount = closeIndex + 1;
+			}
+		}
+
+		size_t constantCount = 0;
+		for(size_t tokenIndex = 0; tokenIndex < tokenCount; ++tokenIndex)
+		{
+			constantCount += types[tokenIndex] == CC_TOKEN_CONSTANT;
+		}
+
+		if(!ccReserveTree(pBuilder, tokenCount, constantCount))
+		{
+			return CC_ERROR_OUT_OF_MEMORY;
+		}
+
+		if(!ccParseFunction(pBuilder))
+		{
+			return CC_ERROR_INVALID_ARGUMENT;
+		}
+
+		ccStoreChild(pBuilder);
+
+		++*pChildCount;
+	}
+
+	return CC_SUCCESS;
 }
 
 CcResult ccParse(const CcConstTokenList* const tokens, CcTree* const pTree)
@@ -600,61 +1048,205 @@ CcResult ccParse(const CcConstTokenList* const tokens, CcTree* const pTree)
 	// Validate arguments.
 	assert(tokens != nullptr);
 	assert(tokens->count > 0);
-	assert(tokens->tokens != nullptr);
+	assert(tokens->pTokenList != nullptr);
 
 	assert(pTree != nullptr);
 
-	CcResult result = CC_SUCCESS;
+	// The storage of the tree is reused.
+	assert(pTree->count == 0 && pTree->constantCount == 0 && pTree->binOpCount == 0 && pTree->functionCount == 0 && pTree->programCount == 0);
 
-	pTree->nodes = nullptr;
-	pTree->children = nullptr;
+	// Unbalanced brackets are reported once, before parsing.
+	if(ccReportUnmatchedBracket(tokens))
+	{
+		return CC_ERROR_INVALID_ARGUMENT;
+	}
 
-	pTree->nodes = malloc((tokens->count + 1) * sizeof(pTree->nodes[0]));
-	if(!pTree->nodes)
+	// The tree grows as functions are parsed rather than from the number of tokens.
+	CcTreeBuilder builder = {.pTree = pTree, .tokens = &(CcConstTokenList){tokens->pTokenList, tokens->start, tokens->count}, .lastIndex = pTree->childCapacity, .keepStorage = pTree->nodeCapacity > 0};
+	size_t childCount = 0;
+	CcResult result = ccParseFunctions(&builder, &childCount);
+	if(result != CC_SUCCESS)
 	{
-		result = CC_ERROR_OUT_OF_MEMORY;
 		goto error;
 	}
 
-	pTree->children = malloc(tokens->count * sizeof(pTree->children[0]));
-	if(!pTree->children)
+	// Room for the program node.
+	if(!ccReserveTree(&builder, 1, 0))
 	{
 		result = CC_ERROR_OUT_OF_MEMORY;
 		goto error;
 	}
 
-	CcTreeBuilder builder = {.pTree = pTree, .tokens = &(CcConstTokenList){tokens->tokens, tokens->count}, .lastIndex = tokens->count};
-	if(!ccParseProgram(&builder))
+	ccAddProgram(&builder, childCount);
+	ccFinishTree(&builder);
+
+	goto end;
+
+	error:
+	if(builder.keepStorage)
 	{
-		result = CC_ERROR_INVALID_ARGUMENT;
-		goto error;
+		ccClearTree(pTree);
+	}
+	else
+	{
+		ccFreeTree(pTree);
+	}
+
+	end:
+	return result;
+}
+
+/*
+ * Release the tokens of a lexer and pull the ones up to the brace closing the body of the next function, with their brackets matched.
+ *
+ * Parameters:
+ * - pLexer: A pointer to the lexer, holding no tokens afterwards if it is finished.
+ *
+ * Returns:
+ * - CC_SUCCESS if the tokens are pulled.
+ * - CC_ERROR_INVALID_ARGUMENT if there are too many identifiers.
+ * - CC_ERROR_OUT_OF_MEMORY if memory allocation fails.
+ */
+static CcResult ccPullFunction(CcLexer* const pLexer)
+{
+	ccReleaseTokens(pLexer);
+	size_t braceCount = 0;
+	bool closed = false;
+	while(!closed)
+	{
+		const CcResult result = ccNextToken(pLexer);
+		if(result != CC_SUCCESS)
+		{
+			return result;
+		}
+		if(pLexer->finished)
+		{
+			break;
+		}
+
+		const CcTokenType type = pLexer->tokenList.types[pLexer->tokenList.count - 1];
+		if(type == CC_TOKEN_OPEN_BRACE)
+		{
+			++braceCount;
+		}
+		else if(type == CC_TOKEN_CLOSE_BRACE)
+		{
+			closed = braceCount <= 1;
+			braceCount -= braceCount > 0;
+		}
 	}
 
-	if(pTree->count == 0)
+	if(pLexer->tokenList.count > 0 && ccMatchBrackets(&pLexer->tokenList) != CC_SUCCESS)
 	{
-		CC_FREE(pTree->nodes);
+		return CC_ERROR_OUT_OF_MEMORY;
 	}
 
-	if(builder.childCount == 0)
+	return CC_SUCCESS;
+}
+
+CcResult ccParseLexer(CcLexer* const pLexer, CcTree* const pTree)
+{
+	// Validate arguments.
+	assert(pLexer != nullptr);
+	assert(pTree != nullptr);
+
+	CcResult result = CC_SUCCESS;
+
+	// The storage of the tree is reused.
+	assert(pTree->count == 0 && pTree->constantCount == 0 && pTree->binOpCount == 0 && pTree->functionCount == 0 && pTree->programCount == 0);
+
+	// Lexing diagnostics are written once parsing is over.
+	CcDiagnosticSink sink;
+	ccBeginDiagnostics(&sink);
+
+	CcConstTokenList tokens = {&pLexer->tokenList, 0, 0};
+	CcTreeBuilder builder = {.pTree = pTree, .tokens = &tokens, .lastIndex = pTree->childCapacity, .keepStorage = pTree->nodeCapacity > 0};
+	size_t childCount = 0;
+	// Lexing and parsing are measured apart, switching phases twice per function.
+	CcPhaseTimer timer;
+	ccBeginPhase(CC_PHASE_LEX, &timer);
+	while(true)
 	{
-		CC_FREE(pTree->children);
+		result = ccPullFunction(pLexer);
+		if(result != CC_SUCCESS)
+		{
+			ccEndPhase(&timer);
+			goto error;
+		}
+
+		const size_t tokenCount = pLexer->tokenList.count;
+		if(tokenCount == 0)
+		{
+			break;
+		}
+
+		ccSwitchPhase(CC_PHASE_PARSE, &timer);
+		tokens = (CcConstTokenList){&pLexer->tokenList, 0, tokenCount};
+		result = ccReportUnmatchedBracket(&tokens) ? CC_ERROR_INVALID_ARGUMENT : ccParseFunctions(&builder, &childCount);
+		if(result != CC_SUCCESS)
+		{
+			ccEndPhase(&timer);
+			goto error;
+		}
+		ccSwitchPhase(CC_PHASE_LEX, &timer);
+	}
+
+	// Room for the program node.
+	ccSwitchPhase(CC_PHASE_PARSE, &timer);
+	const bool reserved = ccReserveTree(&builder, 1, 0);
+	if(reserved)
+	{
+		ccAddProgram(&builder, childCount);
+		ccFinishTree(&builder);
+	}
+	ccEndPhase(&timer);
+	if(!reserved)
+	{
+		result = CC_ERROR_OUT_OF_MEMORY;
+		goto error;
 	}
 
 	goto end;
 
 	error:
-	CC_FREE(pTree->nodes);
-	CC_FREE(pTree->children);
+	if(builder.keepStorage)
+	{
+		ccClearTree(pTree);
+	}
+	else
+	{
+		ccFreeTree(pTree);
+	}
 
 	end:
+	ccReleaseTokens(pLexer);
+	ccEndDiagnostics(&sink);
+
 	return result;
 }
 
-void ccFreeTree(CcTree* const pTree)
+void ccClearTree(CcTree* const pTree)
 {
 	assert(pTree != nullptr);
 
-	CC_FREE(pTree->nodes);
-	CC_FREE(pTree->children);
 	pTree->count = 0;
+	pTree->constantCount = 0;
+	pTree->binOpCount = 0;
+	pTree->functionCount = 0;
+	pTree->programCount = 0;
+	ccClearSymbolTable(&pTree->symbols);
+}
+
+void ccFreeTree(CcTree* const pTree)
+{
+	assert(pTree != nullptr);
+
+	ccFree(pTree->payloads, pTree->nodeCapacity * ccNodeSize);
+	ccFree(pTree->constants, pTree->constantCapacity * sizeof(pTree->constants[0]));
+	ccFree(pTree->binOps, pTree->binOpCapacity * sizeof(pTree->binOps[0]));
+	ccFree(pTree->functions, pTree->functionCapacity * sizeof(pTree->functions[0]));
+	ccFree(pTree->programs, pTree->programCapacity * sizeof(pTree->programs[0]));
+	ccFree(pTree->children, pTree->childCapacity * sizeof(pTree->children[0]));
+	ccFreeSymbolTable(&pTree->symbols);
+	*pTree = (CcTree){};
 }
@@ -1,7 +1,21 @@
+// Needed for sockets and getcwd in the compile server test.
+#define _DEFAULT_SOURCE
+
 #include <assert.h>
+#include <ctype.h>
+#include <locale.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <threads.h>
+
+#ifndef _WIN32
+#include <errno.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
 
 #include "cece/cece.h"
 
@@ -30,6 +44,88 @@ static int ccCompareInts(const void* const pFirstVoid, const void* const pSecond
 	return (first > second) - (first < second);
 }
 
+/*
+ * Make a token list out of tokens, for the parser tests.
+ * The text of the tokens is copied to a buffer which becomes the source of the list.
+ *
+ * Returns:
+ * - true on success, the list is to be freed with ccFreeTokenList.
+ * - false otherwise.
+ */
+static bool ccMakeTokenList(const CcToken* const tokens, const size_t count, char* const text, const size_t textSize, CcTokenList* const pTokenList)
+{
+	*pTokenList = (CcTokenList){.source = text};
+
+	size_t offset = 0;
+	for(size_t tokenIndex = 0; tokenIndex < count; ++tokenIndex)
+	{
+		const CcStringView string = tokens[tokenIndex].string;
+		if(string.length > textSize - offset)
+		{
+			ccFreeTokenList(pTokenList);
+			return false;
+		}
+		if(string.length > 0)
+		{
+			memcpy(text + offset, string.string, string.length);
+		}
+
+		if(ccAppendToken(pTokenList, &tokens[tokenIndex], offset) != CC_SUCCESS)
+		{
+			ccFreeTokenList(pTokenList);
+			return false;
+		}
+		offset += string.length;
+	}
+
+	if(ccMatchBrackets(pTokenList) != CC_SUCCESS)
+	{
+		ccFreeTokenList(pTokenList);
+		return false;
+	}
+
+	return true;
+}
+
+/*
+ * Storage of a tree for the parser tests, which parse without making room in the tree first.
+ */
+typedef struct CcTestTree
+{
+	uint8_t types[64];
+	uint32_t payloads[64];
+	CcConstantNode constants[64];
+	CcBinOpNode binOps[64];
+	CcFunctionNode functions[8];
+	CcProgramNode programs[1];
+	uint32_t children[64];
+} CcTestTree;
+
+/*
+ * Make an empty tree over the storage of a test tree.
+ *
+ * Returns:
+ * The tree.
+ */
+static CcTree ccMakeTestTree(CcTestTree* const pStorage)
+{
+	return (CcTree){
+		.types = pStorage->types,
+		.payloads = pStorage->payloads,
+		.nodeCapacity = CC_LEN(pStorage->types),
+		.constants = pStorage->constants,
+		.constantCapacity = CC_LEN(pStorage->constants),
+		.binOps = pStorage->binOps,
+		.binOpCapacity = CC_LEN(pStorage->binOps),
+		.functions = pStorage->functions,
+		.functionCapacity = CC_LEN(pStorage->functions),
+		.programs = pStorage->programs,
+		.programCapacity = CC_LEN(pStorage->programs),
+		.children = pStorage->children,
+		.childCapacity = CC_LEN(pStorage->children)
+	};
+}
+
 static void ccTestFind(bool* const pPassed)
 {
 	assert(pPassed != nullptr);
@@ -68,6 +164,99 @@ static void ccTestFind(bool* const pPassed)
 	}
 }
 
+static void ccTestMemoryReport(bool* const pPassed)
+{
+	assert(pPassed != nullptr);
+
+	const CcMemoryStatistics before = *ccGetMemoryStatistics();
+
+	void* pointer = ccMalloc(100);
+	void* const newPointer = pointer ? ccRealloc(pointer, 100, 300) : nullptr;
+	if(!newPointer)
+	{
+		CC_FAIL("Failed to allocate memory.");
+		ccFree(pointer, 100);
+		return;
+	}
+	pointer = newPointer;
+	ccFree(pointer, 300);
+
+	const CcMemoryStatistics* const pAfter = ccGetMemoryStatistics();
+	if(
+		pAfter->allocationCount != before.allocationCount + 1 ||
+		pAfter->reallocationCount != before.reallocationCount + 1 ||
+		pAfter->requestedBytes != before.requestedBytes + 100 ||
+		pAfter->reallocatedBytes != before.reallocatedBytes + 300 ||
+		pAfter->liveBytes != before.liveBytes ||
+		pAfter->peakBytes < before.liveBytes + 300
+	)
+	{
+		CC_FAIL("Wrong memory statistics.");
+	}
+
+	CcReport report = {};
+	ccSetReport(&report);
+
+	CcPhaseTimer timer;
+	ccBeginPhase(CC_PHASE_PARSE, &timer);
+	pointer = ccMalloc(1000);
+	ccFree(pointer, 1000);
+	ccEndPhase(&timer);
+
+	ccReportBuffer(CC_BUFFER_NODES, 3, 4);
+
+	ccSetReport(nullptr);
+
+	const CcPhaseReport* const pPhase = &report.phases[CC_PHASE_PARSE];
+	if(pPhase->count != 1 || pPhase->allocationCount != 1 || pPhase->requestedBytes != 1000 || pPhase->peakBytes < 1000 || pPhase->wallTime < 0)
+	{
+		CC_FAIL("Wrong phase report.");
+	}
+
+	if(report.phases[CC_PHASE_LEX].count != 0 || report.buffers[CC_BUFFER_NODES].used != 3 || report.buffers[CC_BUFFER_NODES].reserved != 4)
+	{
+		CC_FAIL("Wrong report.");
+	}
+
+	// Reports of threads running at the same time add up their phases, but not their elapsed time.
+	CcReport total = {.elapsedTime = 0.25};
+	report.elapsedTime = 0.5;
+	report.phases[CC_PHASE_PARSE].wallTime = 0.375;
+	ccMergeReport(&total, &report);
+	ccMergeReport(&total, &report);
+	if(total.elapsedTime != 0.5 || total.phases[CC_PHASE_PARSE].wallTime != 0.75 || total.phases[CC_PHASE_PARSE].count != 2)
+	{
+		CC_FAIL("Wrong merged report.");
+	}
+
+	FILE* const file = tmpfile();
+	if(!file)
+	{
+		CC_FAIL("Failed to create a temporary file.");
+		return;
+	}
+
+	ccPrintTimeReport(&total, file);
+	rewind(file);
+	char line[128];
+	bool found = false;
+	while(fgets(line, sizeof(line), file))
+	{
+		size_t count;
+		double wallTime;
+		if(sscanf(line, "total %zu %lf", &count, &wallTime) == 2)
+		{
+			found = count == 2 && wallTime == 500.0;
+		}
+	}
+	fclose(file);
+
+	if(!found)
+	{
+		CC_FAIL("Wrong total time.");
+	}
+}
+
 static void ccTestArguments(bool* const pPassed)
 {
 	CcOptions options;
@@ -78,7 +267,7 @@ static void ccTestArguments(bool* const pPassed)
 		*pPassed = false;
 		return;
 	}
-	if(options.input || options.output)
+	if(options.inputs || options.outputs)
 	{
 		*pPassed = false;
 		return;
@@ -91,20 +280,19 @@ static void ccTestArguments(bool* const pPassed)
 		return;
 	}
 
-	if(!options.input || !options.output || options.debug || options.version != CC_C23)
+	if(options.inputCount != 1 || options.jobCount != 1 || options.debug || options.version != CC_C23)
 	{
 		*pPassed = false;
 		return;
 	}
 
-	if(strcmp(options.input, args2[0]) != 0 || strcmp(options.output, "test.s") != 0)
+	if(strcmp(options.inputs[0], args2[0]) != 0 || strcmp(options.outputs[0], "test.s") != 0)
 	{
 		*pPassed = false;
 		return;
 	}
 
-	free(options.input);
-	free(options.output);
+	ccFreeOptions(&options);
 
 	const char* const args3[] = {
 		"test.c",
@@ -118,350 +306,1736 @@ static void ccTestArguments(bool* const pPassed)
 		return;
 	}
 
-	if(strcmp(options.input, args3[0]) != 0 || strcmp(options.output, "output.s") != 0 || options.version != CC_C23)
+	if(strcmp(options.inputs[0], args3[0]) != 0 || strcmp(options.outputs[0], "output.s") != 0 || options.version != CC_C23)
 	{
 		*pPassed = false;
 	}
 
-	free(options.input);
-	free(options.output);
-}
+	ccFreeOptions(&options);
 
-static void ccTestStrings(bool* const pPassed)
-{
-	assert(pPassed != nullptr);
+	const char* const args4[] = {
+		"a.c",
+		"dir/b.c",
+		"-j",
+		"4",
+		"c"
+	};
+	if(ccParseArguments(CC_LEN(args4), args4, &options) != CC_SUCCESS)
+	{
+		*pPassed = false;
+		return;
+	}
 
-	const struct
+	if(options.inputCount != 3 || options.jobCount != 4)
 	{
-		const char* string;
-		bool isString;
-		size_t length;
-	} tests[] = {
-		{.string = "", .isString = false},
-		{.string = "abc", .isString = false},
-		{.string = "123", .isString = false},
-		{.string = "+=", .isString = false},
-		{.string = "\"string\"", .isString = true, .length = 8}
-	};
-	constexpr size_t testCount = CC_LEN(tests);
+		*pPassed = false;
+		ccFreeOptions(&options);
+		return;
+	}
 
-	for(size_t testIndex = 0; testIndex < testCount; ++testIndex)
+	if(strcmp(options.outputs[0], "a.s") != 0 || strcmp(options.outputs[1], "dir/b.s") != 0 || strcmp(options.outputs[2], "c.s") != 0)
 	{
-		CcToken token;
-		const bool result = ccParseString(tests[testIndex].string, &token);
+		*pPassed = false;
+	}
 
-		if(result != tests[testIndex].isString)
-		{
-			CC_FAIL("Test string #%zu does not match.", testIndex);
-			continue;
-		}
+	ccFreeOptions(&options);
 
-		if(!result)
-		{
-			continue;
-		}
+	const char* const args5[] = {"a.c", "-j8"};
+	if(ccParseArguments(CC_LEN(args5), args5, &options) != CC_SUCCESS)
+	{
+		*pPassed = false;
+		return;
+	}
 
-		if(token.string.string != tests[testIndex].string)
-		{
-			CC_FAIL("Test string #%zu wrong string.", testIndex);
-		}
+	if(options.jobCount != 8)
+	{
+		*pPassed = false;
+	}
 
-		if(token.string.length != tests[testIndex].length)
-		{
-			CC_FAIL("Test string #%zu wrong length.", testIndex);
-		}
+	ccFreeOptions(&options);
+
+	const char* const args6[] = {"a.c", "b.c", "-o", "output.s"};
+	if(ccParseArguments(CC_LEN(args6), args6, &options) != CC_ERROR_INVALID_ARGUMENT)
+	{
+		*pPassed = false;
+		return;
 	}
-}
 
-static void ccTestCharacters(bool* const pPassed)
-{
-	assert(pPassed != nullptr);
+	const char* const args7[] = {"a.c", "-j0"};
+	if(ccParseArguments(CC_LEN(args7), args7, &options) != CC_ERROR_INVALID_ARGUMENT)
+	{
+		*pPassed = false;
+		return;
+	}
 
-	const struct
+	const char* const args8[] = {"a.c", "-ftime-report-json=report.json"};
+	if(ccParseArguments(CC_LEN(args8), args8, &options) != CC_SUCCESS)
 	{
-		const char* string;
-		bool isCharacter;
-		int value;
-		size_t length;
-	} tests[] = {
-		{.string = "", .isCharacter = false},
-		{.string = "abc", .isCharacter = false},
-		{.string = "123", .isCharacter = false},
-		{.string = "+=", .isCharacter = false},
-		{.string = "\"string\"", .isCharacter = false},
-		{.string = "'c'", .isCharacter = true, .value = 'c', .length = 3},
-		{.string = "'\\''", .isCharacter = true, .value = '\'', .length = 4},
-	};
-	constexpr size_t testCount = CC_LEN(tests);
+		*pPassed = false;
+		return;
+	}
 
-	for(size_t testIndex = 0; testIndex < testCount; ++testIndex)
+	if(!options.timeReport || strcmp(options.timeReportPath, "report.json") != 0)
 	{
-		CcToken token;
-		const bool result = ccParseCharacter(tests[testIndex].string, &token);
+		*pPassed = false;
+	}
 
-		if(result != tests[testIndex].isCharacter)
-		{
-			CC_FAIL("Test character #%zu does not match.", testIndex);
-			continue;
-		}
+	ccFreeOptions(&options);
 
-		if(!result)
-		{
-			continue;
-		}
+	const char* const args9[] = {"a.c", "-fbracket-depth=512"};
+	if(ccParseArguments(CC_LEN(args9), args9, &options) != CC_SUCCESS)
+	{
+		*pPassed = false;
+		return;
+	}
 
-		if(token.string.string != tests[testIndex].string)
-		{
-			CC_FAIL("Test character #%zu wrong string.", testIndex);
-		}
+	if(options.nestingLimit != 512)
+	{
+		*pPassed = false;
+	}
 
-		if(token.string.length != tests[testIndex].length)
-		{
-			CC_FAIL("Test character #%zu wrong length.", testIndex);
-		}
+	ccFreeOptions(&options);
 
-		if(!ccCompareConstants(token.constant, (CcConstant){CC_CONSTANT_INT, tests[testIndex].value}))
-		{
-			CC_FAIL("Test character #%zu wrong constant.", testIndex);
-		}
+	const char* const args10[] = {"a.c", "-fbracket-depth=0"};
+	if(ccParseArguments(CC_LEN(args10), args10, &options) != CC_ERROR_INVALID_ARGUMENT)
+	{
+		*pPassed = false;
+		return;
+	}
+
+	const char* const args11[] = {"a.c", "-fmax-diagnostics=20"};
+	if(ccParseArguments(CC_LEN(args11), args11, &options) != CC_SUCCESS)
+	{
+		*pPassed = false;
+		return;
+	}
+
+	if(options.diagnosticLimit != 20)
+	{
+		*pPassed = false;
+	}
+
+	ccFreeOptions(&options);
+
+	const char* const args12[] = {"a.c", "-fmax-diagnostics=x"};
+	if(ccParseArguments(CC_LEN(args12), args12, &options) != CC_ERROR_INVALID_ARGUMENT)
+	{
+		*pPassed = false;
+		return;
 	}
 }
 
-static void ccTestTokens(bool* const pPassed)
+static void ccTestLoadFile(bool* const pPassed)
 {
 	assert(pPassed != nullptr);
 
-	const struct
-	{
-		const char* string;
-		bool isToken;
-		CcTokenType type;
-		size_t length;
-	} tests[] = {
-		{.string = "", .isToken = false},
-		{.string = "+=", .isToken = true, .type = CC_TOKEN_PLUS_EQUAL, .length = 2},
-		{.string = "+++", .isToken = true, .type = CC_TOKEN_PLUS_PLUS, .length = 2},
-		{.string = "+-", .isToken = true, .type = CC_TOKEN_PLUS, .length = 1},
-		{.string = "[{()}]", .isToken = true, .type = CC_TOKEN_OPEN_BRACKET, .length = 1},
-		{.string = "abc", .isToken = false},
-		{.string = "123", .isToken = false},
-		{.string = "\"string\"", .isToken = false},
-		{.string = "'c'", .isToken = false}
-	};
-	constexpr size_t testCount = CC_LEN(tests);
+	// Cover files ending inside a page and exactly on a page boundary.
+	constexpr size_t sizes[] = {0, 1, 100, 4096, 8192, 65536};
+	constexpr size_t sizeCount = CC_LEN(sizes);
 
-	for(size_t testIndex = 0; testIndex < testCount; ++testIndex)
-	{
-		CcToken token;
-		const bool result = ccParseToken(tests[testIndex].string, &token);
+	constexpr char path[] = "cece_test_load.c";
 
-		if(result != tests[testIndex].isToken)
+	for(size_t sizeIndex = 0; sizeIndex < sizeCount; ++sizeIndex)
+	{
+		FILE* const file = fopen(path, "w");
+		if(!file)
 		{
-			CC_FAIL("Test token #%zu does not match.", testIndex);
+			CC_FAIL("Load file #%zu: could not create file.", sizeIndex);
 			continue;
 		}
+		for(size_t characterIndex = 0; characterIndex < sizes[sizeIndex]; ++characterIndex)
+		{
+			fputc('a' + (int)(characterIndex % 26), file);
+		}
+		fclose(file);
 
-		if(!result)
+		CcSourceFile source;
+		if(ccLoadFile(path, &source) != CC_SUCCESS)
 		{
+			CC_FAIL("Load file #%zu: failed.", sizeIndex);
 			continue;
 		}
 
-		if(token.type != tests[testIndex].type)
+		if(source.string.length != sizes[sizeIndex] || source.string.string[source.string.length] != '\0')
 		{
-			CC_FAIL("Test token #%zu wrong type.", testIndex);
+			CC_FAIL("Load file #%zu: wrong length.", sizeIndex);
+		}
+		else
+		{
+			for(size_t characterIndex = 0; characterIndex < sizes[sizeIndex]; ++characterIndex)
+			{
+				if(source.string.string[characterIndex] != 'a' + (int)(characterIndex % 26))
+				{
+					CC_FAIL("Load file #%zu: wrong character #%zu.", sizeIndex, characterIndex);
+					break;
+				}
+			}
 		}
 
-		if(token.string.length != tests[testIndex].length)
+		ccUnloadFile(&source);
+		if(source.buffer || source.mapping)
 		{
-			CC_FAIL("Test token #%zu wrong length.", testIndex);
+			CC_FAIL("Load file #%zu: not released.", sizeIndex);
 		}
 	}
+
+	remove(path);
+
+	CcSourceFile source;
+	if(ccLoadFile("cece_test_missing.c", &source) != CC_ERROR_FILE_NOT_FOUND)
+	{
+		CC_FAIL("Load file: missing file was loaded.");
+		ccUnloadFile(&source);
+	}
 }
 
-static void ccTestConstants(bool* const pPassed)
+static void ccRemoveCacheEntries(const char* const directory, const CcCacheKey* const pKey)
+{
+	char path[256];
+
+	snprintf(path, sizeof(path), "%s/%016llx%016llx.s", directory, (unsigned long long)pKey->hashes[0], (unsigned long long)pKey->hashes[1]);
+	remove(path);
+
+	snprintf(path, sizeof(path), "%s/%016llx%016llx.ok", directory, (unsigned long long)pKey->hashes[0], (unsigned long long)pKey->hashes[1]);
+	remove(path);
+}
+
+static void ccTestCache(bool* const pPassed)
 {
 	assert(pPassed != nullptr);
 
-	const struct
+	constexpr char directory[] = "cece_test_cache";
+	constexpr char output[] = "cece_test_cache_output.s";
+	constexpr char restored[] = "cece_test_cache_restored.s";
+	constexpr char contents[] = "ret\n";
+
+	const CcOptions options = {.version = CC_C23};
+	const CcConstString source = {.string = "int main(void){return 0;}", .length = 25};
+	const CcConstString otherSource = {.string = "int main(void){return 1;}", .length = 25};
+
+	const CcCacheKey key = ccCacheKey(source, &options);
+	const CcCacheKey otherKey = ccCacheKey(otherSource, &options);
+	const CcCacheKey versionKey = ccCacheKey(source, &(const CcOptions){.version = CC_C17});
+	if(memcmp(&key, &otherKey, sizeof(key)) == 0 || memcmp(&key, &versionKey, sizeof(key)) == 0)
 	{
-		const char* string;
-		bool isConstant;
-		CcConstant constant;
-		size_t length;
-	} tests[] = {
-		{.string = "", .isConstant = false},
-		{.string = "abc", .isConstant = false},
-		{.string = "[]", .isConstant = false},
+		CC_FAIL("Cache: keys do not depend on the source and options.");
+	}
+
+	ccRemoveCacheEntries(directory, &key);
+	ccRemoveCacheEntries(directory, &otherKey);
+
+	FILE* file = fopen(output, "wb");
+	if(!file)
+	{
+		CC_FAIL("Cache: could not create output.");
+		return;
+	}
+	fputs(contents, file);
+	fclose(file);
+
+	if(ccCacheRestore(directory, &key, restored))
+	{
+		CC_FAIL("Cache: unexpected hit.");
+	}
+
+	if(!ccCacheStore(directory, &key, output) || !ccCacheStore(directory, &otherKey, nullptr))
+	{
+		CC_FAIL("Cache: store failed.");
+	}
+
+	if(!ccCacheRestore(directory, &key, restored))
+	{
+		CC_FAIL("Cache: unexpected miss.");
+	}
+	else
+	{
+		char buffer[16] = {};
+		file = fopen(restored, "rb");
+		if(!file || fread(buffer, 1, sizeof(buffer) - 1, file) != strlen(contents) || strcmp(buffer, contents) != 0)
+		{
+			CC_FAIL("Cache: wrong restored output.");
+		}
+		if(file)
+		{
+			fclose(file);
+		}
+	}
+
+	if(!ccCacheRestore(directory, &otherKey, restored) || ccCacheRestore(directory, &versionKey, restored))
+	{
+		CC_FAIL("Cache: wrong lookup.");
+	}
+
+	ccRemoveCacheEntries(directory, &key);
+	ccRemoveCacheEntries(directory, &otherKey);
+	remove(directory);
+
+	remove(output);
+	remove(restored);
+}
+
+#ifndef _WIN32
+static int ccRunTestServer(void* const pPathVoid)
+{
+	return (int)ccRunServer(pPathVoid, 2);
+}
+
+/*
+ * Connect to a compile server, waiting for it to listen.
+ *
+ * Parameters:
+ * - path: The path of the socket of the server.
+ *
+ * Returns:
+ * The connected socket, or -1 if the server does not listen after a few seconds.
+ */
+static int ccConnectTestServer(const char* const path)
+{
+	struct sockaddr_un address = {.sun_family = AF_UNIX};
+	memcpy(address.sun_path, path, strlen(path) + 1);
+
+	for(size_t attemptIndex = 0; attemptIndex < 500; ++attemptIndex)
+	{
+		const int descriptor = socket(AF_UNIX, SOCK_STREAM, 0);
+		if(descriptor == -1)
+		{
+			return -1;
+		}
+
+		if(connect(descriptor, (const struct sockaddr*)&address, sizeof(address)) == 0)
+		{
+			return descriptor;
+		}
+		close(descriptor);
+
+		thrd_sleep(&(const struct timespec){.tv_nsec = 10000000}, nullptr);
+	}
+
+	return -1;
+}
+
+static void ccTestServer(bool* const pPassed)
+{
+	assert(pPassed != nullptr);
+
+	constexpr char socketPath[] = "cece_test_server.sock";
+	constexpr char sourcePath[] = "cece_test_server.c";
+
+	char expected[4096];
+	char diagnostics[4096] = {};
+	if(!getcwd(expected, sizeof(expected) - 64))
+	{
+		CC_FAIL("Server: could not get current directory.");
+		return;
+	}
+	strcat(expected, "/cece_test_server.c:1:25: Unexpected token.\n");
+
+	FILE* const source = fopen(sourcePath, "w");
+	if(!source)
+	{
+		CC_FAIL("Server: could not create source.");
+		return;
+	}
+	fputs("int main(void){return 1 @;}\n", source);
+	fclose(source);
+
+	// The server leaves the signal dispositions of the process as it found them.
+	struct sigaction previousPipe;
+	sigaction(SIGPIPE, nullptr, &previousPipe);
+
+	FILE* const file = tmpfile();
+	thrd_t thread;
+	if(!file || thrd_create(&thread, ccRunTestServer, (void*)socketPath) != thrd_success)
+	{
+		CC_FAIL("Server: could not start.");
+		if(file)
+		{
+			fclose(file);
+		}
+		remove(sourcePath);
+		return;
+	}
+
+	// A client sending nothing holds one of the two workers, the request is served by the other.
+	const int silent = ccConnectTestServer(socketPath);
+	if(silent == -1)
+	{
+		CC_FAIL("Server: not listening.");
+	}
+
+	// The relative path of the source is resolved from the directory of the client.
+	ccSetDiagnosticFile(file);
+	const CcResult result = ccRunClient(socketPath, 1, (const char* const[]){sourcePath});
+	ccSetDiagnosticFile(nullptr);
+
+	const long size = ftell(file);
+	rewind(file);
+	if(
+		result != CC_SUCCESS || size < 0 || (size_t)size >= sizeof(diagnostics) ||
+		fread(diagnostics, 1, (size_t)size, file) != (size_t)size || strcmp(diagnostics, expected) != 0
+	)
+	{
+		CC_FAIL("Server: wrong response.");
+	}
+
+	// Serving clients one at a time, the request would only be served once the silent client is dropped.
+	if(silent != -1)
+	{
+		char byte;
+		if(recv(silent, &byte, 1, MSG_DONTWAIT) != -1 || (errno != EAGAIN && errno != EWOULDBLOCK))
+		{
+			CC_FAIL("Server: clients not served concurrently.");
+		}
+		close(silent);
+	}
+
+	ccStopServer();
+	int serverResult;
+	thrd_join(thread, &serverResult);
+	if(serverResult != CC_SUCCESS)
+	{
+		CC_FAIL("Server: failed.");
+	}
+
+	struct sigaction currentPipe;
+	sigaction(SIGPIPE, nullptr, &currentPipe);
+	if(currentPipe.sa_handler != previousPipe.sa_handler)
+	{
+		CC_FAIL("Server: SIGPIPE disposition changed.");
+	}
+
+	// Once the server is stopped, failing to reach it is diagnosed on the diagnostic stream of the client.
+	FILE* const unreachable = tmpfile();
+	if(unreachable)
+	{
+		ccSetDiagnosticFile(unreachable);
+		const CcResult unreachableResult = ccRunClient(socketPath, 1, (const char* const[]){sourcePath});
+		ccSetDiagnosticFile(nullptr);
+
+		char line[128] = {};
+		rewind(unreachable);
+		if(
+			unreachableResult != CC_ERROR_FILE_NOT_FOUND || !fgets(line, sizeof(line), unreachable) ||
+			strcmp(line, "Failed to connect to server \"cece_test_server.sock\".\n") != 0
+		)
+		{
+			CC_FAIL("Server: unreachable server not diagnosed.");
+		}
+		fclose(unreachable);
+	}
+
+	fclose(file);
+	remove(sourcePath);
+}
+#endif
+
+static void ccTestScan(bool* const pPassed)
+{
+	assert(pPassed != nullptr);
+
+	// Characters on both sides of each range the kernels compare against.
+	static const char alphabet[] = " \t\n\v\f\r\b\x0E/09:@AZ[`az{_+\x80\xFF";
+	constexpr size_t alphabetLength = sizeof(alphabet) - 1;
+
+	// Runs of a single class make the kernels go through several blocks.
+	constexpr size_t size = 512;
+	alignas(64) char buffer[size + 1];
+	unsigned int random = 1;
+	for(size_t characterIndex = 0; characterIndex < size;)
+	{
+		random = random * 1103515245 + 12345;
+		const char character = alphabet[(random >> 16) % alphabetLength];
+		const size_t runLength = CC_MIN((random >> 8) % 80 + 1, size - characterIndex);
+		for(size_t runIndex = 0; runIndex < runLength; ++runIndex)
+		{
+			random = random * 1103515245 + 12345;
+			buffer[characterIndex + runIndex] = (random >> 16) % 4 == 0 ? alphabet[(random >> 20) % alphabetLength] : character;
+		}
+		characterIndex += runLength;
+	}
+	buffer[size] = '\0';
+
+	CcScanKernels reference;
+	if(!ccGetScanKernels(CC_SCAN_LEVEL_SCALAR, &reference))
+	{
+		CC_FAIL("Scalar kernels unavailable.");
+		return;
+	}
+
+	for(size_t level = 0; level < CC_SCAN_LEVEL_COUNT; ++level)
+	{
+		CcScanKernels kernels;
+		if(!ccGetScanKernels(level, &kernels))
+		{
+			continue;
+		}
+
+		for(size_t start = 0; start < size; ++start)
+		{
+			if(kernels.scanSpaces(buffer + start) != reference.scanSpaces(buffer + start))
+			{
+				CC_FAIL("Scan level %zu: wrong spaces at %zu.", level, start);
+				break;
+			}
+
+			if(kernels.scanIdentifier(buffer + start) != reference.scanIdentifier(buffer + start))
+			{
+				CC_FAIL("Scan level %zu: wrong identifier at %zu.", level, start);
+				break;
+			}
+		}
+	}
+
+	if(ccScanSpaces(" \t\r\nx") != 4 || ccScanIdentifier("a_Z09+") != 5 || ccScanSpaces("") != 0 || ccScanIdentifier("") != 0)
+	{
+		CC_FAIL("Wrong scan.");
+	}
+}
+
+static void ccTestCharacterClasses(bool* const pPassed)
+{
+	assert(pPassed != nullptr);
+
+	// Tests run in the C locale, whose classes the table holds.
+	for(int character = 0; character <= UCHAR_MAX; ++character)
+	{
+		const unsigned short classes = ccCharacterClasses[character];
+
+		if(
+			!(classes & CC_CHARACTER_SPACE) != !isspace(character) ||
+			!(classes & CC_CHARACTER_PRINTABLE) != !isprint(character) ||
+			!(classes & CC_CHARACTER_LETTER) != !isalpha(character) ||
+			!(classes & CC_CHARACTER_IDENTIFIER_START) != !(isalpha(character) || character == '_') ||
+			!(classes & CC_CHARACTER_IDENTIFIER) != !(isalnum(character) || character == '_') ||
+			!(classes & CC_CHARACTER_BINARY_DIGIT) != !(character == '0' || character == '1') ||
+			!(classes & CC_CHARACTER_OCTAL_DIGIT) != !(character >= '0' && character <= '7') ||
+			!(classes & CC_CHARACTER_DECIMAL_DIGIT) != !isdigit(character) ||
+			!(classes & CC_CHARACTER_HEXADECIMAL_DIGIT) != !isxdigit(character)
+		)
+		{
+			CC_FAIL("Wrong classes of character %d.", character);
+		}
+
+		if(isxdigit(character) && ccDigitValues[character] != strtol((const char[]){(char)character, '\0'}, nullptr, 16))
+		{
+			CC_FAIL("Wrong value of digit %c.", character);
+		}
+	}
+
+	// Letters of single-byte locales stay invalid tokens, whose diagnostics are discarded.
+	static const char source[] = "caf\xE9 = 0x1F\xE0;";
+
+	FILE* const diagnosticFile = tmpfile();
+	ccSetDiagnosticFile(diagnosticFile);
+
+	CcTokenList expected;
+	if(ccLex((CcConstString){source, sizeof(source) - 1}, CC_C23, &expected) != CC_SUCCESS)
+	{
+		CC_FAIL("Lex failed.");
+		goto end;
+	}
+
+	static const char* const locales[] = {"en_US.ISO-8859-1", "fr_FR.ISO-8859-1", "de_DE.ISO-8859-1", "en_US.UTF-8", "C.UTF-8"};
+	for(size_t localeIndex = 0; localeIndex < CC_LEN(locales); ++localeIndex)
+	{
+		if(!setlocale(LC_CTYPE, locales[localeIndex]))
+		{
+			continue;
+		}
+
+		CcTokenList tokenList;
+		if(ccLex((CcConstString){source, sizeof(source) - 1}, CC_C23, &tokenList) != CC_SUCCESS)
+		{
+			CC_FAIL("Lex failed in locale %s.", locales[localeIndex]);
+			continue;
+		}
+
+		if(tokenList.count != expected.count)
+		{
+			CC_FAIL("Wrong token count in locale %s.", locales[localeIndex]);
+		}
+		else
+		{
+			for(size_t tokenIndex = 0; tokenIndex < tokenList.count; ++tokenIndex)
+			{
+				if(
+					tokenList.types[tokenIndex] != expected.types[tokenIndex] ||
+					tokenList.lengths[tokenIndex] != expected.lengths[tokenIndex]
+				)
+				{
+					CC_FAIL("Wrong #%zu token in locale %s.", tokenIndex, locales[localeIndex]);
+				}
+			}
+		}
+
+		ccFreeTokenList(&tokenList);
+	}
+	setlocale(LC_CTYPE, "C");
+
+	ccFreeTokenList(&expected);
+
+	end:
+	ccSetDiagnosticFile(nullptr);
+	if(diagnosticFile)
+	{
+		fclose(diagnosticFile);
+	}
+}
+
+static void ccTestStrings(bool* const pPassed)
+{
+	assert(pPassed != nullptr);
+
+	const struct
+	{
+		const char* string;
+		bool isString;
+		size_t length;
+	} tests[] = {
+		{.string = "", .isString = false},
+		{.string = "abc", .isString = false},
+		{.string = "123", .isString = false},
+		{.string = "+=", .isString = false},
+		{.string = "\"string\"", .isString = true, .length = 8}
+	};
+	constexpr size_t testCount = CC_LEN(tests);
+
+	for(size_t testIndex = 0; testIndex < testCount; ++testIndex)
+	{
+		CcToken token;
+		const bool result = ccParseString(tests[testIndex].string, &token);
+
+		if(result != tests[testIndex].isString)
+		{
+			CC_FAIL("Test string #%zu does not match.", testIndex);
+			continue;
+		}
+
+		if(!result)
+		{
+			continue;
+		}
+
+		if(token.string.string != tests[testIndex].string)
+		{
+			CC_FAIL("Test string #%zu wrong string.", testIndex);
+		}
+
+		if(token.string.length != tests[testIndex].length)
+		{
+			CC_FAIL("Test string #%zu wrong length.", testIndex);
+		}
+	}
+}
+
+static void ccTestCharacters(bool* const pPassed)
+{
+	assert(pPassed != nullptr);
+
+	const struct
+	{
+		const char* string;
+		bool isCharacter;
+		int value;
+		size_t length;
+	} tests[] = {
+		{.string = "", .isCharacter = false},
+		{.string = "abc", .isCharacter = false},
+		{.string = "123", .isCharacter = false},
+		{.string = "+=", .isCharacter = false},
+		{.string = "\"string\"", .isCharacter = false},
+		{.string = "'c'", .isCharacter = true, .value = 'c', .length = 3},
+		{.string = "'\\''", .isCharacter = true, .value = '\'', .length = 4},
+	};
+	constexpr size_t testCount = CC_LEN(tests);
+
+	for(size_t testIndex = 0; testIndex < testCount; ++testIndex)
+	{
+		CcToken token;
+		const bool result = ccParseCharacter(tests[testIndex].string, &token);
+
+		if(result != tests[testIndex].isCharacter)
+		{
+			CC_FAIL("Test character #%zu does not match.", testIndex);
+			continue;
+		}
+
+		if(!result)
+		{
+			continue;
+		}
+
+		if(token.string.string != tests[testIndex].string)
+		{
+			CC_FAIL("Test character #%zu wrong string.", testIndex);
+		}
+
+		if(token.string.length != tests[testIndex].length)
+		{
+			CC_FAIL("Test character #%zu wrong length.", testIndex);
+		}
+
+		if(!ccCompareConstants(token.constant, (CcConstant){CC_CONSTANT_INT, tests[testIndex].value}))
+		{
+			CC_FAIL("Test character #%zu wrong constant.", testIndex);
+		}
+	}
+}
+
+static void ccTestTokens(bool* const pPassed)
+{
+	assert(pPassed != nullptr);
+
+	const struct
+	{
+		const char* string;
+		bool isToken;
+		CcTokenType type;
+		size_t length;
+	} tests[] = {
+		{.string = "", .isToken = false},
+		{.string = "+=", .isToken = true, .type = CC_TOKEN_PLUS_EQUAL, .length = 2},
+		{.string = "+++", .isToken = true, .type = CC_TOKEN_PLUS_PLUS, .length = 2},
+		{.string = "+-", .isToken = true, .type = CC_TOKEN_PLUS, .length = 1},
+		{.string = "[{()}]", .isToken = true, .type = CC_TOKEN_OPEN_BRACKET, .length = 1},
+		{.string = "<<=", .isToken = true, .type = CC_TOKEN_LEFT_SHIFT_EQUAL, .length = 3},
+		{.string = "<<", .isToken = true, .type = CC_TOKEN_LEFT_SHIFT, .length = 2},
+		{.string = "<", .isToken = true, .type = CC_TOKEN_LESS, .length = 1},
+		{.string = ">>a", .isToken = true, .type = CC_TOKEN_RIGHT_SHIFT, .length = 2},
+		{.string = "->x", .isToken = true, .type = CC_TOKEN_ARROW, .length = 2},
+		{.string = "&&&", .isToken = true, .type = CC_TOKEN_AMPERSAND_AMPERSAND, .length = 2},
+		{.string = "!=", .isToken = true, .type = CC_TOKEN_NOT_EQUAL, .length = 2},
+		{.string = ":", .isToken = true, .type = CC_TOKEN_COLON, .length = 1},
+		{.string = "@", .isToken = false},
+		{.string = "\x80", .isToken = false},
+		{.string = "abc", .isToken = false},
+		{.string = "123", .isToken = false},
+		{.string = "\"string\"", .isToken = false},
+		{.string = "'c'", .isToken = false}
+	};
+	constexpr size_t testCount = CC_LEN(tests);
+
+	for(size_t testIndex = 0; testIndex < testCount; ++testIndex)
+	{
+		CcToken token;
+		const bool result = ccParseToken(tests[testIndex].string, &token);
+
+		if(result != tests[testIndex].isToken)
+		{
+			CC_FAIL("Test token #%zu does not match.", testIndex);
+			continue;
+		}
+
+		if(!result)
+		{
+			continue;
+		}
+
+		if(token.type != tests[testIndex].type)
+		{
+			CC_FAIL("Test token #%zu wrong type.", testIndex);
+		}
+
+		if(token.string.length != tests[testIndex].length)
+		{
+			CC_FAIL("Test token #%zu wrong length.", testIndex);
+		}
+	}
+}
+
+static void ccTestConstants(bool* const pPassed)
+{
+	assert(pPassed != nullptr);
+
+	const struct
+	{
+		const char* string;
+		bool isConstant;
+		CcConstant constant;
+		size_t length;
+	} tests[] = {
+		{.string = "", .isConstant = false},
+		{.string = "abc", .isConstant = false},
+		{.string = "[]", .isConstant = false},
 		{.string = "57", .isConstant = true, .constant = {.type = CC_CONSTANT_INT, .value = 57}, .length = 2},
 		{.string = "57llu", .isConstant = true, .constant = {.type = CC_CONSTANT_UNSIGNED_LONG_LONG, .value = 57}, .length = 5},
 		{.string = "0x42L", .isConstant = true, .constant = {.type = CC_CONSTANT_LONG, .value = 0x42}, .length = 5},
 		{.string = "2147483648", .isConstant = true, .constant = {.type = CC_CONSTANT_LONG_LONG, .value = (long long)INT_MAX + 1}, .length = 10},
 		{.string = "0 a", .isConstant = true, .constant = {.type = CC_CONSTANT_INT, .value = 0}, .length = 1},
+		{.string = "123456789", .isConstant = true, .constant = {.type = CC_CONSTANT_INT, .value = 123456789}, .length = 9},
+		{.string = "0xFFFFFFFF", .isConstant = true, .constant = {.type = CC_CONSTANT_UNSIGNED_INT, .value = 0xFFFFFFFF}, .length = 10},
+		{.string = "0xaBcDeF0123456789", .isConstant = true, .constant = {.type = CC_CONSTANT_UNSIGNED_LONG_LONG, .value = 0xABCDEF0123456789}, .length = 18},
+		{.string = "0b11111111111111111111111111111111", .isConstant = true, .constant = {.type = CC_CONSTANT_UNSIGNED_INT, .value = 0xFFFFFFFF}, .length = 34},
+		{.string = "0777777777777777777777", .isConstant = true, .constant = {.type = LONG_MAX == LLONG_MAX ? CC_CONSTANT_LONG : CC_CONSTANT_LONG_LONG, .value = LLONG_MAX}, .length = 22},
+		{.string = "4294967295u", .isConstant = true, .constant = {.type = CC_CONSTANT_UNSIGNED_INT, .value = 4294967295}, .length = 11},
+		{.string = "18446744073709551615u", .isConstant = true, .constant = {.type = ULONG_MAX == ULLONG_MAX ? CC_CONSTANT_UNSIGNED_LONG : CC_CONSTANT_UNSIGNED_LONG_LONG, .value = ULLONG_MAX}, .length = 21},
+		{.string = "000000000000000000000000000042", .isConstant = true, .constant = {.type = CC_CONSTANT_INT, .value = 042}, .length = 30},
 		{.string = " 1", .isConstant = false}
 	};
-	const size_t testCount = CC_LEN(tests);
+	const size_t testCount = CC_LEN(tests);
+
+	for(size_t testIndex = 0; testIndex < testCount; ++testIndex)
+	{
+		CcToken token;
+		const bool result = ccParseConstant(tests[testIndex].string, &token);
+
+		if(result != tests[testIndex].isConstant)
+		{
+			CC_FAIL("Test constant #%zu does not match.", testIndex);
+			continue;
+		}
+
+		if(!result)
+		{
+			continue;
+		}
+
+		if(token.string.string != tests[testIndex].string)
+		{
+			CC_FAIL("Test constant #%zu wrong string.", testIndex);
+			continue;
+		}
+
+		if(token.string.length != tests[testIndex].length)
+		{
+			CC_FAIL("Test constant #%zu wrong length.", testIndex);
+			continue;
+		}
+
+		if(!ccCompareConstants(token.constant, tests[testIndex].constant))
+		{
+			CC_FAIL("Test constant #%zu wrong constant.", testIndex);
+		}
+	}
+}
+
+static void ccTestIdentifiers(bool* const pPassed)
+{
+	assert(pPassed != nullptr);
+
+	const struct
+	{
+		const char* string;
+		CcVersion version;
+		bool isIdentifier;
+		CcTokenType type;
+		size_t length;
+	} tests[] = {
+		{.string = "", .version = CC_C23, .isIdentifier = false},
+		{.string = "int", .version = CC_C23, .isIdentifier = true, .type = CC_TOKEN_INT},
+		{.string = "int5a", .version = CC_C23, .isIdentifier = true, .type = CC_TOKEN_IDENTIFIER, .length = 5},
+		{.string = "int_t", .version = CC_C23, .isIdentifier = true, .type = CC_TOKEN_IDENTIFIER, .length = 5},
+		{.string = " int", .version = CC_C23, .isIdentifier = false},
+		{.string = "7a84de", .version = CC_C23, .isIdentifier = false},
+		{.string = "_my_var_", .version = CC_C23, .isIdentifier = true, .type = CC_TOKEN_IDENTIFIER, .length = 8},
+		{.string = "[float]", .version = CC_C23, .isIdentifier = false},
+		{.string = "fl;oat", .version = CC_C23, .isIdentifier = true, .type = CC_TOKEN_IDENTIFIER, .length = 2},
+		{.string = "float{}", .version = CC_C23, .isIdentifier = true, .type = CC_TOKEN_FLOAT},
+		{.string = "do int", .version = CC_C23, .isIdentifier = true, .type = CC_TOKEN_DO},
+		{.string = "double", .version = CC_C23, .isIdentifier = true, .type = CC_TOKEN_DOUBLE},
+		{.string = "bool", .version = CC_C23, .isIdentifier = true, .type = CC_TOKEN_BOOL},
+		{.string = "bool", .version = CC_C17, .isIdentifier = true, .type = CC_TOKEN_IDENTIFIER, .length = 4},
+		{.string = "constexpr", .version = CC_C17, .isIdentifier = true, .type = CC_TOKEN_IDENTIFIER, .length = 9},
+		{.string = "true", .version = CC_C23, .isIdentifier = true, .type = CC_TOKEN_TRUE},
+		{.string = "_Bool", .version = CC_C99, .isIdentifier = true, .type = CC_TOKEN__BOOL},
+		{.string = "_Bool", .version = CC_C90, .isIdentifier = true, .type = CC_TOKEN_IDENTIFIER, .length = 5},
+		{.string = "_Static_assert", .version = CC_C11, .isIdentifier = true, .type = CC_TOKEN__STATIC_ASSERT},
+		{.string = "typeof_unqual", .version = CC_C23, .isIdentifier = true, .type = CC_TOKEN_TYPEOF_UNQUAL},
+		{.string = "typeof_unqua", .version = CC_C23, .isIdentifier = true, .type = CC_TOKEN_IDENTIFIER, .length = 12},
+		{.string = "iff", .version = CC_C23, .isIdentifier = true, .type = CC_TOKEN_IDENTIFIER, .length = 3},
+		{.string = "i", .version = CC_C23, .isIdentifier = true, .type = CC_TOKEN_IDENTIFIER, .length = 1}
+	};
+	const size_t testCount = CC_LEN(tests);
+
+	for(size_t testIndex = 0; testIndex < testCount; ++testIndex)
+	{
+		CcToken token;
+		const bool result = ccParseIdentifier(tests[testIndex].string, tests[testIndex].version, &token);
+
+		if(result != tests[testIndex].isIdentifier)
+		{
+			CC_FAIL("Test identifier #%zu does not match.", testIndex);
+			continue;
+		}
+
+		if(!result)
+		{
+			continue;
+		}
+
+		if(token.string.string != tests[testIndex].string)
+		{
+			CC_FAIL("Test identifier #%zu wrong string.", testIndex);
+			continue;
+		}
+
+		if(token.type != tests[testIndex].type)
+		{
+			CC_FAIL("Test identifier #%zu wrong type.", testIndex);
+			continue;
+		}
+
+		if(token.type != CC_TOKEN_IDENTIFIER)
+		{
+			continue;
+		}
+
+		if(token.string.length != tests[testIndex].length)
+		{
+			CC_FAIL("Test identifier #%zu wrong length.", testIndex);
+			continue;
+		}
+	}
+}
+
+static void ccTestKeywords(bool* const pPassed)
+{
+	assert(pPassed != nullptr);
+
+	const struct
+	{
+		const char* string;
+		CcTokenType type;
+	} tests[] = {
+		{"_Static_assert", CC_TOKEN__STATIC_ASSERT},
+		{"static_assert", CC_TOKEN_STATIC_ASSERT},
+		{"typeof_unqual", CC_TOKEN_TYPEOF_UNQUAL},
+		{"_Thread_local", CC_TOKEN__THREAD_LOCAL},
+		{"thread_local", CC_TOKEN_THREAD_LOCAL},
+		{"_Decimal128", CC_TOKEN__DECIMAL_128},
+		{"_Decimal32", CC_TOKEN__DECIMAL_32},
+		{"_Decimal64", CC_TOKEN__DECIMAL_64},
+		{"_Imaginary", CC_TOKEN__IMAGINARY},
+		{"constexpr", CC_TOKEN_CONSTEXPR},
+		{"_Alignas", CC_TOKEN__ALIGNAS},
+		{"_Alignof", CC_TOKEN__ALIGNOF},
+		{"_Complex", CC_TOKEN__COMPLEX},
+		{"_Generic", CC_TOKEN__GENERIC},
+		{"continue", CC_TOKEN_CONTINUE},
+		{"register", CC_TOKEN_REGISTER},
+		{"restrict", CC_TOKEN_RESTRICT},
+		{"unsigned", CC_TOKEN_UNSIGNED},
+		{"volatile", CC_TOKEN_VOLATILE},
+		{"_Atomic", CC_TOKEN__ATOMIC},
+		{"_BitInt", CC_TOKEN__BIT_INT},
+		{"alignas", CC_TOKEN_ALIGNAS},
+		{"alignof", CC_TOKEN_ALIGNOF},
+		{"default", CC_TOKEN_DEFAULT},
+		{"typedef", CC_TOKEN_TYPEDEF},
+		{"double", CC_TOKEN_DOUBLE},
+		{"extern", CC_TOKEN_EXTERN},
+		{"return", CC_TOKEN_RETURN},
+		{"signed", CC_TOKEN_SIGNED},
+		{"sizeof", CC_TOKEN_SIZEOF},
+		{"static", CC_TOKEN_STATIC},
+		{"struct", CC_TOKEN_STRUCT},
+		{"switch", CC_TOKEN_SWITCH},
+		{"typeof", CC_TOKEN_TYPEOF},
+		{"_Bool", CC_TOKEN__BOOL},
+		{"break", CC_TOKEN_BREAK},
+		{"const", CC_TOKEN_CONST},
+		{"false", CC_TOKEN_FALSE},
+		{"float", CC_TOKEN_FLOAT},
+		{"short", CC_TOKEN_SHORT},
+		{"union", CC_TOKEN_UNION},
+		{"while", CC_TOKEN_WHILE},
+		{"auto", CC_TOKEN_AUTO},
+		{"bool", CC_TOKEN_BOOL},
+		{"case", CC_TOKEN_CASE},
+		{"char", CC_TOKEN_CHAR},
+		{"else", CC_TOKEN_ELSE},
+		{"enum", CC_TOKEN_ENUM},
+		{"goto", CC_TOKEN_GOTO},
+		{"long", CC_TOKEN_LONG},
+		{"true", CC_TOKEN_TRUE},
+		{"void", CC_TOKEN_VOID},
+		{"for", CC_TOKEN_FOR},
+		{"int", CC_TOKEN_INT},
+		{"do", CC_TOKEN_DO},
+		{"if", CC_TOKEN_IF}
+	};
+	constexpr size_t testCount = CC_LEN(tests);
+
+	for(size_t testIndex = 0; testIndex < testCount; ++testIndex)
+	{
+		CcToken token;
+		if(!ccParseIdentifier(tests[testIndex].string, CC_C23, &token) || token.type != tests[testIndex].type)
+		{
+			CC_FAIL("Test keyword #%zu wrong type.", testIndex);
+		}
+	}
+}
+
+static void ccTestSymbols(bool* const pPassed)
+{
+	assert(pPassed != nullptr);
+
+	CcSymbolTable table = {};
+
+	// Symbols are dense and given once per name.
+	constexpr size_t nameCount = 1000;
+	for(size_t pass = 0; pass < 2; ++pass)
+	{
+		for(size_t nameIndex = 0; nameIndex < nameCount; ++nameIndex)
+		{
+			char name[16];
+			const int length = snprintf(name, sizeof(name), "n%zu", nameIndex);
+
+			uint32_t symbol;
+			if(ccInternSymbol(&table, name, (size_t)length, &symbol) != CC_SUCCESS)
+			{
+				CC_FAIL("Test symbols failed to intern %s.", name);
+				goto end;
+			}
+
+			if(symbol != nameIndex)
+			{
+				CC_FAIL("Test symbols wrong symbol for %s.", name);
+			}
+		}
+	}
+
+	if(table.count != nameCount)
+	{
+		CC_FAIL("Test symbols wrong symbol count.");
+	}
+
+	uint32_t symbol;
+	if(!ccFindSymbol(&table, "n42", 3, &symbol) || symbol != 42)
+	{
+		CC_FAIL("Test symbols failed to find n42.");
+	}
+	if(ccFindSymbol(&table, "n", 1, &symbol) || ccFindSymbol(&table, "n1000", 5, &symbol))
+	{
+		CC_FAIL("Test symbols found a missing name.");
+	}
+	if(table.symbols[7].length != 2 || memcmp(table.symbols[7].name, "n7", 2) != 0)
+	{
+		CC_FAIL("Test symbols wrong name.");
+	}
+
+	const CcSymbolStatistics statistics = ccGetSymbolStatistics(&table);
+	if(
+		statistics.symbolCount != nameCount ||
+		statistics.lookupCount != 2 * nameCount ||
+		statistics.loadFactor <= 0.0 || statistics.loadFactor > 0.5 ||
+		statistics.averageProbeLength < 1.0 ||
+		statistics.maximumProbeLength < 1 || (double)statistics.maximumProbeLength < statistics.averageProbeLength
+	)
+	{
+		CC_FAIL("Test symbols wrong statistics.");
+	}
+
+	// The lexer gives the same symbol to the same identifiers.
+	const char* const source = "int a = b + a; return a;";
+	CcTokenList tokenList;
+	if(ccLex((CcConstString){.string = source, .length = strlen(source)}, CC_C23, &tokenList) != CC_SUCCESS)
+	{
+		CC_FAIL("Test symbols failed to lex.");
+		goto end;
+	}
+
+	const CcConstTokenList tokens = {&tokenList, 0, tokenList.count};
+	if(
+		tokenList.count != 10 || tokenList.symbols.count != 2 ||
+		ccGetTokenSymbol(&tokens, 1) != ccGetTokenSymbol(&tokens, 5) ||
+		ccGetTokenSymbol(&tokens, 1) != ccGetTokenSymbol(&tokens, 8) ||
+		ccGetTokenSymbol(&tokens, 1) == ccGetTokenSymbol(&tokens, 3)
+	)
+	{
+		CC_FAIL("Test symbols wrong lexed symbols.");
+	}
+
+	ccFreeTokenList(&tokenList);
+
+	end:
+	ccFreeSymbolTable(&table);
+}
+
+static void ccTestLex(bool* const pPassed)
+{
+	assert(pPassed != nullptr);
+
+	const struct
+	{
+		const char* string;
+		size_t tokenCount;
+		CcToken tokens[10];
+	} tests[] = {
+		{.string = "", .tokenCount = 0},
+		{.string = "a + b", .tokenCount = 3, .tokens = {
+			{.type = CC_TOKEN_IDENTIFIER},
+			{.type = CC_TOKEN_PLUS},
+			{.type = CC_TOKEN_IDENTIFIER}
+		}},
+		{.string = "i-*=p[\"s\"'c'5ul/x", .tokenCount = 10, .tokens = {
+			{.type = CC_TOKEN_IDENTIFIER},
+			{.type = CC_TOKEN_MINUS},
+			{.type = CC_TOKEN_STAR_EQUAL},
+			{.type = CC_TOKEN_IDENTIFIER},
+			{.type = CC_TOKEN_OPEN_BRACKET},
+			{.type = CC_TOKEN_STRING},
+			{.type = CC_TOKEN_CONSTANT},
+			{.type = CC_TOKEN_CONSTANT},
+			{.type = CC_TOKEN_SLASH},
+			{.type = CC_TOKEN_IDENTIFIER}
+		}}
+	};
+	constexpr size_t testCount = CC_LEN(tests);
+
+	for(size_t testIndex = 0; testIndex < testCount; ++testIndex)
+	{
+		CcTokenList tokenList;
+		const CcResult result = ccLex((CcConstString){.string = tests[testIndex].string, .length = strlen(tests[testIndex].string)}, CC_C23, &tokenList);
+
+		if(result != CC_SUCCESS)
+		{
+			CC_FAIL("Test lex #%zu failed.", testIndex);
+			continue;
+		}
+
+		if(tokenList.count != tests[testIndex].tokenCount)
+		{
+			CC_FAIL("Test lex #%zu wrong token count.", testIndex);
+			ccFreeTokenList(&tokenList);
+			continue;
+		}
+
+		for(size_t tokenIndex = 0; tokenIndex < tokenList.count; ++tokenIndex)
+		{
+			if(tokenList.types[tokenIndex] != tests[testIndex].tokens[tokenIndex].type)
+			{
+				CC_FAIL("Test lex #%zu wrong #%zu token.", testIndex, tokenIndex);
+			}
+		}
+
+		ccFreeTokenList(&tokenList);
+	}
+}
+
+/*
+ * Read source code from a string, for ccLexStream.
+ */
+static size_t ccReadString(void* const pStringVoid, char* const buffer, const size_t size)
+{
+	CcConstString* const pString = pStringVoid;
+
+	const size_t read = CC_MIN(size, pString->length);
+	memcpy(buffer, pString->string, read);
+	pString->string += read;
+	pString->length -= read;
+
+	return read;
+}
+
+static void ccTestLexStream(bool* const pPassed)
+{
+	assert(pPassed != nullptr);
+
+	// Shifting the same line by a few spaces puts tokens of each kind across the ends of windows.
+	static const char line[] = "int abc123 = 0x1Fu + 'a' - \"str\\\"ing\" <<= x;\n";
+	constexpr size_t lineLength = sizeof(line) - 1;
+	constexpr size_t lineCount = 8192;
+	constexpr size_t longLiteralLength = 100000;
+
+	const size_t capacity = lineCount * (lineLength + 7) + longLiteralLength + 3;
+	char* const source = malloc(capacity + 1);
+	if(!source)
+	{
+		CC_FAIL("Failed to allocate memory.");
+		return;
+	}
+
+	size_t length = 0;
+	for(size_t lineIndex = 0; lineIndex < lineCount; ++lineIndex)
+	{
+		// A literal longer than a window makes it grow.
+		if(lineIndex == lineCount / 2)
+		{
+			source[length++] = '"';
+			memset(source + length, 'x', longLiteralLength);
+			length += longLiteralLength;
+			source[length++] = '"';
+			source[length++] = '\n';
+		}
+
+		memset(source + length, ' ', lineIndex % 7);
+		length += lineIndex % 7;
+		memcpy(source + length, line, lineLength);
+		length += lineLength;
+	}
+	source[length] = '\0';
+
+	const char* const tests[] = {
+		"",
+		" \n\t ",
+		"i-*=p[\"s\"'c'5ul/x",
+		"\"unfinished",
+		source
+	};
+	constexpr size_t testCount = CC_LEN(tests);
+
+	for(size_t testIndex = 0; testIndex < testCount; ++testIndex)
+	{
+		const CcConstString string = {tests[testIndex], strlen(tests[testIndex])};
+
+		CcTokenList expected;
+		if(ccLex(string, CC_C23, &expected) != CC_SUCCESS)
+		{
+			CC_FAIL("Test lex stream #%zu: lex failed.", testIndex);
+			continue;
+		}
+
+		CcConstString remaining = string;
+		CcTokenList tokenList;
+		if(ccLexStream(ccReadString, &remaining, CC_C23, &tokenList) != CC_SUCCESS)
+		{
+			CC_FAIL("Test lex stream #%zu failed.", testIndex);
+			ccFreeTokenList(&expected);
+			continue;
+		}
+
+		if(tokenList.count != expected.count)
+		{
+			CC_FAIL("Test lex stream #%zu wrong token count.", testIndex);
+		}
+		else
+		{
+			for(size_t tokenIndex = 0; tokenIndex < tokenList.count; ++tokenIndex)
+			{
+				const CcConstTokenList tokens = {&tokenList, 0, tokenList.count};
+				const CcConstTokenList expectedTokens = {&expected, 0, expected.count};
+
+				const CcStringView string = ccGetTokenString(&tokens, tokenIndex);
+				const CcStringView expectedString = ccGetTokenString(&expectedTokens, tokenIndex);
+
+				if(
+					tokenList.types[tokenIndex] != expected.types[tokenIndex] ||
+					string.length != expectedString.length ||
+					memcmp(string.string, expectedString.string, string.length) != 0 ||
+					(tokenList.types[tokenIndex] == CC_TOKEN_CONSTANT && !ccCompareConstants(ccGetTokenConstant(&tokens, tokenIndex), ccGetTokenConstant(&expectedTokens, tokenIndex)))
+				)
+				{
+					CC_FAIL("Test lex stream #%zu wrong #%zu token.", testIndex, tokenIndex);
+					break;
+				}
+			}
+		}
+
+		ccFreeTokenList(&tokenList);
+		ccFreeTokenList(&expected);
+	}
+
+	free(source);
+}
+
+/*
+ * Lex a string by trying each recognizer in turn, the reference for the table-driven lexer.
+ *
+ * Returns:
+ * The number of tokens stored to tokens, which must hold one token per character.
+ */
+static size_t ccLexInTurn(const char* string, CcToken* const tokens)
+{
+	size_t count = 0;
+	while(true)
+	{
+		string += ccScanSpaces(string);
+		if(!*string)
+		{
+			return count;
+		}
+
+		CcToken* const pToken = &tokens[count];
+		if(
+			!ccParseString(string, pToken) &&
+			!ccParseCharacter(string, pToken) &&
+			!ccParseToken(string, pToken) &&
+			!ccParseConstant(string, pToken) &&
+			!ccParseIdentifier(string, CC_C23, pToken)
+		)
+		{
+			ccDiagnose("Unexpected token.");
+			++string;
+			continue;
+		}
+
+		pToken->string.string = string;
+		string += pToken->string.length;
+		++count;
+	}
+}
+
+static void ccTestLexEquivalence(bool* const pPassed)
+{
+	assert(pPassed != nullptr);
+
+	// Bytes a token can start or end with, for random sources.
+	static const char alphabet[] = "ab_Zq09xXuUlL.+-*/%<>=!&|^~?:;,()[]{}\"'\\ \n\t$@";
+	constexpr size_t randomLength = 1 << 16;
+
+	char* const random = malloc(randomLength + 1);
+	if(!random)
+	{
+		CC_FAIL("Failed to allocate memory.");
+		return;
+	}
+
+	uint32_t state = 12345;
+	for(size_t index = 0; index < randomLength; ++index)
+	{
+		state = state * 1664525 + 1013904223;
+		random[index] = alphabet[(state >> 16) % (sizeof(alphabet) - 1)];
+	}
+	random[randomLength] = '\0';
+
+	const char* const tests[] = {
+		"<<=<<<=<>>=>>>=>+=+++-=--->-*=*/=/%=%&=&&&|=|||^=^===!=!(){}[];~?,.:",
+		"<<<<=>>>>=---->>+++=&&&&|||==!==",
+		"int main(void){return x->y[0x1Fu] <<= 'a' + \"s\\\"t\" ... 1.5;}",
+		"''' '\\'' 'ab' 0b101 0777 09 42ull",
+		random
+	};
+	constexpr size_t testCount = CC_LEN(tests);
+
+	// Random sources are full of invalid tokens, their diagnostics are only counted.
+	FILE* const diagnosticFile = tmpfile();
+	ccSetDiagnosticFile(diagnosticFile);
 
 	for(size_t testIndex = 0; testIndex < testCount; ++testIndex)
 	{
-		CcToken token;
-		const bool result = ccParseConstant(tests[testIndex].string, &token);
+		const CcConstString string = {tests[testIndex], strlen(tests[testIndex])};
 
-		if(result != tests[testIndex].isConstant)
+		CcToken* const expected = malloc(string.length * sizeof(expected[0]));
+		if(!expected)
 		{
-			CC_FAIL("Test constant #%zu does not match.", testIndex);
+			CC_FAIL("Failed to allocate memory.");
 			continue;
 		}
 
-		if(!result)
+		const size_t expectedDiagnosticStart = ccGetDiagnosticCount();
+		const size_t expectedCount = ccLexInTurn(string.string, expected);
+		const size_t expectedDiagnosticCount = ccGetDiagnosticCount() - expectedDiagnosticStart;
+
+		const size_t diagnosticStart = ccGetDiagnosticCount();
+		CcTokenList tokenList;
+		if(ccLex(string, CC_C23, &tokenList) != CC_SUCCESS)
 		{
+			CC_FAIL("Test lex equivalence #%zu failed.", testIndex);
+			free(expected);
 			continue;
 		}
 
-		if(token.string.string != tests[testIndex].string)
+		if(ccGetDiagnosticCount() - diagnosticStart != expectedDiagnosticCount)
 		{
-			CC_FAIL("Test constant #%zu wrong string.", testIndex);
-			continue;
+			CC_FAIL("Test lex equivalence #%zu wrong diagnostic count.", testIndex);
 		}
 
-		if(token.string.length != tests[testIndex].length)
+		if(tokenList.count != expectedCount)
 		{
-			CC_FAIL("Test constant #%zu wrong length.", testIndex);
-			continue;
+			CC_FAIL("Test lex equivalence #%zu wrong token count.", testIndex);
+		}
+		else
+		{
+			for(size_t tokenIndex = 0; tokenIndex < tokenList.count; ++tokenIndex)
+			{
+				const CcConstTokenList tokens = {&tokenList, 0, tokenList.count};
+				const CcStringView tokenString = ccGetTokenString(&tokens, tokenIndex);
+				const CcToken* const pExpected = &expected[tokenIndex];
+
+				if(
+					tokenList.types[tokenIndex] != pExpected->type ||
+					tokenString.string != pExpected->string.string ||
+					tokenString.length != pExpected->string.length ||
+					(pExpected->type == CC_TOKEN_CONSTANT && !ccCompareConstants(ccGetTokenConstant(&tokens, tokenIndex), pExpected->constant))
+				)
+				{
+					CC_FAIL("Test lex equivalence #%zu wrong #%zu token.", testIndex, tokenIndex);
+					break;
+				}
+			}
 		}
 
-		if(!ccCompareConstants(token.constant, tests[testIndex].constant))
+		ccFreeTokenList(&tokenList);
+		free(expected);
+	}
+
+	ccSetDiagnosticFile(nullptr);
+	if(diagnosticFile)
+	{
+		fclose(diagnosticFile);
+	}
+
+	free(random);
+}
+
+/*
+ * Compare the contents of two files, from their start to their current position.
+ *
+ * Parameters:
+ * - first: The first file.
+ * - second: The second file.
+ *
+ * Returns:
+ * - true if the files have the same contents.
+ * - false otherwise.
+ */
+static bool ccCompareFiles(FILE* const first, FILE* const second)
+{
+	long remaining = ftell(first);
+	if(remaining < 0 || ftell(second) != remaining)
+	{
+		return false;
+	}
+
+	rewind(first);
+	rewind(second);
+
+	while(remaining > 0)
+	{
+		char firstBuffer[4096];
+		char secondBuffer[4096];
+
+		const size_t size = CC_MIN((size_t)remaining, sizeof(firstBuffer));
+		if(fread(firstBuffer, 1, size, first) != size || fread(secondBuffer, 1, size, second) != size || memcmp(firstBuffer, secondBuffer, size) != 0)
 		{
-			CC_FAIL("Test constant #%zu wrong constant.", testIndex);
+			return false;
 		}
+
+		remaining -= (long)size;
 	}
+
+	return true;
 }
 
-static void ccTestIdentifiers(bool* const pPassed)
+static void ccTestLexParallel(bool* const pPassed)
 {
 	assert(pPassed != nullptr);
 
-	const struct
+	// Multi-line string literals and character constants holding quotes and line breaks cannot be split.
+	static const char sample[] =
+		"int f(void){return x->y[0x1Fu] <<= 'a' + \"s\\\"t\" ... 1.5;}\n"
+		"\"first\nsecond ' line\" '\n' '\"' '\\'' ''' \"\\\\\" \"\n"
+		"\" name other_name _x1 42ull 'ab' @\n";
+	static const char alphabet[] = "ab_Zq09xXuUlL.+-*/%<>=!&|^~?:;,()[]{}\"'\\ \n\t$@";
+
+	// Sources large enough to be split.
+	constexpr size_t length = 4 << 20;
+
+	char* const sources[2] = {malloc(length + 1), malloc(length + 1)};
+	FILE* const files[2] = {tmpfile(), tmpfile()};
+	if(!sources[0] || !sources[1] || !files[0] || !files[1])
 	{
-		const char* string;
-		bool isIdentifier;
-		CcTokenType type;
-		size_t length;
-	} tests[] = {
-		{.string = "", .isIdentifier = false},
-		{.string = "int", .isIdentifier = true, .type = CC_TOKEN_INT},
-		{.string = "int5a", .isIdentifier = true, .type = CC_TOKEN_IDENTIFIER, .length = 5},
-		{.string = "int_t", .isIdentifier = true, .type = CC_TOKEN_IDENTIFIER, .length = 5},
-		{.string = " int", .isIdentifier = false},
-		{.string = "7a84de", .isIdentifier = false},
-		{.string = "_my_var_", .isIdentifier = true, .type = CC_TOKEN_IDENTIFIER, .length = 8},
-		{.string = "[float]", .isIdentifier = false},
-		{.string = "fl;oat", .isIdentifier = true, .type = CC_TOKEN_IDENTIFIER, .length = 2},
-		{.string = "float{}", .isIdentifier = true, .type = CC_TOKEN_FLOAT},
-		{.string = "do int", .isIdentifier = true, .type = CC_TOKEN_DO},
-		{.string = "double", .isIdentifier = true, .type = CC_TOKEN_DOUBLE}
-	};
-	const size_t testCount = CC_LEN(tests);
+		CC_FAIL("Failed to allocate memory.");
+		goto end;
+	}
 
-	for(size_t testIndex = 0; testIndex < testCount; ++testIndex)
+	for(size_t index = 0; index < length; ++index)
 	{
-		CcToken token;
-		const bool result = ccParseIdentifier(tests[testIndex].string, &token);
+		sources[0][index] = sample[index % (sizeof(sample) - 1)];
+	}
 
-		if(result != tests[testIndex].isIdentifier)
-		{
-			CC_FAIL("Test identifier #%zu does not match.", testIndex);
-			continue;
-		}
+	uint32_t state = 54321;
+	for(size_t index = 0; index < length; ++index)
+	{
+		state = state * 1664525 + 1013904223;
+		sources[1][index] = alphabet[(state >> 16) % (sizeof(alphabet) - 1)];
+	}
 
-		if(!result)
+	for(size_t testIndex = 0; testIndex < CC_LEN(sources); ++testIndex)
+	{
+		sources[testIndex][length] = '\0';
+		const CcConstString string = {sources[testIndex], length};
+
+		// Both lexers write their diagnostics to their own file, to be compared.
+		CcTokenList expected;
+		rewind(files[0]);
+		ccSetDiagnosticFile(files[0]);
+		const size_t expectedDiagnosticStart = ccGetDiagnosticCount();
+		const CcResult expectedResult = ccLex(string, CC_C23, &expected);
+		const size_t expectedDiagnosticCount = ccGetDiagnosticCount() - expectedDiagnosticStart;
+
+		CcTokenList tokenList;
+		rewind(files[1]);
+		ccSetDiagnosticFile(files[1]);
+		const size_t diagnosticStart = ccGetDiagnosticCount();
+		const CcResult result = ccLexParallel(string, CC_C23, 4, &tokenList);
+		const size_t diagnosticCount = ccGetDiagnosticCount() - diagnosticStart;
+
+		ccSetDiagnosticFile(nullptr);
+
+		if(expectedResult != CC_SUCCESS || result != CC_SUCCESS)
 		{
+			CC_FAIL("Test lex parallel #%zu failed.", testIndex);
+			ccFreeTokenList(&expected);
+			ccFreeTokenList(&tokenList);
 			continue;
 		}
 
-		if(token.string.string != tests[testIndex].string)
+		if(diagnosticCount != expectedDiagnosticCount || !ccCompareFiles(files[0], files[1]))
 		{
-			CC_FAIL("Test identifier #%zu wrong string.", testIndex);
-			continue;
+			CC_FAIL("Test lex parallel #%zu wrong diagnostics.", testIndex);
 		}
 
-		if(token.type != tests[testIndex].type)
+		if(tokenList.count != expected.count || tokenList.symbols.count != expected.symbols.count)
 		{
-			CC_FAIL("Test identifier #%zu wrong type.", testIndex);
-			continue;
+			CC_FAIL("Test lex parallel #%zu wrong token count.", testIndex);
 		}
-
-		if(token.type != CC_TOKEN_IDENTIFIER)
+		else
 		{
-			continue;
+			const CcConstTokenList tokens = {&tokenList, 0, tokenList.count};
+			const CcConstTokenList expectedTokens = {&expected, 0, expected.count};
+			for(size_t tokenIndex = 0; tokenIndex < tokenList.count; ++tokenIndex)
+			{
+				if(
+					tokenList.types[tokenIndex] != expected.types[tokenIndex] ||
+					tokenList.offsets[tokenIndex] != expected.offsets[tokenIndex] ||
+					tokenList.lengths[tokenIndex] != expected.lengths[tokenIndex] ||
+					(expected.types[tokenIndex] == CC_TOKEN_IDENTIFIER && ccGetTokenSymbol(&tokens, tokenIndex) != ccGetTokenSymbol(&expectedTokens, tokenIndex)) ||
+					(expected.types[tokenIndex] == CC_TOKEN_CONSTANT && !ccCompareConstants(ccGetTokenConstant(&tokens, tokenIndex), ccGetTokenConstant(&expectedTokens, tokenIndex)))
+				)
+				{
+					CC_FAIL("Test lex parallel #%zu wrong #%zu token.", testIndex, tokenIndex);
+					break;
+				}
+			}
 		}
 
-		if(token.string.length != tests[testIndex].length)
+		ccFreeTokenList(&expected);
+		ccFreeTokenList(&tokenList);
+	}
+
+	end:
+	for(size_t index = 0; index < CC_LEN(sources); ++index)
+	{
+		if(files[index])
 		{
-			CC_FAIL("Test identifier #%zu wrong length.", testIndex);
-			continue;
+			fclose(files[index]);
 		}
+		free(sources[index]);
 	}
 }
 
-static void ccTestLex(bool* const pPassed)
+/*
+ * Check the diagnostics written to a file.
+ *
+ * Parameters:
+ * - file: The file, written from its start.
+ * - expected: The expected diagnostics.
+ *
+ * Returns:
+ * - true if the file holds the expected diagnostics.
+ * - false otherwise.
+ */
+static bool ccCheckDiagnostics(FILE* const file, const char* const expected)
+{
+	char buffer[256] = {};
+
+	const long size = ftell(file);
+	if(size < 0 || (size_t)size != strlen(expected) || (size_t)size >= sizeof(buffer))
+	{
+		return false;
+	}
+
+	rewind(file);
+	if(fread(buffer, 1, (size_t)size, file) != (size_t)size)
+	{
+		return false;
+	}
+
+	return strcmp(buffer, expected) == 0;
+}
+
+static void ccTestDiagnosticLocations(bool* const pPassed)
 {
 	assert(pPassed != nullptr);
 
+	// Line breaks belong to the line they end, the end of the source is a position too.
+	const char* const source = "ab\ncd\n\nx";
 	const struct
 	{
-		const char* string;
-		size_t tokenCount;
-		CcToken tokens[10];
+		size_t offset;
+		size_t line;
+		size_t column;
 	} tests[] = {
-		{.string = "", .tokenCount = 0},
-		{.string = "a + b", .tokenCount = 3, .tokens = {
-			{.type = CC_TOKEN_IDENTIFIER},
-			{.type = CC_TOKEN_PLUS},
-			{.type = CC_TOKEN_IDENTIFIER}
-		}},
-		{.string = "i-*=p[\"s\"'c'5ul/x", .tokenCount = 10, .tokens = {
-			{.type = CC_TOKEN_IDENTIFIER},
-			{.type = CC_TOKEN_MINUS},
-			{.type = CC_TOKEN_STAR_EQUAL},
-			{.type = CC_TOKEN_IDENTIFIER},
-			{.type = CC_TOKEN_OPEN_BRACKET},
-			{.type = CC_TOKEN_STRING},
-			{.type = CC_TOKEN_CONSTANT},
-			{.type = CC_TOKEN_CONSTANT},
-			{.type = CC_TOKEN_SLASH},
-			{.type = CC_TOKEN_IDENTIFIER}
-		}}
+		{0, 1, 1},
+		{1, 1, 2},
+		{2, 1, 3},
+		{3, 2, 1},
+		{6, 3, 1},
+		{7, 4, 1},
+		{8, 4, 2}
 	};
 	constexpr size_t testCount = CC_LEN(tests);
 
-	for(size_t testIndex = 0; testIndex < testCount; ++testIndex)
+	CcSourceMap map;
+	if(ccBuildSourceMap(source, strlen(source), &map) != CC_SUCCESS)
 	{
-		CcTokenList tokenList;
-		const CcResult result = ccLex((CcConstString){.string = tests[testIndex].string, .length = strlen(tests[testIndex].string)}, &tokenList);
+		CC_FAIL("Test source map failed.");
+		return;
+	}
 
-		if(result != CC_SUCCESS)
-		{
-			CC_FAIL("Test lex #%zu failed.", testIndex);
-			continue;
-		}
+	if(map.lineCount != 4)
+	{
+		CC_FAIL("Test source map wrong line count.");
+	}
 
-		if(tokenList.count != tests[testIndex].tokenCount)
+	for(size_t testIndex = 0; testIndex < testCount; ++testIndex)
+	{
+		size_t line;
+		size_t column;
+		if(!ccLocate(&map, source + tests[testIndex].offset, &line, &column) || line != tests[testIndex].line || column != tests[testIndex].column)
 		{
-			CC_FAIL("Test lex #%zu wrong token count.", testIndex);
-			free(tokenList.tokens);
-			continue;
+			CC_FAIL("Test source map #%zu wrong location.", testIndex);
 		}
+	}
 
-		for(size_t tokenIndex = 0; tokenIndex < tokenList.count; ++tokenIndex)
-		{
-			if(tokenList.tokens[tokenIndex].type != tests[testIndex].tokens[tokenIndex].type)
-			{
-				CC_FAIL("Test lex #%zu wrong #%zu token.", testIndex, tokenIndex);
-			}
-		}
+	size_t line;
+	size_t column;
+	if(ccLocate(&map, source + strlen(source) + 1, &line, &column))
+	{
+		CC_FAIL("Test source map located a position past the source.");
+	}
+
+	ccFreeSourceMap(&map);
+
+	FILE* const file = tmpfile();
+	if(!file)
+	{
+		CC_FAIL("Failed to create a file.");
+		return;
+	}
+	ccSetDiagnosticFile(file);
+
+	// Lexer diagnostics are located once the source is set.
+	const char* const code = "int a;\n  @ b\n\"x";
+	ccSetDiagnosticSource((CcDiagnosticSource){"test.c", code, strlen(code)});
+
+	CcTokenList tokenList;
+	if(ccLex((CcConstString){code, strlen(code)}, CC_C23, &tokenList) != CC_SUCCESS)
+	{
+		CC_FAIL("Test diagnostic locations failed to lex.");
+	}
+	ccFreeTokenList(&tokenList);
+
+	if(!ccCheckDiagnostics(file, "test.c:2:3: Unexpected token.\ntest.c:3:1: Unfinished string literal.\n"))
+	{
+		CC_FAIL("Test diagnostic locations wrong diagnostics.");
+	}
+
+	// Chunks lexed by other threads locate their diagnostics in the same source.
+	constexpr size_t length = 4 << 20;
+	char* const large = malloc(length + 1);
+	if(!large)
+	{
+		CC_FAIL("Failed to allocate memory.");
+		goto end;
+	}
+
+	for(size_t index = 0; index < length; index += 2)
+	{
+		large[index] = 'a';
+		large[index + 1] = '\n';
+	}
+	large[3000000] = '@';
+	large[length] = '\0';
+
+	rewind(file);
+	ccSetDiagnosticSource((CcDiagnosticSource){"large.c", large, length});
+	if(ccLexParallel((CcConstString){large, length}, CC_C23, 4, &tokenList) != CC_SUCCESS)
+	{
+		CC_FAIL("Test diagnostic locations failed to lex in parallel.");
+	}
+	ccFreeTokenList(&tokenList);
+
+	if(!ccCheckDiagnostics(file, "large.c:1500001:1: Unexpected token.\n"))
+	{
+		CC_FAIL("Test diagnostic locations wrong parallel diagnostics.");
+	}
+
+	free(large);
 
-		free(tokenList.tokens);
+	end:
+	ccSetDiagnosticSource((CcDiagnosticSource){});
+	ccSetDiagnosticFile(nullptr);
+	fclose(file);
+}
+
+static void ccTestDiagnosticSink(bool* const pPassed)
+{
+	assert(pPassed != nullptr);
+
+	FILE* const file = tmpfile();
+	if(!file)
+	{
+		CC_FAIL("Failed to create a file.");
+		return;
+	}
+	ccSetDiagnosticFile(file);
+
+	// Repeats on a line are merged, the ones past the limit of their code are counted in a single line.
+	const char* const code = "\"a\x01\x02\x03" "b\"\n@ @\n@\n99999999999999999999999\n99999999999999999999999\n";
+	ccSetDiagnosticSource((CcDiagnosticSource){"sink.c", code, strlen(code)});
+	ccSetDiagnosticLimit(CC_DIAGNOSTIC_INTEGER_TOO_LARGE, 1);
+
+	const size_t diagnosticStart = ccGetDiagnosticCount();
+	CcTokenList tokenList;
+	if(ccLex((CcConstString){code, strlen(code)}, CC_C23, &tokenList) != CC_SUCCESS)
+	{
+		CC_FAIL("Test diagnostic sink failed to lex.");
+	}
+	ccFreeTokenList(&tokenList);
+
+	if(
+		!ccCheckDiagnostics(
+			file,
+			"sink.c:1:3: Invalid character in string literal. (repeated 3 times)\n"
+			"sink.c:2:1: Unexpected token. (repeated 2 times)\n"
+			"sink.c:3:1: Unexpected token.\n"
+			"sink.c:4:1: Integer literal too large.\n"
+			"Integer literal too large. (1 more omitted)\n"
+		)
+	)
+	{
+		CC_FAIL("Test diagnostic sink wrong diagnostics.");
+	}
+
+	if(ccGetDiagnosticCount() - diagnosticStart != 8)
+	{
+		CC_FAIL("Test diagnostic sink wrong diagnostic count.");
 	}
+
+	// Diagnostics written directly keep their order with the recorded ones.
+	rewind(file);
+	CcDiagnosticSink sink;
+	ccBeginDiagnostics(&sink);
+	ccReportDiagnostic(CC_DIAGNOSTIC_UNEXPECTED_TOKEN, code + 8);
+	ccDiagnose("Direct.");
+	ccReportDiagnostic(CC_DIAGNOSTIC_UNEXPECTED_TOKEN, code + 10);
+	ccEndDiagnostics(&sink);
+
+	if(!ccCheckDiagnostics(file, "sink.c:2:1: Unexpected token.\nDirect.\nsink.c:2:3: Unexpected token.\n"))
+	{
+		CC_FAIL("Test diagnostic sink wrong order.");
+	}
+
+	// Without a source, lines are unknown, so repeats are not merged.
+	rewind(file);
+	ccSetDiagnosticSource((CcDiagnosticSource){});
+	if(ccLex((CcConstString){"@\n@", 3}, CC_C23, &tokenList) != CC_SUCCESS)
+	{
+		CC_FAIL("Test diagnostic sink failed to lex without a source.");
+	}
+	ccFreeTokenList(&tokenList);
+
+	if(!ccCheckDiagnostics(file, "Unexpected token.\nUnexpected token.\n"))
+	{
+		CC_FAIL("Test diagnostic sink merged repeats without a source.");
+	}
+
+	ccSetDiagnosticLimit(CC_DIAGNOSTIC_INTEGER_TOO_LARGE, 0);
+	ccSetDiagnosticFile(nullptr);
+	fclose(file);
 }
 
 static void ccTestParentheses(bool* const pPassed)
@@ -482,27 +2056,117 @@ static void ccTestParentheses(bool* const pPassed)
 		{(const CcToken[]){{.type = CC_TOKEN_OPEN_PARENTHESIS}, {.type = CC_TOKEN_CLOSE_PARENTHESIS}}, 2, 1, CC_DIRECTION_BACKWARD, true, 0},
 		{(const CcToken[]){{.type = CC_TOKEN_CLOSE_PARENTHESIS}, {.type = CC_TOKEN_OPEN_PARENTHESIS}, {.type = CC_TOKEN_CLOSE_PARENTHESIS}}, 3, 0, CC_DIRECTION_FORWARD, false, 0},
 		{(const CcToken[]){{.type = CC_TOKEN_OPEN_PARENTHESIS}, {.type = CC_TOKEN_CLOSE_PARENTHESIS}, {.type = CC_TOKEN_OPEN_PARENTHESIS}}, 3, 2, CC_DIRECTION_BACKWARD, false, 2},
+		{(const CcToken[]){{.type = CC_TOKEN_OPEN_PARENTHESIS}, {.type = CC_TOKEN_OPEN_PARENTHESIS}, {.type = CC_TOKEN_CLOSE_PARENTHESIS}}, 3, 0, CC_DIRECTION_FORWARD, false, 0},
+		{(const CcToken[]){{.type = CC_TOKEN_OPEN_PARENTHESIS}, {.type = CC_TOKEN_OPEN_BRACKET}, {.type = CC_TOKEN_CLOSE_PARENTHESIS}, {.type = CC_TOKEN_CLOSE_BRACKET}}, 4, 0, CC_DIRECTION_FORWARD, false, 0},
 		{(const CcToken[]){{.type = CC_TOKEN_OPEN_PARENTHESIS}, {.type = CC_TOKEN_PLUS}, {.type = CC_TOKEN_OPEN_PARENTHESIS},  {.type = CC_TOKEN_PLUS}, {.type = CC_TOKEN_CLOSE_PARENTHESIS}, {.type = CC_TOKEN_PLUS}, {.type = CC_TOKEN_CLOSE_PARENTHESIS}, {.type = CC_TOKEN_PLUS}}, 8, 0, CC_DIRECTION_FORWARD, true, 6},
 		{(const CcToken[]){{.type = CC_TOKEN_PLUS}, {.type = CC_TOKEN_OPEN_PARENTHESIS}, {.type = CC_TOKEN_PLUS}, {.type = CC_TOKEN_OPEN_PARENTHESIS},  {.type = CC_TOKEN_PLUS}, {.type = CC_TOKEN_CLOSE_PARENTHESIS}, {.type = CC_TOKEN_PLUS}, {.type = CC_TOKEN_CLOSE_PARENTHESIS}}, 8, 7, CC_DIRECTION_BACKWARD, true, 1},
 	};
 	constexpr size_t testCount = CC_LEN(tests);
 
-	for(size_t testIndex = 0; testIndex < testCount; ++testIndex)
+	for(size_t testIndex = 0; testIndex < testCount; ++testIndex)
+	{
+		CcTokenList tokenList;
+		if(!ccMakeTokenList(tests[testIndex].tokens, tests[testIndex].count, nullptr, 0, &tokenList))
+		{
+			CC_FAIL("Test parentheses #%zu: failed to make the token list.", testIndex);
+			continue;
+		}
+
+		size_t tokenIndex = tests[testIndex].start;
+		const bool result = ccSkipParentheses(&tokenIndex, &(const CcConstTokenList){&tokenList, 0, tokenList.count}, tests[testIndex].direction);
+		ccFreeTokenList(&tokenList);
+
+		if(result != tests[testIndex].result)
+		{
+			CC_FAIL("Test parentheses #%zu: wrong result.", testIndex);
+			continue;
+		}
+
+		if(tokenIndex != tests[testIndex].end)
+		{
+			CC_FAIL("Test parentheses #%zu: wrong end pointer.", testIndex);
+		}
+	}
+}
+
+static void ccTestBrackets(bool* const pPassed)
+{
+	assert(pPassed != nullptr);
+
+	// Each bracket maps to its partner, other tokens to themselves.
+	const char* const code = "a([{}]) [(] ) {";
+	const size_t expected[] = {0, 6, 5, 4, 3, 2, 1, SIZE_MAX, 10, SIZE_MAX, 8, SIZE_MAX};
+
+	CcTokenList tokenList;
+	if(ccLex((CcConstString){code, strlen(code)}, CC_C23, &tokenList) != CC_SUCCESS)
+	{
+		CC_FAIL("Test brackets failed to lex.");
+		return;
+	}
+
+	const CcConstTokenList tokens = {&tokenList, 0, tokenList.count};
+	if(tokenList.count != CC_LEN(expected))
+	{
+		CC_FAIL("Test brackets wrong token count.");
+	}
+	else
+	{
+		for(size_t tokenIndex = 0; tokenIndex < tokenList.count; ++tokenIndex)
+		{
+			if(ccGetTokenPartner(&tokens, tokenIndex) != expected[tokenIndex])
+			{
+				CC_FAIL("Test brackets wrong partner of #%zu token.", tokenIndex);
+			}
+		}
+	}
+
+	if(tokenList.unmatchedIndex != 7)
 	{
-		size_t tokenIndex = tests[testIndex].start;
-		const bool result = ccSkipParentheses(&tokenIndex, &(const CcConstTokenList){tests[testIndex].tokens, tests[testIndex].count}, tests[testIndex].direction);
+		CC_FAIL("Test brackets wrong unmatched bracket.");
+	}
 
-		if(result != tests[testIndex].result)
+	// A partner out of the range is not reachable.
+	if(ccGetTokenPartner(&(const CcConstTokenList){&tokenList, 1, 3}, 0) != SIZE_MAX)
+	{
+		CC_FAIL("Test brackets partner out of range.");
+	}
+
+	ccFreeTokenList(&tokenList);
+
+	// Parsing reports an unmatched bracket once, before anything else.
+	FILE* const file = tmpfile();
+	if(!file)
+	{
+		CC_FAIL("Failed to create a file.");
+		return;
+	}
+	ccSetDiagnosticFile(file);
+
+	const char* const program = "int main(void)\n{\n\treturn 1 + 2);\n}\n";
+	ccSetDiagnosticSource((CcDiagnosticSource){"brackets.c", program, strlen(program)});
+
+	if(ccLex((CcConstString){program, strlen(program)}, CC_C23, &tokenList) != CC_SUCCESS)
+	{
+		CC_FAIL("Test brackets failed to lex the program.");
+	}
+	else
+	{
+		CcTree tree = {};
+		const size_t diagnosticStart = ccGetDiagnosticCount();
+		if(ccParse(&(const CcConstTokenList){&tokenList, 0, tokenList.count}, &tree) != CC_ERROR_INVALID_ARGUMENT)
 		{
-			CC_FAIL("Test parentheses #%zu: wrong result.", testIndex);
-			continue;
+			CC_FAIL("Test brackets parsed an unmatched bracket.");
 		}
-
-		if(tokenIndex != tests[testIndex].end)
+		if(ccGetDiagnosticCount() - diagnosticStart != 1 || !ccCheckDiagnostics(file, "brackets.c:3:14: Unmatched bracket.\n"))
 		{
-			CC_FAIL("Test parentheses #%zu: wrong end pointer.", testIndex);
+			CC_FAIL("Test brackets wrong diagnostics.");
 		}
 	}
+	ccFreeTokenList(&tokenList);
+
+	ccSetDiagnosticSource((CcDiagnosticSource){});
+	ccSetDiagnosticFile(nullptr);
+	fclose(file);
 }
 
 static void ccTestExpressions(bool* const pPassed)
@@ -555,6 +2219,21 @@ static void ccTestExpressions(bool* const pPassed)
 			{.type = CC_NODE_CONSTANT, .constant = {CC_CONSTANT_INT, 37}},
 			{.type = CC_NODE_BIN_OP, .binOpNode = {CC_BIN_OP_SUM, 8, 9}}
 		}, 11},
+		{(const CcToken[]){
+			{.type = CC_TOKEN_OPEN_PARENTHESIS},
+			{.type = CC_TOKEN_CONSTANT, .constant = {CC_CONSTANT_INT, 1}},
+			{.type = CC_TOKEN_PLUS},
+			{.type = CC_TOKEN_CONSTANT, .constant = {CC_CONSTANT_INT, 2}},
+			{.type = CC_TOKEN_CLOSE_PARENTHESIS},
+			{.type = CC_TOKEN_STAR},
+			{.type = CC_TOKEN_CONSTANT, .constant = {CC_CONSTANT_INT, 3}}
+		}, 7, true, (const CcNode[]){
+			{.type = CC_NODE_CONSTANT, .constant = {CC_CONSTANT_INT, 1}},
+			{.type = CC_NODE_CONSTANT, .constant = {CC_CONSTANT_INT, 2}},
+			{.type = CC_NODE_BIN_OP, .binOpNode = {CC_BIN_OP_SUM, 0, 1}},
+			{.type = CC_NODE_CONSTANT, .constant = {CC_CONSTANT_INT, 3}},
+			{.type = CC_NODE_BIN_OP, .binOpNode = {CC_BIN_OP_MUL, 2, 3}}
+		}, 5},
 		{
 			(const CcToken[]){
 				{.type = CC_TOKEN_CONSTANT, .constant = {CC_CONSTANT_INT, 0}},
@@ -637,15 +2316,21 @@ static void ccTestExpressions(bool* const pPassed)
 	};
 	constexpr size_t testCount = CC_LEN(tests);
 
-	CcNode nodes[64];
-	size_t children[1];
+	CcTestTree storage;
 
 	for(size_t testIndex = 0; testIndex < testCount; ++testIndex)
 	{
-		CcTree tree = {.nodes = nodes, .children = children};
-		CcConstTokenList tokens = {tests[testIndex].tokens, tests[testIndex].count};
+		CcTree tree = ccMakeTestTree(&storage);
+		CcTokenList tokenList;
+		if(!ccMakeTokenList(tests[testIndex].tokens, tests[testIndex].count, nullptr, 0, &tokenList))
+		{
+			CC_FAIL("Parse expression #%zu: failed to make the token list.", testIndex);
+			continue;
+		}
+		CcConstTokenList tokens = {&tokenList, 0, tokenList.count};
 
 		const bool result = ccParseExpression(&(CcTreeBuilder){.pTree = &tree, .tokens = &tokens});
+		ccFreeTokenList(&tokenList);
 		if(result != tests[testIndex].result)
 		{
 			CC_FAIL("Parse expression #%zu: wrong result.", testIndex);
@@ -665,16 +2350,17 @@ static void ccTestExpressions(bool* const pPassed)
 
 		for(size_t nodeIndex = 0; nodeIndex < tree.count; ++nodeIndex)
 		{
-			if(tree.nodes[nodeIndex].type != tests[testIndex].solution[nodeIndex].type)
+			const CcNode node = ccGetNode(&tree, nodeIndex);
+			if(node.type != tests[testIndex].solution[nodeIndex].type)
 			{
 				CC_FAIL("Parse expression #%zu: node #%zu: wrong type.", testIndex, nodeIndex);
 				continue;
 			}
 
-			switch(tree.nodes[nodeIndex].type)
+			switch(node.type)
 			{
 				case CC_NODE_CONSTANT:
-					if(!ccCompareConstants(tree.nodes[nodeIndex].constant, tests[testIndex].solution[nodeIndex].constant))
+					if(!ccCompareConstants(node.constant, tests[testIndex].solution[nodeIndex].constant))
 					{
 						CC_FAIL("Parse expression #%zu: node #%zu: wrong constant.", testIndex, nodeIndex);
 						break;
@@ -682,18 +2368,18 @@ static void ccTestExpressions(bool* const pPassed)
 					break;
 
 				case CC_NODE_BIN_OP:
-					if(tree.nodes[nodeIndex].binOpNode.op != tests[testIndex].solution[nodeIndex].binOpNode.op)
+					if(node.binOpNode.op != tests[testIndex].solution[nodeIndex].binOpNode.op)
 					{
 						CC_FAIL("Parse expression #%zu: node #%zu: wrong binop type.", testIndex, nodeIndex);
 						break;
 					}
 
-					if(tree.nodes[nodeIndex].binOpNode.leftNode != tests[testIndex].solution[nodeIndex].binOpNode.leftNode)
+					if(node.binOpNode.leftNode != tests[testIndex].solution[nodeIndex].binOpNode.leftNode)
 					{
 						CC_FAIL("Parse expression #%zu: node #%zu: wrong binop left node", testIndex, nodeIndex);
 					}
 
-					if(tree.nodes[nodeIndex].binOpNode.rightNode != tests[testIndex].solution[nodeIndex].binOpNode.rightNode)
+					if(node.binOpNode.rightNode != tests[testIndex].solution[nodeIndex].binOpNode.rightNode)
 					{
 						CC_FAIL("Parse expression #%zu: node #%zu: wrong binop right node", testIndex, nodeIndex);
 					}
@@ -707,6 +2393,170 @@ static void ccTestExpressions(bool* const pPassed)
 	}
 }
 
+/*
+ * Lex a function returning an expression made of repeated text.
+ *
+ * Parameters:
+ * - opening: The text repeated before the middle.
+ * - middle: The text in the middle.
+ * - closing: The text repeated after the middle, one character long or empty.
+ * - count: The number of times the opening and closing are repeated.
+ * - pTokenList: A pointer to the list of tokens.
+ * - pSource: A pointer to store the source, which the tokens point into and which is to be freed after them.
+ *
+ * Returns:
+ * - true if the function was lexed.
+ * - false otherwise, in which case there is nothing to free.
+ */
+static bool ccLexReturn(const char* const opening, const char* const middle, const char* const closing, const size_t count, CcTokenList* const pTokenList, char** const pSource)
+{
+	static const char prefix[] = "int f(void){return ";
+	static const char suffix[] = ";}";
+
+	const size_t openingLength = strlen(opening);
+	const size_t middleLength = strlen(middle);
+	const size_t closingLength = strlen(closing);
+	assert(closingLength <= 1);
+
+	const size_t length = sizeof(prefix) - 1 + count * (openingLength + closingLength) + middleLength + sizeof(suffix) - 1;
+	char* const source = malloc(length + 1);
+	if(!source)
+	{
+		return false;
+	}
+
+	memcpy(source, prefix, sizeof(prefix) - 1);
+	char* end = source + sizeof(prefix) - 1;
+	for(size_t index = 0; index < count; ++index)
+	{
+		memcpy(end, opening, openingLength);
+		end += openingLength;
+	}
+	memcpy(end, middle, middleLength);
+	end += middleLength;
+	memset(end, closingLength > 0 ? closing[0] : ' ', count * closingLength);
+	end += count * closingLength;
+	memcpy(end, suffix, sizeof(suffix));
+
+	if(ccLex((CcConstString){source, length}, CC_C23, pTokenList) != CC_SUCCESS)
+	{
+		free(source);
+		return false;
+	}
+	*pSource = source;
+
+	return true;
+}
+
+static void ccTestExpressionScaling(bool* const pPassed)
+{
+	assert(pPassed != nullptr);
+
+	// A long sum is parsed into one node per term and operator, each addition holding the previous one on its left.
+	constexpr size_t termCount = 400000;
+	CcTokenList tokenList;
+	char* source;
+	if(!ccLexReturn("1+", "1", "", termCount - 1, &tokenList, &source))
+	{
+		CC_FAIL("Test expression scaling failed to lex.");
+		return;
+	}
+
+	CcTree tree = {};
+	if(ccParse(&(const CcConstTokenList){&tokenList, 0, tokenList.count}, &tree) != CC_SUCCESS)
+	{
+		CC_FAIL("Test expression scaling failed to parse.");
+		ccFreeTokenList(&tokenList);
+		free(source);
+		return;
+	}
+
+	// The function and the program follow the return statement and the expression.
+	if(tree.count != termCount * 2 + 2)
+	{
+		CC_FAIL("Test expression scaling wrong node count.");
+	}
+	else
+	{
+		size_t nodeIndex = tree.count - 4;
+		size_t depth = 0;
+		while(tree.types[nodeIndex] == CC_NODE_BIN_OP)
+		{
+			nodeIndex = ccGetNode(&tree, nodeIndex).binOpNode.leftNode;
+			++depth;
+		}
+
+		if(depth != termCount - 1)
+		{
+			CC_FAIL("Test expression scaling wrong tree.");
+		}
+	}
+
+	ccFreeTree(&tree);
+	ccFreeTokenList(&tokenList);
+	free(source);
+}
+
+static void ccTestExpressionNesting(bool* const pPassed)
+{
+	assert(pPassed != nullptr);
+
+	// Deep enough to overflow the stack of a recursive parser.
+	constexpr size_t depth = 200000;
+
+	FILE* const file = tmpfile();
+	if(!file)
+	{
+		CC_FAIL("Failed to create a file.");
+		return;
+	}
+
+	CcTokenList tokenList;
+	char* source;
+	if(!ccLexReturn("(1+", "1", ")", depth, &tokenList, &source))
+	{
+		CC_FAIL("Test expression nesting failed to lex.");
+		goto end;
+	}
+
+	// Each level holds a constant and an addition.
+	ccSetNestingLimit(depth);
+	CcTree tree = {};
+	if(ccParse(&(const CcConstTokenList){&tokenList, 0, tokenList.count}, &tree) != CC_SUCCESS)
+	{
+		CC_FAIL("Test expression nesting failed to parse.");
+	}
+	else
+	{
+		if(tree.count != depth * 2 + 4)
+		{
+			CC_FAIL("Test expression nesting wrong node count.");
+		}
+		ccFreeTree(&tree);
+	}
+
+	// Past the limit, the expression is rejected with a single diagnostic.
+	ccSetNestingLimit(depth - 1);
+	ccSetDiagnosticFile(file);
+	const size_t diagnosticStart = ccGetDiagnosticCount();
+	if(ccParse(&(const CcConstTokenList){&tokenList, 0, tokenList.count}, &tree) != CC_ERROR_INVALID_ARGUMENT)
+	{
+		CC_FAIL("Test expression nesting parsed past the limit.");
+	}
+	if(ccGetDiagnosticCount() - diagnosticStart != 1 || !ccCheckDiagnostics(file, "Parentheses nested too deeply.\n"))
+	{
+		CC_FAIL("Test expression nesting wrong diagnostics.");
+	}
+	ccSetDiagnosticFile(nullptr);
+	ccSetNestingLimit(0);
+
+	ccFreeTokenList(&tokenList);
+	free(source);
+
+	end:
+	fclose(file);
+}
+
 static void ccTestStatements(bool* const pPassed)
 {
 	assert(pPassed != nullptr);
@@ -729,7 +2579,7 @@ static void ccTestStatements(bool* const pPassed)
 			{.type = CC_TOKEN_RETURN},
 			{.type = CC_TOKEN_SEMICOLON}
 		}, 2, true, (const CcNode[]){
-			{.type = CC_NODE_RETURN, .returnNode = SIZE_MAX}
+			{.type = CC_NODE_RETURN, .returnNode = UINT32_MAX}
 		}, 1},
 		{(const CcToken[]){
 			{.type = CC_TOKEN_RETURN},
@@ -747,15 +2597,21 @@ static void ccTestStatements(bool* const pPassed)
 	};
 	constexpr size_t testCount = CC_LEN(tests);
 
-	CcNode nodes[64];
-	size_t children[1];
+	CcTestTree storage;
 
 	for(size_t testIndex = 0; testIndex < testCount; ++testIndex)
 	{
-		CcTree tree = {.nodes = nodes, .children = children};
-		CcConstTokenList tokens = {.tokens = tests[testIndex].tokens, .count = tests[testIndex].count};
+		CcTree tree = ccMakeTestTree(&storage);
+		CcTokenList tokenList;
+		if(!ccMakeTokenList(tests[testIndex].tokens, tests[testIndex].count, nullptr, 0, &tokenList))
+		{
+			CC_FAIL("Parse statement #%zu: failed to make the token list.", testIndex);
+			continue;
+		}
+		CcConstTokenList tokens = {&tokenList, 0, tokenList.count};
 
 		const bool result = ccParseStatement(&(CcTreeBuilder){.pTree = &tree, .tokens = &tokens});
+		ccFreeTokenList(&tokenList);
 		if(result != tests[testIndex].result)
 		{
 			CC_FAIL("Parse statement #%zu: wrong result.", testIndex);
@@ -775,15 +2631,16 @@ static void ccTestStatements(bool* const pPassed)
 
 		for(size_t nodeIndex = 0; nodeIndex < tree.count; ++nodeIndex)
 		{
-			if(tree.nodes[nodeIndex].type != tests[testIndex].solution[nodeIndex].type)
+			const CcNode node = ccGetNode(&tree, nodeIndex);
+			if(node.type != tests[testIndex].solution[nodeIndex].type)
 			{
 				CC_FAIL("Parse statement #%zu: node #%zu: wrong type.", testIndex, nodeIndex);
 				continue;
 			}
 
-			if(tree.nodes[nodeIndex].type == CC_NODE_RETURN)
+			if(node.type == CC_NODE_RETURN)
 			{
-				if(tree.nodes[nodeIndex].returnNode != tests[testIndex].solution[nodeIndex].returnNode)
+				if(node.returnNode != tests[testIndex].solution[nodeIndex].returnNode)
 				{
 					CC_FAIL("Parse statement #%zu: node #%zu: wrong value node.", testIndex, nodeIndex);
 				}
@@ -792,6 +2649,29 @@ static void ccTestStatements(bool* const pPassed)
 	}
 }
 
+/*
+ * Check the name of a function node.
+ *
+ * Parameters:
+ * - pTree: A pointer to the tree of the function.
+ * - node: A function node.
+ * - name: The expected name.
+ *
+ * Returns:
+ * - true if the symbol of the function is interned with the name in the tree.
+ * - false otherwise.
+ */
+static bool ccIsFunctionNamed(const CcTree* const pTree, const CcNode node, const char* const name)
+{
+	if(node.function.symbol >= pTree->symbols.count)
+	{
+		return false;
+	}
+
+	const CcSymbol* const pSymbol = &pTree->symbols.symbols[node.function.symbol];
+	return pSymbol->length == strlen(name) && memcmp(pSymbol->name, name, pSymbol->length) == 0;
+}
+
 static void ccTestFunctions(bool* const pPassed)
 {
 	assert(pPassed != nullptr);
@@ -805,6 +2685,7 @@ static void ccTestFunctions(bool* const pPassed)
 		size_t solutionCount;
 		const size_t* childrenSolution;
 		size_t childrenSolutionCount;
+		const char* const* functionNames;
 	} tests[] = {
 		{(const CcToken[]){
 			{.type = CC_TOKEN_INT},
@@ -829,7 +2710,7 @@ static void ccTestFunctions(bool* const pPassed)
 			{.type = CC_NODE_CONSTANT, .constant = {CC_CONSTANT_INT, 2}},
 			{.type = CC_NODE_BIN_OP, .binOpNode = {.op = CC_BIN_OP_SUM}},
 			{.type = CC_NODE_RETURN},
-			{.type = CC_NODE_RETURN, .returnNode = SIZE_MAX},
+			{.type = CC_NODE_RETURN, .returnNode = UINT32_MAX},
 			{.type = CC_NODE_CONSTANT, .constant = {CC_CONSTANT_INT, 0}},
 			{.type = CC_NODE_RETURN},
 			{.type = CC_NODE_FUNCTION, .function = {.statementsStart = 2, .statementsCount = 3}}
@@ -837,7 +2718,7 @@ static void ccTestFunctions(bool* const pPassed)
 			6,
 			4,
 			3
-		}, 3},
+		}, 3, (const char* const[]){"some_func"}},
 		{(const CcToken[]){
 			{.type = CC_TOKEN_INT},
 			{.type = CC_TOKEN_IDENTIFIER, .string = {"some_other_func", 15}},
@@ -847,44 +2728,55 @@ static void ccTestFunctions(bool* const pPassed)
 			{.type = CC_TOKEN_CLOSE_BRACE}
 		}, 6, true, (CcNode[]){
 			{.type = CC_NODE_FUNCTION, .function = {.statementsCount = 0}}
-		}, 1, nullptr, 0}
+		}, 1, nullptr, 0, (const char* const[]){"some_other_func"}}
 	};
 	constexpr size_t testCount = CC_LEN(tests);
 
-	tests[0].solution[7].function.name = tests[0].tokens[1].string;
-	tests[1].solution[0].function.name = tests[1].tokens[1].string;
-
-	CcNode nodes[64];
-	size_t children[64];
+	CcTestTree storage;
+	char text[64];
 
 	for(size_t testIndex = 0; testIndex < testCount; ++testIndex)
 	{
-		CcTree tree = {.nodes = nodes, .children = children};
-		CcConstTokenList tokens = {tests[testIndex].tokens, tests[testIndex].count};
+		CcTree tree = ccMakeTestTree(&storage);
+		CcTokenList tokenList;
+		if(!ccMakeTokenList(tests[testIndex].tokens, tests[testIndex].count, text, sizeof(text), &tokenList))
+		{
+			CC_FAIL("Parse function #%zu: failed to make the token list.", testIndex);
+			continue;
+		}
+		CcConstTokenList tokens = {&tokenList, 0, tokenList.count};
 
-		CcTreeBuilder builder = {.pTree = &tree, .tokens = &tokens, .lastIndex = CC_LEN(children)};
+		CcTreeBuilder builder = {.pTree = &tree, .tokens = &tokens, .lastIndex = tree.childCapacity};
 
 		const bool result = ccParseFunction(&builder);
 		if(result != tests[testIndex].result)
 		{
 			CC_FAIL("Parse function #%zu: wrong result.", testIndex);
+			ccFreeTokenList(&tokenList);
+			ccFreeSymbolTable(&tree.symbols);
 			continue;
 		}
 
 		if(!result)
 		{
+			ccFreeTokenList(&tokenList);
+			ccFreeSymbolTable(&tree.symbols);
 			continue;
 		}
 
 		if(tree.count != tests[testIndex].solutionCount)
 		{
 			CC_FAIL("Parse function #%zu: wrong count.", testIndex);
+			ccFreeTokenList(&tokenList);
+			ccFreeSymbolTable(&tree.symbols);
 			continue;
 		}
 
 		if(builder.childCount != tests[testIndex].childrenSolutionCount)
 		{
 			CC_FAIL("Parse function #%zu: wrong child count.", testIndex);
+			ccFreeTokenList(&tokenList);
+			ccFreeSymbolTable(&tree.symbols);
 			continue;
 		}
 
@@ -896,27 +2788,27 @@ static void ccTestFunctions(bool* const pPassed)
 			}
 		}
 
+		// Function names are checked through the symbols the tree interned them as.
+		size_t functionIndex = 0;
 		for(size_t nodeIndex = 0; nodeIndex < tree.count; ++nodeIndex)
 		{
-			if(tree.nodes[nodeIndex].type != tests[testIndex].solution[nodeIndex].type)
+			const CcNode node = ccGetNode(&tree, nodeIndex);
+			if(node.type != tests[testIndex].solution[nodeIndex].type)
 			{
 				CC_FAIL("Parse function #%zu: node #%zu: wrong type.", testIndex, nodeIndex);
 				continue;
 			}
 
-			if(tree.nodes[nodeIndex].type == CC_NODE_FUNCTION)
+			if(node.type == CC_NODE_FUNCTION)
 			{
-				if(
-					tree.nodes[nodeIndex].function.name.string != tests[testIndex].solution[nodeIndex].function.name.string ||
-					tree.nodes[nodeIndex].function.name.length != tests[testIndex].solution[nodeIndex].function.name.length
-				)
+				if(!ccIsFunctionNamed(&tree, node, tests[testIndex].functionNames[functionIndex++]))
 				{
 					CC_FAIL("Parse function #%zu: node #%zu: wrong function name.", testIndex, nodeIndex);
 				}
 
 				if(
-					tree.nodes[nodeIndex].function.statementsCount != tests[testIndex].solution[nodeIndex].function.statementsCount || (
-						tests[testIndex].childrenSolutionCount > 0 && tree.nodes[nodeIndex].function.statementsStart != tests[testIndex].solution[nodeIndex].function.statementsStart
+					node.function.statementsCount != tests[testIndex].solution[nodeIndex].function.statementsCount || (
+						tests[testIndex].childrenSolutionCount > 0 && node.function.statementsStart != tests[testIndex].solution[nodeIndex].function.statementsStart
 					)
 				)
 				{
@@ -924,6 +2816,9 @@ static void ccTestFunctions(bool* const pPassed)
 				}
 			}
 		}
+
+		ccFreeTokenList(&tokenList);
+		ccFreeSymbolTable(&tree.symbols);
 	}
 }
 
@@ -940,6 +2835,7 @@ static void ccTestProgram(bool* const pPassed)
 		size_t solutionCount;
 		const size_t* childrenSolution;
 		size_t childrenSolutionCount;
+		const char* const* functionNames;
 	} tests[] = {
 		(const CcToken[]){
 			{.type = CC_TOKEN_INT},
@@ -973,44 +2869,55 @@ static void ccTestProgram(bool* const pPassed)
 			1,
 			4,
 			5, 2
-		}, 4
+		}, 4, (const char* const[]){"some_func", "main"}
 	};
 	constexpr size_t testCount = CC_LEN(tests);
 
-	tests[0].solution[2].function.name = tests[0].tokens[1].string;
-	tests[0].solution[5].function.name = tests[0].tokens[10].string;
-
-	CcNode nodes[64];
-	size_t children[64];
+	CcTestTree storage;
+	char text[64];
 
 	for(size_t testIndex = 0; testIndex < testCount; ++testIndex)
 	{
-		CcTree tree = {.nodes = nodes, .children = children};
-		CcConstTokenList tokens = {tests[testIndex].tokens, tests[testIndex].count};
+		CcTree tree = ccMakeTestTree(&storage);
+		CcTokenList tokenList;
+		if(!ccMakeTokenList(tests[testIndex].tokens, tests[testIndex].count, text, sizeof(text), &tokenList))
+		{
+			CC_FAIL("Parse program #%zu: failed to make the token list.", testIndex);
+			continue;
+		}
+		CcConstTokenList tokens = {&tokenList, 0, tokenList.count};
 
-		CcTreeBuilder builder = {.pTree = &tree, .tokens = &tokens, .lastIndex = CC_LEN(children)};
+		CcTreeBuilder builder = {.pTree = &tree, .tokens = &tokens, .lastIndex = tree.childCapacity};
 		const bool result = ccParseProgram(&builder);
 
 		if(result != tests[testIndex].result)
 		{
 			CC_FAIL("Parse program #%zu: wrong result.", testIndex);
+			ccFreeTokenList(&tokenList);
+			ccFreeSymbolTable(&tree.symbols);
 			continue;
 		}
 
 		if(!result)
 		{
+			ccFreeTokenList(&tokenList);
+			ccFreeSymbolTable(&tree.symbols);
 			continue;
 		}
 
 		if(tree.count != tests[testIndex].solutionCount)
 		{
 			CC_FAIL("Parse program #%zu: wrong count.", testIndex);
+			ccFreeTokenList(&tokenList);
+			ccFreeSymbolTable(&tree.symbols);
 			continue;
 		}
 
 		if(builder.childCount != tests[testIndex].childrenSolutionCount)
 		{
 			CC_FAIL("Parse program #%zu: wrong child count.", testIndex);
+			ccFreeTokenList(&tokenList);
+			ccFreeSymbolTable(&tree.symbols);
 			continue;
 		}
 
@@ -1022,30 +2929,356 @@ static void ccTestProgram(bool* const pPassed)
 			}
 		}
 
+		size_t functionIndex = 0;
 		for(size_t nodeIndex = 0; nodeIndex < tree.count; ++nodeIndex)
 		{
-			if(tree.nodes[nodeIndex].type != tests[testIndex].solution[nodeIndex].type)
+			const CcNode node = ccGetNode(&tree, nodeIndex);
+			if(node.type != tests[testIndex].solution[nodeIndex].type)
 			{
 				CC_FAIL("Parse program #%zu: node #%zu: wrong type.", testIndex, nodeIndex);
 				continue;
 			}
 
-			if(tree.nodes[nodeIndex].type == CC_NODE_PROGRAM)
+			if(node.type == CC_NODE_FUNCTION && !ccIsFunctionNamed(&tree, node, tests[testIndex].functionNames[functionIndex++]))
+			{
+				CC_FAIL("Parse program #%zu: node #%zu: wrong function name.", testIndex, nodeIndex);
+			}
+
+			if(node.type == CC_NODE_PROGRAM)
 			{
-				if(tree.nodes[nodeIndex].program.childrenCount != tests[testIndex].solution[nodeIndex].program.childrenCount)
+				if(node.program.childrenCount != tests[testIndex].solution[nodeIndex].program.childrenCount)
 				{
 					CC_FAIL("Parse program #%zu: node #%zu: wrong program child count.", testIndex, nodeIndex);
 					continue;
 				}
 
-				if(tree.nodes[nodeIndex].program.childrenStart != tests[testIndex].solution[nodeIndex].program.childrenStart)
+				if(node.program.childrenStart != tests[testIndex].solution[nodeIndex].program.childrenStart)
 				{
 					CC_FAIL("Parse program #%zu: node #%zu: wrong program children start.", testIndex, nodeIndex);
 					continue;
 				}
 			}
 		}
+
+		ccFreeTokenList(&tokenList);
+		ccFreeSymbolTable(&tree.symbols);
+	}
+}
+
+/*
+ * Compare two trees node by node, with the children of their nodes.
+ *
+ * Parameters:
+ * - pFirst: A pointer to the first tree.
+ * - pSecond: A pointer to the second tree.
+ *
+ * Returns:
+ * - true if the trees are the same.
+ * - false otherwise.
+ */
+static bool ccCompareTrees(const CcTree* const pFirst, const CcTree* const pSecond)
+{
+	if(pFirst->count != pSecond->count)
+	{
+		return false;
+	}
+
+	for(size_t nodeIndex = 0; nodeIndex < pFirst->count; ++nodeIndex)
+	{
+		const CcNode node = ccGetNode(pFirst, nodeIndex);
+		const CcNode other = ccGetNode(pSecond, nodeIndex);
+		const CcNode* const pNode = &node;
+		const CcNode* const pOther = &other;
+		if(pNode->type != pOther->type)
+		{
+			return false;
+		}
+
+		// Children are stored from the last one, at decreasing indices.
+		switch(pNode->type)
+		{
+			case CC_NODE_PROGRAM:
+				if(pNode->program.childrenCount != pOther->program.childrenCount)
+				{
+					return false;
+				}
+				for(size_t childIndex = 0; childIndex < pNode->program.childrenCount; ++childIndex)
+				{
+					if(pFirst->children[pNode->program.childrenStart - childIndex] != pSecond->children[pOther->program.childrenStart - childIndex])
+					{
+						return false;
+					}
+				}
+				break;
+
+			case CC_NODE_FUNCTION:
+				if(
+					pNode->function.symbol != pOther->function.symbol ||
+					pNode->function.statementsCount != pOther->function.statementsCount ||
+					pNode->function.symbol >= pFirst->symbols.count || pOther->function.symbol >= pSecond->symbols.count
+				)
+				{
+					return false;
+				}
+				// Names are read from the trees, which own them.
+				const CcSymbol* const pName = &pFirst->symbols.symbols[pNode->function.symbol];
+				const CcSymbol* const pOtherName = &pSecond->symbols.symbols[pOther->function.symbol];
+				if(pName->length != pOtherName->length || memcmp(pName->name, pOtherName->name, pName->length) != 0)
+				{
+					return false;
+				}
+				for(size_t childIndex = 0; childIndex < pNode->function.statementsCount; ++childIndex)
+				{
+					if(pFirst->children[pNode->function.statementsStart - childIndex] != pSecond->children[pOther->function.statementsStart - childIndex])
+					{
+						return false;
+					}
+				}
+				break;
+
+			case CC_NODE_RETURN:
+				if(pNode->returnNode != pOther->returnNode)
+				{
+					return false;
+				}
+				break;
+
+			case CC_NODE_BIN_OP:
+				if(pNode->binOpNode.op != pOther->binOpNode.op || pNode->binOpNode.leftNode != pOther->binOpNode.leftNode || pNode->binOpNode.rightNode != pOther->binOpNode.rightNode)
+				{
+					return false;
+				}
+				break;
+
+			case CC_NODE_CONSTANT:
+				if(!ccCompareConstants(pNode->constant, pOther->constant))
+				{
+					return false;
+				}
+				break;
+		}
+	}
+
+	return true;
+}
+
+static void ccTestParseLexer(bool* const pPassed)
+{
+	assert(pPassed != nullptr);
+
+	// Generated functions show the window holds one function at a time, they fill several windows of a stream.
+	constexpr size_t functionCount = 4000;
+	static const char function[] = "int f%zu(void){return (%zu + 2) * 3 - 4 %% 5 << 1; return;}\n";
+	constexpr size_t functionTokenCount = 24;
+	constexpr size_t largeSize = functionCount * 64;
+	char* const large = malloc(largeSize);
+	if(!large)
+	{
+		CC_FAIL("Failed to allocate memory.");
+		return;
+	}
+	size_t largeLength = 0;
+	for(size_t functionIndex = 0; functionIndex < functionCount; ++functionIndex)
+	{
+		largeLength += snprintf(large + largeLength, largeSize - largeLength, function, functionIndex, functionIndex);
+	}
+
+	const struct
+	{
+		const char* source;
+		bool result;
+	} tests[] = {
+		{"int one(void){return 1;}\nint main(void){ return 2 * (3 + 4) - 5 % 2 == 1; return; }\nint empty(){}\n", true},
+		{"int a(){return 1;} int b(){return 2;} int a(){return 3;}", true},
+		{"@ int f(){return 1;}", true},
+		{large, true},
+		{"int main(void){return 1;} int", false},
+		{"int f(){return 1;}}", false},
+		{"int f(){return 1;", false},
+		{"int f(){return 1 +;}", false}
+	};
+	constexpr size_t testCount = CC_LEN(tests);
+
+	// Diagnostics are not checked.
+	FILE* const file = tmpfile();
+	ccSetDiagnosticFile(file);
+
+	for(size_t testIndex = 0; testIndex < testCount; ++testIndex)
+	{
+		const CcConstString string = {tests[testIndex].source, strlen(tests[testIndex].source)};
+
+		CcTokenList tokenList;
+		CcTree expected = {};
+		CcResult expectedResult = ccLex(string, CC_C23, &tokenList);
+		CcReport report = {};
+		if(expectedResult == CC_SUCCESS)
+		{
+			CcReport* const pPreviousReport = ccGetReport();
+			ccSetReport(&report);
+			expectedResult = ccParse(&(const CcConstTokenList){&tokenList, 0, tokenList.count}, &expected);
+			ccSetReport(pPreviousReport);
+		}
+		ccFreeTokenList(&tokenList);
+
+		CcLexer lexer;
+		CcTree tree = {};
+		CcReport lexerReport = {};
+		CcResult result = ccCreateLexer(string, CC_C23, &lexer);
+		if(result == CC_SUCCESS)
+		{
+			CcReport* const pPreviousReport = ccGetReport();
+			ccSetReport(&lexerReport);
+			result = ccParseLexer(&lexer, &tree);
+			ccSetReport(pPreviousReport);
+		}
+
+		if((result == CC_SUCCESS) != tests[testIndex].result || (expectedResult == CC_SUCCESS) != tests[testIndex].result)
+		{
+			CC_FAIL("Test parse lexer #%zu wrong result.", testIndex);
+		}
+		else if(result == CC_SUCCESS && !ccCompareTrees(&tree, &expected))
+		{
+			CC_FAIL("Test parse lexer #%zu wrong tree.", testIndex);
+		}
+
+		// Trees grow while parsing and are then shrunk to their content, the growth being reported.
+		if(
+			result == CC_SUCCESS && (
+				tree.nodeCapacity != tree.count || expected.nodeCapacity != expected.count ||
+				tree.childCapacity != ccGetNode(&tree, tree.count - 1).program.childrenStart + 1 ||
+				expected.childCapacity != ccGetNode(&expected, expected.count - 1).program.childrenStart + 1 ||
+				report.buffers[CC_BUFFER_NODES].used != expected.count || report.buffers[CC_BUFFER_NODES].reserved < expected.count
+			)
+		)
+		{
+			CC_FAIL("Test parse lexer #%zu wrong capacity.", testIndex);
+		}
+
+		// Each function is pulled in the lex phase and parsed in the parse phase, the last pull finding none and the program being added last.
+		const CcPhaseReport* const pLexPhase = &lexerReport.phases[CC_PHASE_LEX];
+		if(result == CC_SUCCESS && (pLexPhase->count < 2 || pLexPhase->count != lexerReport.phases[CC_PHASE_PARSE].count || pLexPhase->requestedBytes == 0))
+		{
+			CC_FAIL("Test parse lexer #%zu wrong phases.", testIndex);
+		}
+
+		if(result == CC_SUCCESS && lexer.peakCount > functionTokenCount)
+		{
+			CC_FAIL("Test parse lexer #%zu held %zu tokens at once.", testIndex, lexer.peakCount);
+		}
+
+		// A stream lexer parses the same tree, reading the source through a window which does not grow to hold all of it.
+		CcConstString remaining = string;
+		CcLexer streamLexer;
+		CcTree streamTree = {};
+		CcResult streamResult = ccCreateStreamLexer(ccReadString, &remaining, CC_C23, &streamLexer);
+		if(streamResult == CC_SUCCESS)
+		{
+			streamResult = ccParseLexer(&streamLexer, &streamTree);
+		}
+
+		if(streamResult != result || (result == CC_SUCCESS && !ccCompareTrees(&streamTree, &expected)))
+		{
+			CC_FAIL("Test parse stream #%zu wrong tree.", testIndex);
+		}
+		else if(streamLexer.window.size > largeLength / 2)
+		{
+			CC_FAIL("Test parse stream #%zu held %zu bytes at once.", testIndex, streamLexer.window.size);
+		}
+
+		ccFreeLexer(&streamLexer);
+		ccFreeTree(&streamTree);
+		ccFreeLexer(&lexer);
+		ccFreeTree(&tree);
+		ccFreeTree(&expected);
+	}
+
+	// An empty string is an empty program.
+	CcLexer lexer;
+	CcTree tree = {};
+	if(ccCreateLexer((CcConstString){"", 0}, CC_C23, &lexer) != CC_SUCCESS || ccParseLexer(&lexer, &tree) != CC_SUCCESS)
+	{
+		CC_FAIL("Test parse lexer failed on an empty string.");
+	}
+	else if(tree.count != 1 || tree.types[0] != CC_NODE_PROGRAM || ccGetNode(&tree, 0).program.childrenCount != 0)
+	{
+		CC_FAIL("Test parse lexer wrong empty program.");
+	}
+	ccFreeLexer(&lexer);
+	ccFreeTree(&tree);
+
+	// Trees own the names of their functions, which outlive the lexer.
+	if(ccCreateLexer((CcConstString){"int main(void){return 0;}", 25}, CC_C23, &lexer) != CC_SUCCESS || ccParseLexer(&lexer, &tree) != CC_SUCCESS)
+	{
+		CC_FAIL("Test parse lexer failed on a function.");
+	}
+	else
+	{
+		ccFreeLexer(&lexer);
+		if(tree.count < 2 || !ccIsFunctionNamed(&tree, ccGetNode(&tree, tree.count - 2), "main"))
+		{
+			CC_FAIL("Test parse lexer wrong function name.");
+		}
+	}
+	ccFreeLexer(&lexer);
+	ccFreeTree(&tree);
+
+	// A lexer and a tree emptied after each parse keep their storage, so that parsing the same sources again allocates nothing unless diagnostics are written.
+	CcLexer warmLexer = {};
+	CcTree warmTree = {};
+	CcArena diagnosticArena = {};
+	ccSetDiagnosticArena(&diagnosticArena);
+	for(size_t passIndex = 0; passIndex < 2; ++passIndex)
+	{
+		for(size_t testIndex = 0; testIndex < testCount; ++testIndex)
+		{
+			const CcConstString string = {tests[testIndex].source, strlen(tests[testIndex].source)};
+
+			const size_t diagnosticCount = ccGetDiagnosticCount();
+			const CcMemoryStatistics before = *ccGetMemoryStatistics();
+			CcResult result = ccResetLexer(string, CC_C23, &warmLexer);
+			if(result == CC_SUCCESS)
+			{
+				result = ccParseLexer(&warmLexer, &warmTree);
+			}
+			const CcMemoryStatistics* const pAfter = ccGetMemoryStatistics();
+			const bool allocated = pAfter->allocationCount != before.allocationCount || pAfter->reallocationCount != before.reallocationCount;
+
+			CcTree expected = {};
+			if(ccCreateLexer(string, CC_C23, &lexer) == CC_SUCCESS && result == CC_SUCCESS)
+			{
+				ccParseLexer(&lexer, &expected);
+			}
+			ccFreeLexer(&lexer);
+
+			if((result == CC_SUCCESS) != tests[testIndex].result)
+			{
+				CC_FAIL("Test warm parse lexer #%zu wrong result.", testIndex);
+			}
+			else if(result == CC_SUCCESS && !ccCompareTrees(&warmTree, &expected))
+			{
+				CC_FAIL("Test warm parse lexer #%zu wrong tree.", testIndex);
+			}
+			else if(passIndex > 0 && ccGetDiagnosticCount() == diagnosticCount && allocated)
+			{
+				CC_FAIL("Test warm parse lexer #%zu allocated memory.", testIndex);
+			}
+
+			ccFreeTree(&expected);
+			ccClearLexer(&warmLexer);
+			ccClearTree(&warmTree);
+		}
 	}
+	ccSetDiagnosticArena(nullptr);
+	ccFreeLexer(&warmLexer);
+	ccFreeTree(&warmTree);
+	ccFreeArena(&diagnosticArena);
+
+	ccSetDiagnosticFile(nullptr);
+	if(file)
+	{
+		fclose(file);
+	}
+	free(large);
 }
 
 int main(void)
@@ -1053,22 +3286,42 @@ int main(void)
 	bool passed = true;
 
 	ccTestFind(&passed);
+	ccTestMemoryReport(&passed);
 
 	ccTestArguments(&passed);
 
+	ccTestLoadFile(&passed);
+	ccTestCache(&passed);
+#ifndef _WIN32
+	ccTestServer(&passed);
+#endif
+
+	ccTestScan(&passed);
+	ccTestCharacterClasses(&passed);
 	ccTestStrings(&passed);
 	ccTestCharacters(&passed);
 	ccTestTokens(&passed);
 	ccTestConstants(&passed);
 	ccTestIdentifiers(&passed);
+	ccTestKeywords(&passed);
 
+	ccTestSymbols(&passed);
 	ccTestLex(&passed);
+	ccTestLexStream(&passed);
+	ccTestLexEquivalence(&passed);
+	ccTestLexParallel(&passed);
+	ccTestDiagnosticLocations(&passed);
+	ccTestDiagnosticSink(&passed);
 
 	ccTestParentheses(&passed);
+	ccTestBrackets(&passed);
 	ccTestExpressions(&passed);
+	ccTestExpressionScaling(&passed);
+	ccTestExpressionNesting(&passed);
 	ccTestStatements(&passed);
 	ccTestFunctions(&passed);
 	ccTestProgram(&passed);
+	ccTestParseLexer(&passed);
 
 	return passed ? EXIT_SUCCESS : EXIT_FAILURE;
 }